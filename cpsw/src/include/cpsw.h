@@ -287,6 +287,11 @@ extern void CPSWWrCoreIntDisable(unsigned int baseAddr, unsigned int core,
                           unsigned int channel, unsigned int intFlag);
 extern unsigned int CPSWWrCoreIntStatusGet(unsigned int baseAddr, unsigned int core,
                                     unsigned int channel, unsigned int intFlag);
+extern void CPSWWrIntPacingEnable(unsigned int baseAddr, unsigned int core,
+                           unsigned int intPerMilliSec, unsigned int pacFlag);
+extern void CPSWWrIntPacingDisable(unsigned int baseAddr, unsigned int core,
+                            unsigned int pacFlag);
+extern void CPSWWrPrescaleSet(unsigned int baseAddr, unsigned int psVal);
 extern unsigned int CPSWWrRGMIIStatusGet(unsigned int baseAddr, unsigned int statFlag);
 extern void CPSWALEInit(unsigned int baseAddr);
 extern void CPSWALEPortStateSet(unsigned int baseAddr, unsigned int portNum,
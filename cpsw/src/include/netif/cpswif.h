@@ -112,4 +112,11 @@ extern err_t cpswif_init(struct netif *netif);
 extern void cpswif_rx_inthandler(u32_t inst_num);
 extern void cpswif_tx_inthandler(u32_t inst_num);
 
+#if LWIP_IRQ_MODERATION
+#include <irq_moderation.h>
+
+/* Policy and counters of the adaptive receive interrupt pacing */
+extern struct irq_moderation *cpswif_rx_moderation(u32_t inst_num);
+#endif
+
 #endif /* _CPSWIF_H__ */
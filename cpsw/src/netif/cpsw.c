@@ -338,6 +338,72 @@ unsigned int CPSWWrCoreIntStatusGet(unsigned int baseAddr, unsigned int core,
             &  (1 << channel));
 }
 
+/**
+ * \brief   Enables interrupt pacing for the specified core and limits the
+ *          number of paced interrupts.
+ *
+ * \param   baseAddr       Base address of the CPSW Wrapper Module
+ * \param   core           Core number
+ * \param   intPerMilliSec Maximum number of interrupts per millisecond
+ * \param   pacFlag        Interrupt to be paced
+ *    'pacFlag' can take one of the below values. \n
+ *          CPSW_INT_PACING_Cn_RX_PULSE - RX pulse interrupt of core n \n
+ *          CPSW_INT_PACING_Cn_TX_PULSE - TX pulse interrupt of core n
+ *
+ * \return  None
+ **/
+void CPSWWrIntPacingEnable(unsigned int baseAddr, unsigned int core,
+                           unsigned int intPerMilliSec, unsigned int pacFlag)
+{
+    if(pacFlag & (CPSW_INT_PACING_C0_RX_PULSE | CPSW_INT_PACING_C1_RX_PULSE
+                  | CPSW_INT_PACING_C2_RX_PULSE))
+    {
+        HWREG(baseAddr + CPSW_WR_C_RX_IMAX(core)) =
+                          intPerMilliSec & CPSW_WR_C0_RX_IMAX_C0_RX_IMAX;
+    }
+    else
+    {
+        HWREG(baseAddr + CPSW_WR_C_TX_IMAX(core)) =
+                          intPerMilliSec & CPSW_WR_C0_TX_IMAX_C0_TX_IMAX;
+    }
+
+    HWREG(baseAddr + CPSW_WR_INT_CONTROL) |= pacFlag;
+}
+
+/**
+ * \brief   Disables interrupt pacing for the specified core.
+ *
+ * \param   baseAddr    Base address of the CPSW Wrapper Module
+ * \param   core        Core number
+ * \param   pacFlag     Interrupt not to be paced any more
+ *    'pacFlag' can take the same values as for CPSWWrIntPacingEnable.
+ *
+ * \return  None
+ **/
+void CPSWWrIntPacingDisable(unsigned int baseAddr, unsigned int core,
+                            unsigned int pacFlag)
+{
+    (void)core;
+    HWREG(baseAddr + CPSW_WR_INT_CONTROL) &= ~pacFlag;
+}
+
+/**
+ * \brief   Sets the prescaler of the interrupt pacing, the number of main
+ *          clock cycles in 4 microseconds.
+ *
+ * \param   baseAddr    Base address of the CPSW Wrapper Module
+ * \param   psVal       The prescale value
+ *
+ * \return  None
+ **/
+void CPSWWrPrescaleSet(unsigned int baseAddr, unsigned int psVal)
+{
+    HWREG(baseAddr + CPSW_WR_INT_CONTROL) =
+        (HWREG(baseAddr + CPSW_WR_INT_CONTROL)
+         & ~CPSW_WR_INT_CONTROL_INT_PRESCALE)
+        | (psVal & CPSW_WR_INT_CONTROL_INT_PRESCALE);
+}
+
 /**
  * \brief   Returns the RGMII status requested.
  *
@@ -68,6 +68,22 @@
 
 #include "lwiplib.h"
 
+#include <netif_burst.h>
+#if LWIP_RX_POOL
+#include <rxpool.h>
+#endif
+
+#if LWIP_IRQ_MODERATION
+/* Clock of the CPSW wrapper, which times the interrupt pacing */
+#ifndef CPSW_BUS_FREQ_MHZ
+#define CPSW_BUS_FREQ_MHZ                        125
+#endif
+
+/* Limits of the paced interrupts per millisecond */
+#define CPSW_INT_PACING_IMAX_MIN                 2
+#define CPSW_INT_PACING_IMAX_MAX                 63
+#endif
+
 /* CPPI RAM size in bytes */
 #ifndef SIZE_CPPI_RAM
 #define SIZE_CPPI_RAM                            0x2000
@@ -287,6 +303,13 @@ struct cpswinst{
   sys_thread_t TxThread; /**< RX receive thread data object pointer */
   sem_t txsem;
   sys_mutex_t txmtx;
+#if LWIP_RX_POOL
+  /* Receive buffers recycled from the stack */
+  struct rxpool rx_pool;
+#endif
+#if LWIP_IRQ_MODERATION
+  struct irq_moderation rx_moderation;
+#endif
 }cpswinst;
 
 /* Defining set of CPSW base addresses for all the instances */
@@ -1532,10 +1555,42 @@ cpswif_autoneg_config(u32_t inst_num, u32_t port_num) {
   return linkstat;
 }
 
+#if LWIP_RX_POOL
+/**
+ * Called when the stack frees a buffer into the empty receive pool. The ring
+ * may have been left short of buffers, so let the rx thread refill it.
+ */
+static void
+cpswif_rx_recycle(void *arg) {
+  struct cpswinst *cpswinst = arg;
+
+  sem_post(&cpswinst->rxsem);
+}
+#endif
+
+/**
+ * Takes a receive buffer from the pool of the instance while it has any and
+ * from PBUF_POOL after that.
+ *
+ * @param   cpswinst   The CPSW instance structure pointer
+ * @return  The pbuf or NULL if none is available
+ */
+static struct pbuf *
+cpswif_rx_pbuf_alloc(struct cpswinst *cpswinst) {
+#if LWIP_RX_POOL
+  struct pbuf *p = rxpool_take(&cpswinst->rx_pool);
+
+  if(p != NULL) {
+    return p;
+  }
+#endif
+  return pbuf_alloc(PBUF_RAW, PBUF_LEN_MAX, PBUF_POOL);
+}
+
 /**
  * This function allocates the rx buffer descriptors ring. The function
- * internally calls pbuf_alloc() and allocates the pbufs to the rx buffer
- * descriptors.
+ * internally calls cpswif_rx_pbuf_alloc() and allocates the pbufs to the rx
+ * buffer descriptors.
  *
  * @param   cpswinst   The CPSW instance structure pointer
  * @return  None
@@ -1561,7 +1616,7 @@ cpswif_rxbd_alloc(struct cpswinst *cpswinst) {
      * Try to get a pbuf of max. length. This shall be cache line aligned if
      * cache is enabled.
      */
-    p = pbuf_alloc(PBUF_RAW, PBUF_LEN_MAX, PBUF_POOL);
+    p = cpswif_rx_pbuf_alloc(cpswinst);
 
     /**
      * Allocate bd's if p is not NULL. This allocation doesnt support
@@ -1569,11 +1624,25 @@ cpswif_rxbd_alloc(struct cpswinst *cpswinst) {
      */
     if(p != NULL) {
 #ifdef LWIP_CACHE_ENABLED
+#if PBUF_POOL_CACHE_LINE_SIZE
       /**
-       * Clean the pbuf structure info. This is needed to prevent losing
-       * pbuf structure info when we invalidate the pbuf on rx interrupt
+       * The payload owns its cache lines. Drop them so that no dirty line
+       * gets evicted over the frame while the DMA writes it.
        */
-      CacheDataCleanBuff((u32_t)(p), (u32_t)(SIZEOF_STRUCT_PBUF));
+      CacheDataInvalidateBuff((u32_t)(p->payload),
+                              (u32_t)PBUF_CACHE_ALIGN_SIZE(p->len));
+#else
+      if(p->flags & PBUF_FLAG_IS_CUSTOM) {
+        /* The payload of a receive pool buffer owns its cache lines */
+        CacheDataInvalidateBuff((u32_t)(p->payload), (u32_t)(p->len));
+      } else {
+        /**
+         * Clean the pbuf structure info. This is needed to prevent losing
+         * pbuf structure info when we invalidate the pbuf on rx interrupt
+         */
+        CacheDataCleanBuff((u32_t)(p), (u32_t)(SIZEOF_STRUCT_PBUF));
+      }
+#endif
 #endif
       curr_bd->bufptr = (u32_t)(p->payload);
       curr_bd->bufoff_len = p->len;
@@ -1944,6 +2013,14 @@ cpswif_cpdma_init(struct cpswinst *cpswinst) {
   num_bd = (SIZE_CPPI_RAM >> 1) / sizeof(cpdma_rx_bd);
   rxch->free_num = num_bd;
 
+#if LWIP_RX_POOL
+  /* Without the pool the rx buffers are taken from PBUF_POOL */
+  if(rxpool_init(&cpswinst->rx_pool, num_bd + LWIP_RX_POOL_EXTRA,
+                 PBUF_LEN_MAX, cpswif_rx_recycle, cpswinst) != ERR_OK) {
+    LWIP_DEBUGF(NETIF_DEBUG, ("cpswif: no receive buffer pool\n"));
+  }
+#endif
+
   curr_rxbd = rxch->free_head;
 
   /* Create the rx ring of buffer descriptors */
@@ -1968,6 +2045,38 @@ cpswif_cpdma_init(struct cpswinst *cpswinst) {
   CPSWCPDMARxHdrDescPtrWrite(cpswinst->cpdma_base, (u32_t)(rxch->recv_head), 0);
 }
 
+#if LWIP_IRQ_MODERATION
+/**
+ * Programs the receive interrupt pacing of core 0 from the delay chosen by
+ * the moderation policy. The wrapper limits interrupts per millisecond, so
+ * the delay is converted and clamped to what the C0_RX_IMAX register takes.
+ *
+ * @param cpswinst  The CPSW instance structure pointer
+ * @return None
+ */
+static void
+cpswif_rx_moderation_apply(struct cpswinst *cpswinst) {
+  u32_t usecs = cpswinst->rx_moderation.stats.usecs;
+  u32_t imax;
+
+  if(usecs == 0) {
+    CPSWWrIntPacingDisable(cpswinst->wrpr_base, 0,
+                           CPSW_INT_PACING_C0_RX_PULSE);
+    return;
+  }
+
+  imax = 1000 / usecs;
+  if(imax < CPSW_INT_PACING_IMAX_MIN) {
+    imax = CPSW_INT_PACING_IMAX_MIN;
+  } else if(imax > CPSW_INT_PACING_IMAX_MAX) {
+    imax = CPSW_INT_PACING_IMAX_MAX;
+  }
+
+  CPSWWrIntPacingEnable(cpswinst->wrpr_base, 0, imax,
+                        CPSW_INT_PACING_C0_RX_PULSE);
+}
+#endif
+
 /**
  * In this function, the hardware should be initialized.
  * Called from cpswif_init().
@@ -2040,7 +2149,21 @@ cpswif_inst_init(struct cpswportif *cpswif){
 
   CPSWCPDMARxIntEnable(cpswinst->cpdma_base, 0);
   CPSWWrCoreIntEnable(cpswinst->wrpr_base, 0, 0, CPSW_CORE_INT_RX_PULSE);
+
+#if LWIP_IRQ_MODERATION
+  /* Receive interrupts are paced once the packet rate calls for it */
+  irq_moderation_init(&cpswinst->rx_moderation);
+  CPSWWrPrescaleSet(cpswinst->wrpr_base, CPSW_BUS_FREQ_MHZ * 4);
+  cpswif_rx_moderation_apply(cpswinst);
+#endif
+}
+
+#if LWIP_IRQ_MODERATION
+struct irq_moderation *
+cpswif_rx_moderation(u32_t inst_num) {
+  return &cpsw_inst_data[inst_num].rx_moderation;
 }
+#endif
 
 /**
  * Should be called at the beginning of the program to set up the
@@ -2119,6 +2242,9 @@ cpswif_rx_inthandler(const u32_t inst_num) {
   const u32_t cpdma_base = cpswinst->cpdma_base;
   unsigned int curr_bd;
 
+#if LWIP_IRQ_MODERATION
+  irq_moderation_interrupt(&cpswinst->rx_moderation);
+#endif
   sem_post(rxsem);
 
   /* Get the bd which contains the earliest filled data */
@@ -2135,6 +2261,11 @@ process_input(const u32_t inst_num, struct netif *const netif_arr) {
   volatile struct cpdma_rx_bd *curr_bd;
   volatile struct pbuf *pbuf;
   u32_t tot_len, if_num;
+  struct netif_burst burst;
+  struct netif *burst_netif = NULL;
+#if LWIP_IRQ_MODERATION
+  u32_t packets = 0;
+#endif
 
 #ifdef CPSW_DUAL_MAC_MODE
   u32_t from_port;
@@ -2146,6 +2277,8 @@ process_input(const u32_t inst_num, struct netif *const netif_arr) {
   /* Get the bd which contains the earliest filled data */
   curr_bd = rxch->recv_head;
 
+  netif_burst_init(&burst);
+
   /**
    * Process the receive buffer descriptors. When the DMA completes
    * reception, OWNERSHIP flag will be cleared.
@@ -2169,11 +2302,24 @@ process_input(const u32_t inst_num, struct netif *const netif_arr) {
     /* Get the pbuf which is associated with the current bd */
     pbuf = curr_bd->pbuf;
 #ifdef LWIP_CACHE_ENABLED
+#if PBUF_POOL_CACHE_LINE_SIZE
     /**
-     * Invalidate the cache lines of the pbuf including payload. Because
-     * the memory contents got changed by DMA.
+     * Invalidate the lines of the received frame only, the struct pbuf is
+     * in lines of its own.
      */
-    CacheDataInvalidateBuff((u32_t)pbuf, (PBUF_LEN_MAX + SIZEOF_STRUCT_PBUF));
+    CacheDataInvalidateBuff((u32_t)pbuf->payload, tot_len);
+#else
+    if(pbuf->flags & PBUF_FLAG_IS_CUSTOM) {
+      /* The struct pbuf of a receive pool buffer is apart from the payload */
+      CacheDataInvalidateBuff((u32_t)pbuf->payload, tot_len);
+    } else {
+      /**
+       * Invalidate the cache lines of the pbuf including payload. Because
+       * the memory contents got changed by DMA.
+       */
+      CacheDataInvalidateBuff((u32_t)pbuf, (PBUF_LEN_MAX + SIZEOF_STRUCT_PBUF));
+    }
+#endif
 #endif
 
     /* Update the len and tot_len fields for the pbuf in the chain */
@@ -2184,6 +2330,9 @@ process_input(const u32_t inst_num, struct netif *const netif_arr) {
 
     /* Adjust the link statistics */
     LINK_STATS_INC(link.recv);
+#if LWIP_IRQ_MODERATION
+    packets++;
+#endif
 
 #ifdef CPSW_DUAL_MAC_MODE
     if_num = (inst_num * MAX_SLAVEPORT_PER_INST) + from_port - 1;
@@ -2191,11 +2340,18 @@ process_input(const u32_t inst_num, struct netif *const netif_arr) {
     if_num = inst_num;
 #endif
     struct netif * netif = netif_arr + if_num;
-    /* Process the packet */
-    if(netif->input((struct pbuf *)pbuf, netif) != ERR_OK) {
-      /* Adjust the link statistics */
-      LINK_STATS_INC(link.memerr);
-      LINK_STATS_INC(link.drop);
+    /**
+     * Collect the packets of one interface and pass them on together,
+     * the burst counts the packets the stack does not take as dropped.
+     */
+    if(netif != burst_netif) {
+      if(burst_netif != NULL) {
+        netif_burst_flush(&burst, burst_netif);
+      }
+      burst_netif = netif;
+    }
+    if(netif_burst_add(&burst, (struct pbuf *)pbuf) >= LWIP_NETIF_BURST) {
+      netif_burst_flush(&burst, netif);
     }
 
     curr_bd = curr_bd->next;
@@ -2214,8 +2370,18 @@ process_input(const u32_t inst_num, struct netif *const netif_arr) {
     rxch->recv_head = curr_bd;
   }
 
+  if(burst_netif != NULL) {
+    netif_burst_flush(&burst, burst_netif);
+  }
+
   /* We got some bd's freed; Allocate them */
   cpswif_rxbd_alloc(cpswinst);
+
+#if LWIP_IRQ_MODERATION
+  if(irq_moderation_update(&cpswinst->rx_moderation, packets)) {
+    cpswif_rx_moderation_apply(cpswinst);
+  }
+#endif
 }
 
 static void
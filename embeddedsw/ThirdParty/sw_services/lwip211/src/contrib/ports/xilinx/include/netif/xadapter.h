@@ -76,6 +76,16 @@ struct netif *	xemac_add(struct netif *netif,
 #if defined (__arm__) || defined (__aarch64__)
 void xemacpsif_resetrx_on_no_rxdata(struct netif *netif);
 #endif
+#if defined(__rtems__) && !NO_SYS
+/*
+ * Adds and brings up the interface of the MAC at mac_baseaddr and starts its
+ * input thread. It may be called once for each GEM to run them side by side.
+ */
+struct netif *	xemac_add_port(struct netif *netif,
+	ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw,
+	unsigned char *mac_ethernet_address,
+	UINTPTR mac_baseaddr);
+#endif
 
 /* global lwip debug variable used for debugging */
 extern int lwip_runtime_debug;
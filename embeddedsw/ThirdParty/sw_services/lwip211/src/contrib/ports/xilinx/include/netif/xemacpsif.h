@@ -100,6 +100,96 @@ extern "C" {
 
 #define MAX_FRAME_SIZE_JUMBO (XEMACPS_MTU_JUMBO + XEMACPS_HDR_SIZE + XEMACPS_TRL_SIZE)
 
+#ifdef __rtems__
+#ifdef ZYNQMP_USE_JUMBO
+/*
+ * Jumbo frames are received into chains of PBUF_POOL buffers of this size,
+ * one per descriptor, so small frames do not tie up jumbo sized buffers.
+ */
+#define XEMACPSIF_RX_BUF_SIZE \
+	((PBUF_POOL_BUFSIZE / XEMACPS_RX_BUF_UNIT) * XEMACPS_RX_BUF_UNIT)
+#define XEMACPSIF_RX_PBUF_SIZE XEMACPSIF_RX_BUF_SIZE
+/*
+ * Descriptors the largest frame spans. The driver only takes complete frames
+ * off a ring, so it never asks for fewer descriptors than this at once.
+ */
+#define XEMACPSIF_RX_FRAME_BDS \
+	((MAX_FRAME_SIZE_JUMBO + XEMACPSIF_RX_BUF_SIZE - 1) / XEMACPSIF_RX_BUF_SIZE)
+#else
+#define XEMACPSIF_RX_PBUF_SIZE XEMACPS_MAX_FRAME_SIZE
+#define XEMACPSIF_RX_FRAME_BDS 1
+#endif
+
+#if ZYNQMP_RX_PRIORITY_QUEUE
+#define XEMACPSIF_N_RX_DESC (XLWIP_CONFIG_N_RX_DESC + ZYNQMP_RXQ1_N_DESC)
+#else
+#define XEMACPSIF_N_RX_DESC XLWIP_CONFIG_N_RX_DESC
+#endif
+
+#if LWIP_RX_POOL
+#include <rxpool.h>
+#endif
+
+#if LWIP_IRQ_MODERATION
+#include <irq_moderation.h>
+
+/* Policy and counters of the adaptive receive interrupt moderation */
+struct irq_moderation *xemacpsif_rx_moderation(struct netif *netif);
+#endif
+
+#if ZYNQMP_DMA_MEMORY == ZYNQMP_DMA_MEMORY_NONCACHED
+#if !LWIP_RX_POOL
+#error "ZYNQMP_DMA_MEMORY_NONCACHED requires LWIP_RX_POOL"
+#endif
+/* Maps the region for the DMA path, once, before the first allocation */
+void xemacpsif_dma_init(void);
+/* Carves memory from the region mapped for the DMA path */
+void *xemacpsif_dma_alloc(size_t size);
+#endif
+
+/* Counters of one GEM, next to the LINK_STATS shared by all interfaces */
+struct xemacpsif_stats {
+	u32_t rx_frames;
+	u32_t rx_drops;
+	u32_t tx_frames;
+	u32_t tx_drops;
+};
+
+/* Prints the counters of the GEM behind netif */
+void xemacpsif_stats_display(struct netif *netif);
+
+/*
+ * Threads take frames off the receive rings, so a DMA error is recovered
+ * from by the input thread rather than in the interrupt.
+ */
+#define XEMACPSIF_RX_THREADED (ZYNQMP_RX_POLL_BUDGET || ZYNQMP_RX_PRIORITY_QUEUE)
+
+#if ZYNQMP_RX_PRIORITY_QUEUE
+#include <netif_burst.h>
+
+/*
+ * Steer received frames to queue 1 by UDP or TCP destination port over IPv4
+ * or by Ethernet type. Each rule takes a screener of the GEM and ERR_MEM is
+ * returned once it has none left.
+ */
+err_t xemacpsif_screen_udp_port(struct netif *netif, u16_t port);
+err_t xemacpsif_screen_tcp_port(struct netif *netif, u16_t port);
+err_t xemacpsif_screen_ethertype(struct netif *netif, u16_t ethertype);
+#endif
+
+#if LWIP_HWTSTAMP
+#include <netif_hwtstamp.h>
+
+/*
+ * The time stamp unit of GEMs with extended descriptors is the hardware
+ * clock of their interface, stamping every frame sent and received.
+ */
+#define XEMACPSIF_HAS_TSU(xemacpsif) ((xemacpsif)->emacps.Version > 2)
+
+extern const struct netif_phc xemacpsif_phc;
+#endif
+#endif
+
 void 	xemacpsif_setmac(u32_t index, u8_t *addr);
 u8_t*	xemacpsif_getmac(u32_t index);
 err_t 	xemacpsif_init(struct netif *netif);
@@ -124,6 +214,62 @@ typedef struct {
 
 	unsigned int last_rx_frms_cntr;
 
+#if defined(__rtems__) && LWIP_RX_POOL
+	/* receive buffers recycled from the stack */
+	struct rxpool rx_pool;
+#endif
+
+#if defined(__rtems__) && LWIP_IRQ_MODERATION
+	struct irq_moderation rx_moderation;
+#endif
+
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+	/* a DMA error left for the input thread to recover from */
+	volatile u8_t dma_error;
+	/* held over a batch a thread takes off a ring and over any reset */
+	sys_mutex_t rx_lock;
+#endif
+
+#ifdef __rtems__
+	/* frames waiting for transmit descriptors, oldest at tx_queue_head */
+#if ZYNQMP_TX_QUEUE_LEN
+	struct pbuf *tx_queue[ZYNQMP_TX_QUEUE_LEN];
+#endif
+	u16_t tx_queue_head;
+	u16_t tx_queue_len;
+	u16_t tx_queue_hwm;
+	u8_t tx_stalled;
+	u32_t tx_refused;
+	struct tcpip_callback_msg *tx_resume_msg;
+
+	/* state of this GEM and its PHY, one of up to four */
+	struct netif *netif;
+	u32_t intr_num;
+	u32_t phy_addr;
+	u32_t link_speed;
+	enum ethernet_link_status link_status;
+	u8_t mcast_entry_mask;
+	u8_t mld6_mcast_entry_mask;
+	/* terminators of the priority queues, allocated with the rings */
+	void *rx_terminate_bdspace;
+	void *tx_terminate_bdspace;
+	struct xemacpsif_stats stats;
+#endif
+
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+	/* receive queue 1, fed by the screeners */
+	XEmacPs_BdRing rxq1_ring;
+	void *rxq1_bdspace;
+	UINTPTR rxq1_pbufs[ZYNQMP_RXQ1_N_DESC];
+	sys_sem_t rxq1_sem;
+
+	/* screener resources in use */
+	u8_t screen_t1_used;
+	u8_t screen_t2_used;
+	u8_t screen_etype_used;
+	u8_t screen_cmp_used;
+#endif
+
 } xemacpsif_s;
 
 extern xemacpsif_s xemacpsif;
@@ -143,6 +289,26 @@ XStatus emacps_sgsend(xemacpsif_s *xemacpsif, struct pbuf *p,
 XStatus emacps_sgsend(xemacpsif_s *xemacpsif, struct pbuf *p);
 #endif
 void emacps_recv_handler(void *arg);
+#if defined(__rtems__) && ZYNQMP_RX_POLL_BUDGET
+s32_t emacps_rx_poll(struct xemac_s *xemac, s32_t budget);
+#endif
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+void emacps_dma_error(struct xemac_s *xemac);
+void emacps_dma_recover(struct xemac_s *xemac);
+#endif
+#ifdef __rtems__
+void emac_disable_intr(xemacpsif_s *xemacpsif);
+void emac_enable_intr(xemacpsif_s *xemacpsif);
+void emacps_tx_queue_init(xemacpsif_s *xemacpsif);
+err_t emacps_tx_output(xemacpsif_s *xemacpsif, struct pbuf *p);
+u8_t emacps_tx_queue_drain(xemacpsif_s *xemacpsif);
+void emacps_tx_resume(xemacpsif_s *xemacpsif);
+#endif
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+void emacps_recv_q1_handler(void *arg);
+s32_t emacps_rxq1_poll(struct xemac_s *xemac, struct netif_burst *burst,
+		s32_t budget);
+#endif
 void emacps_error_handler(void *arg,u8 Direction, u32 ErrorWord);
 void setup_rx_bds(xemacpsif_s *xemacpsif, XEmacPs_BdRing *rxring);
 void HandleTxErrors(struct xemac_s *xemac);
@@ -158,6 +324,11 @@ void init_emacps_on_error (xemacpsif_s *xemacps, struct netif *netif);
 void clean_dma_txdescs(struct xemac_s *xemac);
 void resetrx_on_no_rxdata(xemacpsif_s *xemacpsif);
 void reset_dma(struct xemac_s *xemac);
+#if defined(__rtems__) && LWIP_HWTSTAMP
+void xemacps_tsu_init(xemacpsif_s *xemacpsif);
+void xemacps_tsu_stamp(xemacpsif_s *xemacpsif, u32_t ts0, u32_t ts1,
+		u32_t *sec, u32_t *nsec);
+#endif
 
 #ifdef __cplusplus
 }
@@ -37,10 +37,40 @@ extern "C" {
 
 #define PQ_QUEUE_SIZE 4096
 
+#ifdef __rtems__
+#include <stdatomic.h>
+
+#define PQ_CACHE_LINE_SIZE 64
+
+/*
+ * Ring without locks for a single producer and a single consumer. Each side
+ * only writes its own index, which keeps counting up and is masked into the
+ * ring, so the size must be a power of two. The sides sit on separate cache
+ * lines to keep them from contending on SMP.
+ */
+typedef struct {
+	/* producer side */
+	atomic_uint head;
+	unsigned int mask;
+	unsigned int hwm;	/* most entries ever queued */
+	unsigned int full;	/* entries refused because the ring was full */
+
+	/* consumer side */
+	atomic_uint tail __attribute__ ((aligned (PQ_CACHE_LINE_SIZE)));
+
+	void *data[] __attribute__ ((aligned (PQ_CACHE_LINE_SIZE)));
+} pq_queue_t;
+
+pq_queue_t*	pq_create_queue_size(unsigned int size);
+void		pq_delete_queue(pq_queue_t *q);
+unsigned int	pq_enqueue_bulk(pq_queue_t *q, void **p, unsigned int n);
+unsigned int	pq_dequeue_bulk(pq_queue_t *q, void **p, unsigned int n);
+#else
 typedef struct {
 	void *data[PQ_QUEUE_SIZE];
 	int head, tail, len;
 } pq_queue_t;
+#endif
 
 pq_queue_t*	pq_create_queue();
 int 		pq_enqueue(pq_queue_t *q, void *p);
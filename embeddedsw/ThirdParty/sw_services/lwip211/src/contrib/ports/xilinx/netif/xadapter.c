@@ -190,6 +190,28 @@ xemac_add(struct netif *netif,
 	}
 }
 
+#if defined(__rtems__) && !NO_SYS
+struct netif *
+xemac_add_port(struct netif *netif,
+	ip_addr_t *ipaddr, ip_addr_t *netmask, ip_addr_t *gw,
+	unsigned char *mac_ethernet_address,
+	UINTPTR mac_baseaddr)
+{
+	if (xemac_add(netif, ipaddr, netmask, gw, mac_ethernet_address,
+			mac_baseaddr) == NULL) {
+		return NULL;
+	}
+
+	netif_set_up(netif);
+
+	sys_thread_new("xemacif_input_thread",
+			(void (*)(void *))xemacif_input_thread, netif,
+			1024, ZYNQMP_RX_THREAD_PRIO);
+
+	return netif;
+}
+#endif
+
 #if !NO_SYS
 /*
  * The input thread calls lwIP to process any received packets.
@@ -353,6 +375,50 @@ static u32_t phy_autoneg_status(XEmacLite *xemacp, u32_t phy_addr)
 }
 #endif
 
+#if defined(__rtems__) && defined(XLWIP_CONFIG_INCLUDE_GEM)
+/* Each GEM follows the link of its own PHY */
+void eth_link_detect(struct netif *netif)
+{
+	u32_t link_speed, phy_link_status;
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	xemacpsif_s *xemacs = (xemacpsif_s *)(xemac->state);
+	XEmacPs *xemacp = &xemacs->emacps;
+
+	if ((xemacp->IsReady != (u32)XIL_COMPONENT_IS_READY) ||
+			(xemacs->link_status == ETH_LINK_UNDEFINED))
+		return;
+
+	phy_link_status = phy_link_detect(xemacp, xemacs->phy_addr);
+
+	if ((xemacs->link_status == ETH_LINK_UP) && (!phy_link_status))
+		xemacs->link_status = ETH_LINK_DOWN;
+
+	switch (xemacs->link_status) {
+		case ETH_LINK_UNDEFINED:
+		case ETH_LINK_UP:
+			return;
+		case ETH_LINK_DOWN:
+			netif_set_link_down(netif);
+			xemacs->link_status = ETH_LINK_NEGOTIATING;
+			xil_printf("Ethernet Link down\r\n");
+			break;
+		case ETH_LINK_NEGOTIATING:
+			if (phy_link_status &&
+				phy_autoneg_status(xemacp, xemacs->phy_addr)) {
+
+				/* Initiate Phy setup to get link speed */
+				link_speed = phy_setup_emacps(xemacp,
+								xemacs->phy_addr);
+				XEmacPs_SetOperatingSpeed(xemacp, link_speed);
+				xemacs->link_speed = link_speed;
+				netif_set_link_up(netif);
+				xemacs->link_status = ETH_LINK_UP;
+				xil_printf("Ethernet Link up\r\n");
+			}
+			break;
+	}
+}
+#else
 void eth_link_detect(struct netif *netif)
 {
 	u32_t link_speed, phy_link_status;
@@ -408,6 +474,7 @@ void eth_link_detect(struct netif *netif)
 			break;
 	}
 }
+#endif
 
 #if !NO_SYS
 void link_detect_thread(void *p)
@@ -53,6 +53,10 @@
 #if LWIP_IPV6
 #include "lwip/ethip6.h"
 #endif
+#ifdef __rtems__
+#include <rtems.h>
+#include <netif_burst.h>
+#endif
 
 
 /* Define those to better describe your network interface. */
@@ -63,15 +67,26 @@
 static err_t xemacpsif_mac_filter_update (struct netif *netif,
 							ip_addr_t *group, u8_t action);
 
+#ifdef __rtems__
+/* Each GEM counts the entries of its own hash filter */
+#define xemacps_mcast_entry_mask \
+	(((xemacpsif_s *)((struct xemac_s *)netif->state)->state)->mcast_entry_mask)
+#else
 static u8_t xemacps_mcast_entry_mask = 0;
 #endif
+#endif
 
 #if LWIP_IPV6 && LWIP_IPV6_MLD
 static err_t xemacpsif_mld6_mac_filter_update (struct netif *netif,
 							ip_addr_t *group, u8_t action);
 
+#ifdef __rtems__
+#define xemacps_mld6_mcast_entry_mask \
+	(((xemacpsif_s *)((struct xemac_s *)netif->state)->state)->mld6_mcast_entry_mask)
+#else
 static u8_t xemacps_mld6_mcast_entry_mask;
 #endif
+#endif
 
 XEmacPs_Config *mac_config;
 struct netif *NetIf;
@@ -146,8 +161,10 @@ static err_t _unbuffered_low_level_output(xemacpsif_s *xemacpsif,
 static err_t low_level_output(struct netif *netif, struct pbuf *p)
 {
     err_t err = ERR_MEM;
+#if !defined(__rtems__) || LWIP_UDP_OPT_BLOCK_TX_TILL_COMPLETE
     s32_t freecnt;
     XEmacPs_BdRing *txring;
+#endif
 #if LWIP_UDP_OPT_BLOCK_TX_TILL_COMPLETE
 	u32_t notfifyblocksleepcntr;
 	u32_t to_block_index;
@@ -157,6 +174,18 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
 	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
 
+#if defined(__rtems__) && !LWIP_UDP_OPT_BLOCK_TX_TILL_COMPLETE
+	/* a full ring queues the frame or pushes back on the sender */
+#if ETH_PAD_SIZE
+	pbuf_header(p, -ETH_PAD_SIZE);	/* drop the padding word */
+#endif
+	SYS_ARCH_PROTECT(lev);
+	err = emacps_tx_output(xemacpsif, p);
+	SYS_ARCH_UNPROTECT(lev);
+#if ETH_PAD_SIZE
+	pbuf_header(p, ETH_PAD_SIZE);	/* reclaim the padding word */
+#endif
+#else
 	SYS_ARCH_PROTECT(lev);
 	/* check if space is available to send */
     freecnt = is_tx_space_available(xemacpsif);
@@ -179,7 +208,9 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 #if LINK_STATS
 		lwip_stats.link.drop++;
 #endif
+#ifndef __rtems__
 		printf("pack dropped, no space\r\n");
+#endif
 		SYS_ARCH_UNPROTECT(lev);
 		goto return_pack_dropped;
 	}
@@ -201,6 +232,7 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 	netif_clear_opt_block_tx(netif, NETIF_ENABLE_BLOCKING_TX_FOR_PACKET);
 #endif
 return_pack_dropped:
+#endif
 	return err;
 }
 
@@ -211,6 +243,7 @@ return_pack_dropped:
  * packet from the interface into the pbuf.
  *
  */
+#ifndef __rtems__
 static struct pbuf * low_level_input(struct netif *netif)
 {
 	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
@@ -225,6 +258,7 @@ static struct pbuf * low_level_input(struct netif *netif)
 	p = (struct pbuf *)pq_dequeue(xemacpsif->recv_q);
 	return p;
 }
+#endif
 
 /*
  * xemacpsif_output():
@@ -255,23 +289,54 @@ static err_t xemacpsif_output(struct netif *netif, struct pbuf *p,
  *
  */
 
+#if defined(__rtems__) && ZYNQMP_RX_POLL_BUDGET
+static s32_t xemacpsif_deliver(struct netif *netif)
+#else
 s32_t xemacpsif_input(struct netif *netif)
+#endif
 {
 	struct eth_hdr *ethhdr;
 	struct pbuf *p;
+#ifdef __rtems__
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+	struct netif_burst burst;
+	void *frames[LWIP_NETIF_BURST];
+	unsigned int n_frames = 0;
+	unsigned int next = 0;
+
+#if XEMACPSIF_RX_THREADED && !ZYNQMP_RX_POLL_BUDGET
+	emacps_dma_recover(xemac);
+#endif
+	netif_burst_init(&burst);
+#else
 	SYS_ARCH_DECL_PROTECT(lev);
+#endif
 
 #if !NO_SYS
 	while (1)
 #endif
 	{
+#ifdef __rtems__
+		/* this thread is the only consumer of recv_q, which needs no lock */
+		if (next == n_frames) {
+			n_frames = pq_dequeue_bulk(xemacpsif->recv_q, frames,
+				LWIP_NETIF_BURST);
+			next = 0;
+		}
+		p = next < n_frames ? (struct pbuf *)frames[next++] : NULL;
+#else
 		/* move received packet into a new pbuf */
 		SYS_ARCH_PROTECT(lev);
 		p = low_level_input(netif);
 		SYS_ARCH_UNPROTECT(lev);
+#endif
 
 		/* no packet could be read, silently ignore this */
 		if (p == NULL) {
+#ifdef __rtems__
+			netif_burst_flush(&burst, netif);
+#endif
 			return 0;
 		}
 
@@ -296,11 +361,18 @@ s32_t xemacpsif_input(struct netif *netif)
 			case ETHTYPE_PPPOE:
 	#endif /* PPPOE_SUPPORT */
 				/* full packet send to tcpip_thread to process */
+#ifdef __rtems__
+				/* collect a burst to pass on in one go */
+				if (netif_burst_add(&burst, p) >= LWIP_NETIF_BURST) {
+					netif_burst_flush(&burst, netif);
+				}
+#else
 				if (netif->input(p, netif) != ERR_OK) {
 					LWIP_DEBUGF(NETIF_DEBUG, ("xemacpsif_input: IP input error\r\n"));
 					pbuf_free(p);
 					p = NULL;
 				}
+#endif
 				break;
 
 			default:
@@ -310,9 +382,92 @@ s32_t xemacpsif_input(struct netif *netif)
 		}
 	}
 
+#ifdef __rtems__
+	netif_burst_flush(&burst, netif);
+#endif
 	return 1;
 }
 
+#if defined(__rtems__) && ZYNQMP_RX_POLL_BUDGET
+/*
+ * The receive interrupt only masks itself and wakes the input thread, which
+ * takes up to ZYNQMP_RX_POLL_BUDGET descriptors off the ring per call and
+ * hands their frames to the stack. While the ring is not drained the thread is
+ * woken again and yields first, so a busy link does not keep other threads of
+ * its priority off the processor. The interrupt is unmasked again once a poll
+ * finds the ring empty.
+ */
+s32_t xemacpsif_input(struct netif *netif)
+{
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	s32_t more;
+
+	emacps_dma_recover(xemac);
+	more = emacps_rx_poll(xemac, ZYNQMP_RX_POLL_BUDGET);
+	xemacpsif_deliver(netif);
+	if (more) {
+		sys_sem_signal(&xemac->sem_rx_data_available);
+		rtems_task_wake_after(RTEMS_YIELD_PROCESSOR);
+	}
+
+	return 0;
+}
+#endif
+
+#ifdef __rtems__
+void xemacpsif_stats_display(struct netif *netif)
+{
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+
+	LWIP_PLATFORM_DIAG(("\n%c%c%u (GEM at 0x%08lx)\n", netif->name[0],
+		netif->name[1], (unsigned)netif->num,
+		(unsigned long)xemacpsif->emacps.Config.BaseAddress));
+	LWIP_PLATFORM_DIAG(("\trx_frames: %"U32_F"\n", xemacpsif->stats.rx_frames));
+	LWIP_PLATFORM_DIAG(("\trx_drops: %"U32_F"\n", xemacpsif->stats.rx_drops));
+	LWIP_PLATFORM_DIAG(("\trecv_q hwm: %u\n", xemacpsif->recv_q->hwm));
+	LWIP_PLATFORM_DIAG(("\ttx_frames: %"U32_F"\n", xemacpsif->stats.tx_frames));
+	LWIP_PLATFORM_DIAG(("\ttx_drops: %"U32_F"\n", xemacpsif->stats.tx_drops));
+	LWIP_PLATFORM_DIAG(("\ttx_queue hwm: %"U16_F"\n", xemacpsif->tx_queue_hwm));
+	LWIP_PLATFORM_DIAG(("\ttx_refused: %"U32_F"\n", xemacpsif->tx_refused));
+}
+#endif
+
+#if defined(__rtems__) && LWIP_IRQ_MODERATION
+struct irq_moderation *xemacpsif_rx_moderation(struct netif *netif)
+{
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+
+	return &xemacpsif->rx_moderation;
+}
+#endif
+
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+/*
+ * Serves receive queue 1 at ZYNQMP_RXQ1_THREAD_PRIO, so the flows steered
+ * there by xemacpsif_screen_*() do not wait behind the backlog of queue 0.
+ * Both queues still share tcpip_thread.
+ */
+static void xemacpsif_rxq1_thread(void *arg)
+{
+	struct netif *netif = (struct netif *)arg;
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+	struct netif_burst burst;
+	s32_t more;
+
+	while (1) {
+		sys_arch_sem_wait(&xemacpsif->rxq1_sem, 0);
+		netif_burst_init(&burst);
+		do {
+			more = emacps_rxq1_poll(xemac, &burst, LWIP_NETIF_BURST);
+			netif_burst_flush(&burst, netif);
+		} while (more);
+	}
+}
+#endif
+
 #if !NO_SYS
 #if defined(__arm__) && !defined(ARMR5)
 void vTimerCallback( TimerHandle_t pxTimer )
@@ -361,6 +516,48 @@ static err_t low_level_init(struct netif *netif)
 	xemacpsif->recv_q = pq_create_queue();
 	if (!xemacpsif->recv_q)
 		return ERR_MEM;
+#ifdef __rtems__
+	emacps_tx_queue_init(xemacpsif);
+	/* init_dma() allocates the rings once and reuses them after errors */
+	xemacpsif->rx_bdspace = NULL;
+	xemacpsif->tx_bdspace = NULL;
+	xemacpsif->rx_terminate_bdspace = NULL;
+	xemacpsif->tx_terminate_bdspace = NULL;
+	xemacpsif->netif = netif;
+	xemacpsif->phy_addr = 0;
+	xemacpsif->link_speed = 0;
+	xemacpsif->link_status = ETH_LINK_UNDEFINED;
+	xemacpsif->mcast_entry_mask = 0;
+	xemacpsif->mld6_mcast_entry_mask = 0;
+	memset(&xemacpsif->stats, 0, sizeof(xemacpsif->stats));
+#endif
+#if defined(__rtems__) && LWIP_RX_POOL
+	/* Without the pool the receive path falls back to PBUF_POOL */
+#if ZYNQMP_DMA_MEMORY == ZYNQMP_DMA_MEMORY_NONCACHED
+	{
+		u16_t count = XEMACPSIF_N_RX_DESC + LWIP_RX_POOL_EXTRA;
+		void *mem;
+
+		xemacpsif_dma_init();
+		mem = xemacpsif_dma_alloc(
+			rxpool_mem_size(count, XEMACPSIF_RX_PBUF_SIZE));
+
+		if (mem != NULL) {
+			rxpool_init_mem(&xemacpsif->rx_pool, mem, count,
+				XEMACPSIF_RX_PBUF_SIZE, NULL, NULL);
+		} else {
+			memset(&xemacpsif->rx_pool, 0, sizeof(xemacpsif->rx_pool));
+			LWIP_DEBUGF(NETIF_DEBUG, ("xemacpsif_init: DMA memory exhausted\r\n"));
+		}
+	}
+#else
+	if (rxpool_init(&xemacpsif->rx_pool,
+			XEMACPSIF_N_RX_DESC + LWIP_RX_POOL_EXTRA,
+			XEMACPSIF_RX_PBUF_SIZE, NULL, NULL) != ERR_OK) {
+		LWIP_DEBUGF(NETIF_DEBUG, ("xemacpsif_init: no receive buffer pool\r\n"));
+	}
+#endif
+#endif
 
 	/* maximum transfer unit */
 #ifdef ZYNQMP_USE_JUMBO
@@ -388,8 +585,44 @@ static err_t low_level_init(struct netif *netif)
 	netif->flags |= NETIF_FLAG_IGMP;
 #endif
 
+#if defined(__rtems__) && ZYNQMP_CHECKSUM_OFFLOAD
+	/*
+	 * The GEM drops frames with bad IP, TCP or UDP checksums and marks the
+	 * ones it did not verify for the stack. It cannot insert checksums into
+	 * frames that do not fit its transmit packet buffer, so jumbo frames
+	 * keep computing them in software.
+	 */
+#ifdef ZYNQMP_USE_JUMBO
+	NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_ENABLE_ALL &
+		~(NETIF_CHECKSUM_CHECK_IP | NETIF_CHECKSUM_CHECK_UDP |
+		NETIF_CHECKSUM_CHECK_TCP));
+#else
+	NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_ENABLE_ALL &
+		~(NETIF_CHECKSUM_CHECK_IP | NETIF_CHECKSUM_CHECK_UDP |
+		NETIF_CHECKSUM_CHECK_TCP | NETIF_CHECKSUM_GEN_IP |
+		NETIF_CHECKSUM_GEN_UDP | NETIF_CHECKSUM_GEN_TCP));
+#endif
+#endif
+
 #if !NO_SYS
 	sys_sem_new(&xemac->sem_rx_data_available, 0);
+#endif
+#if defined(__rtems__) && LWIP_IRQ_MODERATION
+	irq_moderation_init(&xemacpsif->rx_moderation);
+#endif
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+	xemacpsif->dma_error = 0;
+	sys_mutex_new(&xemacpsif->rx_lock);
+#endif
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+	/* init_dma() sets up queue 1 where the GEM has one */
+	xemacpsif->rxq1_bdspace = NULL;
+	memset(xemacpsif->rxq1_pbufs, 0, sizeof(xemacpsif->rxq1_pbufs));
+	xemacpsif->screen_t1_used = 0;
+	xemacpsif->screen_t2_used = 0;
+	xemacpsif->screen_etype_used = 0;
+	xemacpsif->screen_cmp_used = 0;
+	sys_sem_new(&xemacpsif->rxq1_sem, 0);
 #endif
 	/* obtain config of this emac */
 	mac_config = (XEmacPs_Config *)xemacps_lookup_config((unsigned)(UINTPTR)netif->state);
@@ -418,6 +651,13 @@ static err_t low_level_init(struct netif *netif)
 	dmacrreg = dmacrreg | (0x00000010);
 	XEmacPs_WriteReg(xemacpsif->emacps.Config.BaseAddress,
 											XEMACPS_DMACR_OFFSET, dmacrreg);
+#if defined(__rtems__) && LWIP_HWTSTAMP
+	/* init_dma() switches to the extended descriptors carrying timestamps */
+	if (XEMACPSIF_HAS_TSU(xemacpsif)) {
+		xemacps_tsu_init(xemacpsif);
+		netif->phc = &xemacpsif_phc;
+	}
+#endif
 #if !NO_SYS
 #if defined(__arm__) && !defined(ARMR5)
 	/* Freertos tick is 10ms by default; set period to the same */
@@ -440,6 +680,13 @@ static err_t low_level_init(struct netif *netif)
 	 */
 	netif->state = (void *)xemac;
 
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+	if (xemacpsif->rxq1_bdspace != NULL) {
+		sys_thread_new("xemacpsif_rxq1_thread", xemacpsif_rxq1_thread,
+			netif, 1024, ZYNQMP_RXQ1_THREAD_PRIO);
+	}
+#endif
+
 	return ERR_OK;
 }
 
@@ -454,13 +701,28 @@ void HandleEmacPsError(struct xemac_s *xemac)
 
 	xemacpsif = (xemacpsif_s *)(xemac->state);
 	free_txrx_pbufs(xemacpsif);
+#ifdef __rtems__
+	/* mac_config and NetIf belong to the interface set up last */
+	{
+		XEmacPs_Config *config = xemacps_lookup_config(
+			xemacpsif->emacps.Config.BaseAddress);
+
+		status = XEmacPs_CfgInitialize(&xemacpsif->emacps, config,
+							config->BaseAddress);
+	}
+#else
 	status = XEmacPs_CfgInitialize(&xemacpsif->emacps, mac_config,
 						mac_config->BaseAddress);
+#endif
 	if (status != XST_SUCCESS) {
 		xil_printf("In %s:EmacPs Configuration Failed....\r\n", __func__);
 	}
 	/* initialize the mac */
+#ifdef __rtems__
+	init_emacps_on_error(xemacpsif, xemacpsif->netif);
+#else
 	init_emacps_on_error(xemacpsif, NetIf);
+#endif
 	dmacrreg = XEmacPs_ReadReg(xemacpsif->emacps.Config.BaseAddress,
 														XEMACPS_DMACR_OFFSET);
 	dmacrreg = dmacrreg | (0x01000000);
@@ -534,6 +796,10 @@ static void xemacpsif_mld6_mac_hash_update (struct netif *netif, u8_t *ip_addr,
 
 	SYS_ARCH_DECL_PROTECT(lev);
 
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+	/* reset_dma() must not pull a ring from under a batch */
+	sys_mutex_lock(&xemacpsif->rx_lock);
+#endif
 	SYS_ARCH_PROTECT(lev);
 
 	/* Stop Ethernet */
@@ -555,6 +821,9 @@ static void xemacpsif_mld6_mac_hash_update (struct netif *netif, u8_t *ip_addr,
 	XEmacPs_Start(&xemacpsif->emacps);
 
 	SYS_ARCH_UNPROTECT(lev);
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+	sys_mutex_unlock(&xemacpsif->rx_lock);
+#endif
 }
 
 static err_t xemacpsif_mld6_mac_filter_update (struct netif *netif, ip_addr_t *group,
@@ -641,6 +910,10 @@ static void xemacpsif_mac_hash_update (struct netif *netif, u8_t *ip_addr,
 
 	SYS_ARCH_DECL_PROTECT(lev);
 
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+	/* reset_dma() must not pull a ring from under a batch */
+	sys_mutex_lock(&xemacpsif->rx_lock);
+#endif
 	SYS_ARCH_PROTECT(lev);
 
 	/* Stop Ethernet */
@@ -662,6 +935,9 @@ static void xemacpsif_mac_hash_update (struct netif *netif, u8_t *ip_addr,
 	XEmacPs_Start(&xemacpsif->emacps);
 
 	SYS_ARCH_UNPROTECT(lev);
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+	sys_mutex_unlock(&xemacpsif->rx_lock);
+#endif
 }
 
 static err_t xemacpsif_mac_filter_update (struct netif *netif, ip_addr_t *group,
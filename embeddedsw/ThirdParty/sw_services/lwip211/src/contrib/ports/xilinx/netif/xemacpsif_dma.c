@@ -53,6 +53,258 @@
 #include "semphr.h"
 #include "timers.h"
 #endif
+#ifdef __rtems__
+#include "lwip/prot/ip.h"
+#include "lwip/tcpip.h"
+#include "lwip/priv/tcp_priv.h"
+#include <rtems/rtems/cache.h>
+
+#if ZYNQMP_DMA_MEMORY == ZYNQMP_DMA_MEMORY_NONCACHED
+/*
+ * Like bd_space below, this is mapped normal non-cacheable in 2MB blocks once
+ * at interface initialisation. Receive pool buffers are carved from it and
+ * need no cache maintenance, at the price of uncached accesses from the stack.
+ */
+static u8_t dma_space[ZYNQMP_DMA_MEMORY_SIZE] __attribute__ ((aligned (0x200000)));
+static size_t dma_space_index;
+static volatile u32_t dma_space_attr_set;
+
+static inline int xemacps_is_dma_memory(const void *ptr)
+{
+	return (UINTPTR)ptr - (UINTPTR)dma_space < sizeof(dma_space);
+}
+
+void xemacpsif_dma_init(void)
+{
+	size_t offset;
+
+	/*
+	 * Runs from xemacpsif_init with interrupts enabled, the flush and the
+	 * translation table update are far too long for SYS_ARCH_PROTECT.
+	 */
+	if (dma_space_attr_set == 0) {
+		/* No dirty line may be written back once the region is uncached */
+		rtems_cache_flush_multiple_data_lines(dma_space, sizeof(dma_space));
+		for (offset = 0; offset < sizeof(dma_space); offset += 0x200000) {
+			Xil_SetTlbAttributes((u64)&dma_space[offset],
+				NORM_NONCACHE | INNER_SHAREABLE);
+		}
+		dma_space_attr_set = 1;
+	}
+}
+
+void *xemacpsif_dma_alloc(size_t size)
+{
+	void *mem = NULL;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	LWIP_ASSERT("xemacpsif_dma_init not called", dma_space_attr_set != 0);
+
+	size = LWIP_MEM_ALIGN_SIZE(size);
+	SYS_ARCH_PROTECT(lev);
+	if (size <= sizeof(dma_space) - dma_space_index) {
+		mem = &dma_space[dma_space_index];
+		dma_space_index += size;
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	return mem;
+}
+#else
+#define xemacps_is_dma_memory(ptr) 0
+#endif
+
+/* Receive buffers are single pbufs */
+static inline void xemacps_rx_invalidate(struct pbuf *p, u32_t len)
+{
+	LWIP_ASSERT("RX pbuf is not chained", p->next == NULL);
+	if (xemacps_is_dma_memory(p->payload)) {
+		return;
+	}
+#if PBUF_POOL_CACHE_LINE_SIZE
+	/*
+	 * The payload owns its cache lines. It is invalidated without the clean
+	 * implied by Xil_DCacheInvalidateRange() and without touching the
+	 * struct pbuf.
+	 */
+	rtems_cache_invalidate_multiple_data_lines(p->payload,
+		PBUF_CACHE_ALIGN_SIZE(len));
+#else
+	Xil_DCacheInvalidateRange((UINTPTR)p->payload, len);
+#endif
+}
+
+/*
+ * Receive buffers come from the pool of the interface while it has any and
+ * from PBUF_POOL after that. A ring that neither could refill gets another
+ * chance on the next receive or buffer not available interrupt, both of
+ * which call setup_rx_bds() from the context that owns the ring.
+ */
+static struct pbuf *xemacps_rx_pbuf_alloc(xemacpsif_s *xemacpsif)
+{
+#if LWIP_RX_POOL
+	struct pbuf *p = rxpool_take(&xemacpsif->rx_pool);
+
+	if (p != NULL) {
+		return p;
+	}
+#else
+	LWIP_UNUSED_ARG(xemacpsif);
+#endif
+	return pbuf_alloc(PBUF_RAW, XEMACPSIF_RX_PBUF_SIZE, PBUF_POOL);
+}
+
+#if ZYNQMP_CHECKSUM_OFFLOAD
+/* Receive status bits 23:22 with checksum offload enabled */
+#define XEMACPSIF_RXBUF_CSUM_MASK	0x00C00000U
+#define XEMACPSIF_RXBUF_CSUM_TCP	0x00800000U /* IP and TCP verified */
+#define XEMACPSIF_RXBUF_CSUM_UDP	0x00C00000U /* IP and UDP verified */
+
+/*
+ * The interface advertises checksum checking, so frames whose IP and
+ * TCP or UDP checksums the GEM did not both verify are left to the stack.
+ * These are IP fragments, other protocols and frames spread over several
+ * buffers, for which the status of the last descriptor is not trusted.
+ */
+static inline void xemacps_rx_checksum(struct pbuf *p, XEmacPs_Bd *bd)
+{
+	u32_t csum = XEmacPs_BdRead(bd, XEMACPS_BD_STAT_OFFSET) &
+		XEMACPSIF_RXBUF_CSUM_MASK;
+
+	if (p->next != NULL || (csum != XEMACPSIF_RXBUF_CSUM_TCP &&
+	    csum != XEMACPSIF_RXBUF_CSUM_UDP)) {
+		p->flags |= PBUF_FLAG_CHKSUM_SW;
+	}
+}
+#endif
+
+#if LWIP_HWTSTAMP
+/* The two timestamp words of an extended descriptor follow the others */
+#define XEMACPSIF_BD_TS_OFFSET		(XEMACPS_BD_NUM_WORDS * sizeof(u32))
+#define XEMACPSIF_RXBUF_TS_VALID	0x00000004U /* in the address word */
+#define XEMACPSIF_TXBUF_TS_VALID	0x00800000U /* in the status word */
+
+/* Records the time of reception the GEM wrote into the last descriptor */
+static inline void xemacps_rx_tstamp(xemacpsif_s *xemacpsif, struct pbuf *p,
+	XEmacPs_Bd *bd)
+{
+	p->tstamp_sec = 0;
+	p->tstamp_nsec = 0;
+	if (XEMACPSIF_HAS_TSU(xemacpsif) &&
+	    (XEmacPs_BdRead(bd, XEMACPS_BD_ADDR_OFFSET) &
+	     XEMACPSIF_RXBUF_TS_VALID) != 0) {
+		xemacps_tsu_stamp(xemacpsif,
+			XEmacPs_BdRead(bd, XEMACPSIF_BD_TS_OFFSET),
+			XEmacPs_BdRead(bd, XEMACPSIF_BD_TS_OFFSET + 4),
+			&p->tstamp_sec, &p->tstamp_nsec);
+	}
+}
+#endif
+
+/* Bytes per descriptor, which carry a timestamp on GEMs with a TSU */
+static u32_t xemacps_bd_size(xemacpsif_s *xemacpsif)
+{
+#if LWIP_HWTSTAMP
+	if (XEMACPSIF_HAS_TSU(xemacpsif)) {
+		return sizeof(XEmacPs_Bd) + 2 * sizeof(u32);
+	}
+#else
+	LWIP_UNUSED_ARG(xemacpsif);
+#endif
+	return sizeof(XEmacPs_Bd);
+}
+
+#if LWIP_IRQ_MODERATION
+/* Interrupt moderation register, receive delay in units of 800 ns */
+#define XEMACPSIF_INTR_MOD_OFFSET	0x5CU
+#define XEMACPSIF_INTR_MOD_RX_MASK	0x000000FFU
+
+static void xemacps_rx_moderation_apply(xemacpsif_s *xemacpsif)
+{
+	UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+	u32_t delay = (xemacpsif->rx_moderation.stats.usecs * 10U + 7U) / 8U;
+	u32_t reg = XEmacPs_ReadReg(base, XEMACPSIF_INTR_MOD_OFFSET);
+
+	reg &= ~XEMACPSIF_INTR_MOD_RX_MASK;
+	reg |= LWIP_MIN(delay, XEMACPSIF_INTR_MOD_RX_MASK);
+	XEmacPs_WriteReg(base, XEMACPSIF_INTR_MOD_OFFSET, reg);
+}
+#endif
+
+#ifdef ZYNQMP_USE_JUMBO
+/* Frame being assembled from the descriptors between SOF and EOF */
+struct xemacps_rx_frame {
+	struct pbuf *head;
+	u32_t len;
+	u8_t bad;
+};
+
+/*
+ * Adds the buffer of one descriptor to the frame being assembled and returns
+ * the frame once its last descriptor has been added, NULL otherwise. Only the
+ * last descriptor carries the length of the whole frame. Frames with a
+ * missing buffer are dropped.
+ */
+static struct pbuf *xemacps_rx_assemble(xemacpsif_s *xemacpsif,
+	struct xemacps_rx_frame *frame, XEmacPs_Bd *bd, struct pbuf *p)
+{
+	u32_t status = XEmacPs_BdRead(bd, XEMACPS_BD_STAT_OFFSET);
+	struct pbuf *head;
+	u32_t len;
+
+	if ((status & XEMACPS_RXBUF_SOF_MASK) != 0) {
+		if (frame->head != NULL) {
+			pbuf_free(frame->head);
+		}
+		frame->head = NULL;
+		frame->len = 0;
+		frame->bad = 0;
+	}
+
+	if (p != NULL) {
+		if ((status & XEMACPS_RXBUF_EOF_MASK) != 0) {
+			len = XEmacPs_GetRxFrameSize(&xemacpsif->emacps, bd) - frame->len;
+		} else {
+			len = XEMACPSIF_RX_BUF_SIZE;
+		}
+		if (len == 0 || len > p->len) {
+			pbuf_free(p);
+			frame->bad = 1;
+		} else {
+			pbuf_realloc(p, len);
+			if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+				xemacps_rx_invalidate(p, len);
+			}
+			if (frame->head == NULL) {
+				frame->head = p;
+			} else {
+				pbuf_cat(frame->head, p);
+			}
+			frame->len += len;
+		}
+	} else {
+		frame->bad = 1;
+	}
+
+	if ((status & XEMACPS_RXBUF_EOF_MASK) == 0) {
+		return NULL;
+	}
+
+	head = frame->head;
+	if (frame->bad && head != NULL) {
+		pbuf_free(head);
+		head = NULL;
+#if LINK_STATS
+		lwip_stats.link.drop++;
+#endif
+	}
+	frame->head = NULL;
+	frame->len = 0;
+	frame->bad = 0;
+	return head;
+}
+#endif
+#endif
 
 
 #define INTC_BASE_ADDR		XPAR_SCUGIC_0_CPU_BASEADDR
@@ -65,7 +317,9 @@
 static UINTPTR tx_pbufs_storage[4*XLWIP_CONFIG_N_TX_DESC];
 static UINTPTR rx_pbufs_storage[4*XLWIP_CONFIG_N_RX_DESC];
 
+#ifndef __rtems__
 static s32_t emac_intr_num;
+#endif
 #if LWIP_UDP_OPT_BLOCK_TX_TILL_COMPLETE
 volatile u32_t notifyinfo[4*XLWIP_CONFIG_N_TX_DESC];
 #endif
@@ -237,6 +491,11 @@ void process_sent_bds(xemacpsif_s *xemacpsif, XEmacPs_BdRing *txring)
 #if LWIP_UDP_OPT_BLOCK_TX_TILL_COMPLETE
 	u32_t tx_task_notifier_index;
 #endif
+#if defined(__rtems__) && LWIP_HWTSTAMP
+	/* timestamp of the frame whose descriptors are being freed */
+	u32_t ts_valid = 0, ts0 = 0, ts1 = 0, stat;
+	u32_t ts_sec, ts_nsec;
+#endif
 
 	index = get_base_index_txpbufsstorage (xemacpsif);
 #if LWIP_UDP_OPT_BLOCK_TX_TILL_COMPLETE
@@ -255,6 +514,20 @@ void process_sent_bds(xemacpsif_s *xemacpsif, XEmacPs_BdRing *txring)
 		curbdpntr = txbdset;
 		while (n_pbufs_freed > 0) {
 			bdindex = XEMACPS_BD_TO_INDEX(txring, curbdpntr);
+#if defined(__rtems__) && LWIP_HWTSTAMP
+			/*
+			 * The GEM sets the used bit and the timestamp only in
+			 * the first descriptor of a frame.
+			 */
+			stat = XEmacPs_BdRead(curbdpntr, XEMACPS_BD_STAT_OFFSET);
+			if (XEMACPSIF_HAS_TSU(xemacpsif) &&
+			    (stat & XEMACPS_TXBUF_USED_MASK) != 0) {
+				ts_valid = stat & XEMACPSIF_TXBUF_TS_VALID;
+				ts0 = XEmacPs_BdRead(curbdpntr, XEMACPSIF_BD_TS_OFFSET);
+				ts1 = XEmacPs_BdRead(curbdpntr,
+					XEMACPSIF_BD_TS_OFFSET + 4);
+			}
+#endif
 			temp = (u32 *)curbdpntr;
 			*temp = 0;
 			temp++;
@@ -269,6 +542,14 @@ void process_sent_bds(xemacpsif_s *xemacpsif, XEmacPs_BdRing *txring)
 			SYS_ARCH_PROTECT(lev);
 #endif
 			p = (struct pbuf *)tx_pbufs_storage[index + bdindex];
+#if defined(__rtems__) && LWIP_HWTSTAMP
+			if (p != NULL && p->tstamp_id != 0 && ts_valid != 0) {
+				xemacps_tsu_stamp(xemacpsif, ts0, ts1,
+					&ts_sec, &ts_nsec);
+				netif_hwtstamp_tx_done(p->tstamp_id, ts_sec,
+					ts_nsec);
+			}
+#endif
 			if (p != NULL) {
 				pbuf_free(p);
 			}
@@ -309,10 +590,220 @@ void emacps_send_handler(void *arg)
 
 	/* If Transmit done interrupt is asserted, process completed BD's */
 	process_sent_bds(xemacpsif, txringptr);
+#ifdef __rtems__
+	{
+		SYS_ARCH_DECL_PROTECT(lev);
+		u8_t resume;
+
+		SYS_ARCH_PROTECT(lev);
+		resume = emacps_tx_queue_drain(xemacpsif);
+		SYS_ARCH_UNPROTECT(lev);
+		if (resume) {
+			emacps_tx_resume(xemacpsif);
+		}
+	}
+#endif
 #if !NO_SYS
 	xInsideISR--;
 #endif
 }
+
+#ifdef __rtems__
+static inline s32_t xemacps_tx_bds_needed(struct pbuf *p)
+{
+	s32_t n_pbufs;
+
+	for (n_pbufs = 0; p != NULL; p = p->next)
+		n_pbufs++;
+
+	return n_pbufs;
+}
+
+/*
+ * Hands queued frames to the GEM for as long as the ring has descriptors for
+ * them. Returns 1 when senders were refused and the queue has drained to half,
+ * which the caller passes on with emacps_tx_resume() once it has left the
+ * protected section. Called with SYS_ARCH_PROTECT held.
+ */
+u8_t emacps_tx_queue_drain(xemacpsif_s *xemacpsif)
+{
+#if ZYNQMP_TX_QUEUE_LEN
+	struct pbuf *p;
+
+	while (xemacpsif->tx_queue_len > 0) {
+		p = xemacpsif->tx_queue[xemacpsif->tx_queue_head];
+		if (is_tx_space_available(xemacpsif) < xemacps_tx_bds_needed(p))
+			break;
+
+		xemacpsif->tx_queue[xemacpsif->tx_queue_head] = NULL;
+		xemacpsif->tx_queue_head =
+			(xemacpsif->tx_queue_head + 1) % ZYNQMP_TX_QUEUE_LEN;
+		xemacpsif->tx_queue_len--;
+
+		if (emacps_sgsend(xemacpsif, p) == XST_SUCCESS) {
+			LINK_STATS_INC(link.xmit);
+			xemacpsif->stats.tx_frames++;
+		} else {
+			LINK_STATS_INC(link.drop);
+			xemacpsif->stats.tx_drops++;
+		}
+		/* drop the reference taken when the frame was queued */
+		pbuf_free(p);
+	}
+#endif
+
+	if (xemacpsif->tx_stalled &&
+		xemacpsif->tx_queue_len <= ZYNQMP_TX_QUEUE_LEN / 2) {
+		xemacpsif->tx_stalled = 0;
+		return 1;
+	}
+
+	return 0;
+}
+
+/* Called from tcpip_thread to retry the segments refused while stalled */
+static void xemacps_tx_resume_tcp(void *arg)
+{
+	LWIP_UNUSED_ARG(arg);
+#if LWIP_TCP
+	tcp_txnow();
+#endif
+}
+
+void emacps_tx_queue_init(xemacpsif_s *xemacpsif)
+{
+	xemacpsif->tx_queue_head = 0;
+	xemacpsif->tx_queue_len = 0;
+	xemacpsif->tx_queue_hwm = 0;
+	xemacpsif->tx_stalled = 0;
+	xemacpsif->tx_refused = 0;
+	/* allocated up front so that the completion path never allocates */
+	xemacpsif->tx_resume_msg = tcpip_callbackmsg_new(xemacps_tx_resume_tcp,
+		NULL);
+}
+
+void emacps_tx_resume(xemacpsif_s *xemacpsif)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	if (xemacpsif->tx_resume_msg == NULL) {
+		return;
+	}
+
+	if (tcpip_callbackmsg_trycallback(xemacpsif->tx_resume_msg) != ERR_OK) {
+		/* the next completion tries again */
+		SYS_ARCH_PROTECT(lev);
+		xemacpsif->tx_stalled = 1;
+		SYS_ARCH_UNPROTECT(lev);
+	}
+}
+
+/*
+ * Passes p to the GEM, or queues it behind the frames already waiting while
+ * the ring is short of descriptors. Once the queue is full as well the frame
+ * is refused with ERR_WOULDBLOCK instead of being dropped, so that TCP keeps
+ * the segment unsent and UDP reports the error to the sender. Frames in
+ * memory the sender still owns are copied before they are queued. Called with
+ * SYS_ARCH_PROTECT held.
+ */
+err_t emacps_tx_output(xemacpsif_s *xemacpsif, struct pbuf *p)
+{
+	XEmacPs_BdRing *txring = &(XEmacPs_GetTxRing(&xemacpsif->emacps));
+	s32_t n_bds = xemacps_tx_bds_needed(p);
+
+	if (n_bds > XLWIP_CONFIG_N_TX_DESC) {
+		/* never fits the ring */
+		LINK_STATS_INC(link.drop);
+		xemacpsif->stats.tx_drops++;
+		return ERR_MEM;
+	}
+
+	if (is_tx_space_available(xemacpsif) < n_bds) {
+		process_sent_bds(xemacpsif, txring);
+	}
+
+	if (emacps_tx_queue_drain(xemacpsif)) {
+		/* resumed by the completion of the frames just passed on */
+		xemacpsif->tx_stalled = 1;
+	}
+
+	if (xemacpsif->tx_queue_len == 0 &&
+		is_tx_space_available(xemacpsif) >= n_bds) {
+		if (emacps_sgsend(xemacpsif, p) != XST_SUCCESS) {
+			LINK_STATS_INC(link.drop);
+			xemacpsif->stats.tx_drops++;
+			return ERR_MEM;
+		}
+		LINK_STATS_INC(link.xmit);
+		xemacpsif->stats.tx_frames++;
+		return ERR_OK;
+	}
+
+#if ZYNQMP_TX_QUEUE_LEN
+	if (xemacpsif->tx_queue_len < ZYNQMP_TX_QUEUE_LEN) {
+		if (PBUF_NEEDS_COPY(p)) {
+			/*
+			 * The sender may reuse the memory of a PBUF_REF once
+			 * this returns. The copy comes from PBUF_POOL, which
+			 * is safe to allocate here and to free from the
+			 * transmit interrupt.
+			 */
+			struct pbuf *q = pbuf_clone(PBUF_RAW, PBUF_POOL, p);
+
+			if (q == NULL ||
+				xemacps_tx_bds_needed(q) > XLWIP_CONFIG_N_TX_DESC) {
+				if (q != NULL) {
+					pbuf_free(q);
+				}
+				LINK_STATS_INC(link.memerr);
+				LINK_STATS_INC(link.drop);
+				xemacpsif->stats.tx_drops++;
+				return ERR_MEM;
+			}
+#if LWIP_HWTSTAMP
+			q->tstamp_id = p->tstamp_id;
+#endif
+			p = q;
+		} else {
+			pbuf_ref(p);
+		}
+		xemacpsif->tx_queue[(xemacpsif->tx_queue_head +
+			xemacpsif->tx_queue_len) % ZYNQMP_TX_QUEUE_LEN] = p;
+		xemacpsif->tx_queue_len++;
+		if (xemacpsif->tx_queue_len > xemacpsif->tx_queue_hwm) {
+			xemacpsif->tx_queue_hwm = xemacpsif->tx_queue_len;
+		}
+		return ERR_OK;
+	}
+#endif
+
+	xemacpsif->tx_stalled = 1;
+	xemacpsif->tx_refused++;
+	return ERR_WOULDBLOCK;
+}
+
+/* Releases the queued frames when the GEM is reset */
+static void xemacps_tx_queue_flush(xemacpsif_s *xemacpsif)
+{
+#if ZYNQMP_TX_QUEUE_LEN
+	struct pbuf *p;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	while (xemacpsif->tx_queue_len > 0) {
+		p = xemacpsif->tx_queue[xemacpsif->tx_queue_head];
+		xemacpsif->tx_queue[xemacpsif->tx_queue_head] = NULL;
+		xemacpsif->tx_queue_head =
+			(xemacpsif->tx_queue_head + 1) % ZYNQMP_TX_QUEUE_LEN;
+		xemacpsif->tx_queue_len--;
+		LINK_STATS_INC(link.drop);
+		xemacpsif->stats.tx_drops++;
+		pbuf_free(p);
+	}
+	SYS_ARCH_UNPROTECT(lev);
+#endif
+}
+#endif
 #if LWIP_UDP_OPT_BLOCK_TX_TILL_COMPLETE
 XStatus emacps_sgsend(xemacpsif_s *xemacpsif, struct pbuf *p,
 					u32_t block_till_tx_complete, u32_t *to_block_index)
@@ -368,7 +859,12 @@ XStatus emacps_sgsend(xemacpsif_s *xemacpsif, struct pbuf *p)
 		/* Send the data from the pbuf to the interface, one pbuf at a
 		   time. The size of the data in each pbuf is kept in the ->len
 		   variable. */
+#ifdef __rtems__
+		if (xemacpsif->emacps.Config.IsCacheCoherent == 0 &&
+			!xemacps_is_dma_memory(q->payload)) {
+#else
 		if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+#endif
 			Xil_DCacheFlushRange((UINTPTR)q->payload, (UINTPTR)q->len);
 		}
 
@@ -444,7 +940,9 @@ void setup_rx_bds(xemacpsif_s *xemacpsif, XEmacPs_BdRing *rxring)
 	freebds = XEmacPs_BdRingGetFreeCnt (rxring);
 	while (freebds > 0) {
 		freebds--;
-#ifdef ZYNQMP_USE_JUMBO
+#ifdef __rtems__
+		p = xemacps_rx_pbuf_alloc(xemacpsif);
+#elif defined(ZYNQMP_USE_JUMBO)
 		p = pbuf_alloc(PBUF_RAW, MAX_FRAME_SIZE_JUMBO, PBUF_POOL);
 #else
 		p = pbuf_alloc(PBUF_RAW, XEMACPS_MAX_FRAME_SIZE, PBUF_POOL);
@@ -479,11 +977,19 @@ void setup_rx_bds(xemacpsif_s *xemacpsif, XEmacPs_BdRing *rxring)
 		}
 #ifdef ZYNQMP_USE_JUMBO
 		if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+#ifdef __rtems__
+			xemacps_rx_invalidate(p, p->len);
+#else
 			Xil_DCacheInvalidateRange((UINTPTR)p->payload, (UINTPTR)MAX_FRAME_SIZE_JUMBO);
+#endif
 		}
 #else
 		if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+#ifdef __rtems__
+			xemacps_rx_invalidate(p, p->len);
+#else
 			Xil_DCacheInvalidateRange((UINTPTR)p->payload, (UINTPTR)XEMACPS_MAX_FRAME_SIZE);
+#endif
 		}
 #endif
 		bdindex = XEMACPS_BD_TO_INDEX(rxring, rxbd);
@@ -516,11 +1022,21 @@ void setup_rx_bds(xemacpsif_s *xemacpsif, XEmacPs_BdRing *rxring)
 	}
 }
 
+#ifdef __rtems__
+/*
+ * Moves the frames of up to budget receive descriptors from the ring to
+ * recv_q and refills the ring. Returns the number of descriptors processed.
+ */
+static s32_t emacps_rx_process(struct xemac_s *xemac, s32_t budget)
+#else
 void emacps_recv_handler(void *arg)
+#endif
 {
 	struct pbuf *p;
 	XEmacPs_Bd *rxbdset, *curbdptr;
+#ifndef __rtems__
 	struct xemac_s *xemac;
+#endif
 	xemacpsif_s *xemacpsif;
 	XEmacPs_BdRing *rxring;
 	volatile s32_t bd_processed;
@@ -529,12 +1045,24 @@ void emacps_recv_handler(void *arg)
 	u32_t regval;
 	u32_t index;
 	u32_t gigeversion;
+#ifdef __rtems__
+	s32_t processed = 0;
+	s32_t limit;
+	void *frames[XLWIP_CONFIG_N_RX_DESC];
+	u32_t n_frames;
+	u32_t n_queued;
+#ifdef ZYNQMP_USE_JUMBO
+	struct xemacps_rx_frame rx_frame = { NULL, 0, 0 };
+#endif
+#endif
 
+#ifndef __rtems__
 	xemac = (struct xemac_s *)(arg);
+#endif
 	xemacpsif = (xemacpsif_s *)(xemac->state);
 	rxring = &XEmacPs_GetRxRing(&xemacpsif->emacps);
 
-#if !NO_SYS
+#if !NO_SYS && !defined(__rtems__)
 	xInsideISR++;
 #endif
 
@@ -552,10 +1080,35 @@ void emacps_recv_handler(void *arg)
 
 	while(1) {
 
+#ifdef __rtems__
+		limit = LWIP_MIN(budget - processed, XLWIP_CONFIG_N_RX_DESC);
+		if (limit <= 0) {
+			break;
+		}
+		/*
+		 * A frame spanning more descriptors than the limit would never
+		 * be returned and stall the ring, so the budget may be
+		 * overrun by up to one frame.
+		 */
+		limit = LWIP_MAX(limit, XEMACPSIF_RX_FRAME_BDS);
+#if ZYNQMP_RX_POLL_BUDGET
+		sys_mutex_lock(&xemacpsif->rx_lock);
+#endif
+		bd_processed = XEmacPs_BdRingFromHwRx(rxring, limit, &rxbdset);
+		if (bd_processed <= 0) {
+#if ZYNQMP_RX_POLL_BUDGET
+			sys_mutex_unlock(&xemacpsif->rx_lock);
+#endif
+			break;
+		}
+		processed += bd_processed;
+		n_frames = 0;
+#else
 		bd_processed = XEmacPs_BdRingFromHwRx(rxring, XLWIP_CONFIG_N_RX_DESC, &rxbdset);
 		if (bd_processed <= 0) {
 			break;
 		}
+#endif
 
 		for (k = 0, curbdptr=rxbdset; k < bd_processed; k++) {
 
@@ -571,15 +1124,21 @@ void emacps_recv_handler(void *arg)
 			rx_pbufs_storage[index + bdindex] = 0;
 			SYS_ARCH_UNPROTECT(lev);
 
+#ifdef ZYNQMP_USE_JUMBO
+			p = xemacps_rx_assemble(xemacpsif, &rx_frame, curbdptr, p);
+#endif
+
 			/*
 			 * Nulled descriptors are left flagged so the hardware
 			 * doesn't try to use them. They will still show up here.
 			 */
 			if (p == NULL) {
+				curbdptr = XEmacPs_BdRingNext(rxring, curbdptr);
 				continue;
 			}
 #endif
 
+#if !defined(__rtems__) || !defined(ZYNQMP_USE_JUMBO)
 			/*
 			 * Adjust the buffer size to the actual number of bytes received.
 			 */
@@ -594,9 +1153,25 @@ void emacps_recv_handler(void *arg)
 			 * L1 cache prefetch conditions on any architecture.
 			 */
 			if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+#ifdef __rtems__
+				xemacps_rx_invalidate(p, rx_bytes);
+#else
 				Xil_DCacheInvalidateRange((UINTPTR)p->payload, rx_bytes);
+#endif
 			}
+#endif
+
+#if defined(__rtems__) && ZYNQMP_CHECKSUM_OFFLOAD
+			xemacps_rx_checksum(p, curbdptr);
+#endif
+#if defined(__rtems__) && LWIP_HWTSTAMP
+			xemacps_rx_tstamp(xemacpsif, p, curbdptr);
+#endif
 
+#ifdef __rtems__
+			/* queued with the rest of the batch below */
+			frames[n_frames++] = p;
+#else
 			/* store it in the receive queue,
 			 * where it'll be processed by a different handler
 			 */
@@ -607,12 +1182,477 @@ void emacps_recv_handler(void *arg)
 #endif
 				pbuf_free(p);
 			}
+#endif
 			curbdptr = XEmacPs_BdRingNext( rxring, curbdptr);
 		}
+#ifdef __rtems__
+		/* this is the only producer of recv_q, which needs no lock */
+		n_queued = pq_enqueue_bulk(xemacpsif->recv_q, frames, n_frames);
+		xemacpsif->stats.rx_frames += n_queued;
+		xemacpsif->stats.rx_drops += n_frames - n_queued;
+		while (n_queued < n_frames) {
+			LINK_STATS_INC(link.memerr);
+			LINK_STATS_INC(link.drop);
+			pbuf_free((struct pbuf *)frames[n_queued++]);
+		}
+#endif
 		/* free up the BD's */
 		XEmacPs_BdRingFree(rxring, bd_processed, rxbdset);
 		setup_rx_bds(xemacpsif, rxring);
+#if defined(__rtems__) && ZYNQMP_RX_POLL_BUDGET
+		sys_mutex_unlock(&xemacpsif->rx_lock);
+#endif
+	}
+#ifdef __rtems__
+#ifdef ZYNQMP_USE_JUMBO
+	/* Only complete frames are taken from the ring */
+	LWIP_UNUSED_ARG(rx_bytes);
+	if (rx_frame.head != NULL) {
+		pbuf_free(rx_frame.head);
 	}
+#endif
+
+#if LWIP_IRQ_MODERATION
+	if (irq_moderation_update(&xemacpsif->rx_moderation, processed)) {
+		xemacps_rx_moderation_apply(xemacpsif);
+	}
+#endif
+	return processed;
+}
+
+void emacps_recv_handler(void *arg)
+{
+	struct xemac_s *xemac = (struct xemac_s *)(arg);
+#if ZYNQMP_RX_POLL_BUDGET
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+#endif
+
+#if !NO_SYS
+	xInsideISR++;
+#endif
+
+#if LWIP_IRQ_MODERATION
+	irq_moderation_interrupt(&((xemacpsif_s *)(xemac->state))->rx_moderation);
+#endif
+
+#if ZYNQMP_RX_POLL_BUDGET
+	/* The input thread takes the frames off the ring */
+	XEmacPs_IntDisable(&xemacpsif->emacps, XEMACPS_IXR_FRAMERX_MASK);
+#else
+	/* Drain the ring however long it keeps filling */
+	emacps_rx_process(xemac, 0x7fffffff);
+#endif
+
+#if !NO_SYS
+	sys_sem_signal(&xemac->sem_rx_data_available);
+	xInsideISR--;
+#endif
+}
+
+#if XEMACPSIF_RX_THREADED
+/*
+ * A DMA error must not reset the GEM from the interrupt while a thread is
+ * taking frames off one of its rings. The interrupt masks the whole GEM
+ * instead and leaves the reset to the input thread of queue 0, through
+ * emacps_dma_recover(). HandleEmacPsError() unmasks the GEM again.
+ */
+void emacps_dma_error(struct xemac_s *xemac)
+{
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+
+	XEmacPs_IntDisable(&xemacpsif->emacps, XEMACPS_IXR_ALL_MASK);
+#if ZYNQMP_RX_PRIORITY_QUEUE
+	if (xemacpsif->rxq1_bdspace != NULL) {
+		XEmacPs_WriteReg(xemacpsif->emacps.Config.BaseAddress,
+			XEMACPS_INTQ1_IDR_OFFSET, XEMACPS_INTQ1_IXR_ALL_MASK);
+	}
+#endif
+	xemacpsif->dma_error = 1;
+	sys_sem_signal(&xemac->sem_rx_data_available);
+}
+
+/* Waits for a batch of the other ring's thread to end before the reset */
+void emacps_dma_recover(struct xemac_s *xemac)
+{
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+
+	if (xemacpsif->dma_error == 0) {
+		return;
+	}
+	xemacpsif->dma_error = 0;
+	sys_mutex_lock(&xemacpsif->rx_lock);
+	HandleEmacPsError(xemac);
+	sys_mutex_unlock(&xemacpsif->rx_lock);
+}
+#endif
+
+#if ZYNQMP_RX_POLL_BUDGET
+s32_t emacps_rx_poll(struct xemac_s *xemac, s32_t budget)
+{
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+
+	if (emacps_rx_process(xemac, budget) >= budget) {
+		return 1;
+	}
+
+	/*
+	 * The ring is drained. A frame completed after the last look at it
+	 * raised no interrupt while they were masked, so look once more.
+	 */
+	XEmacPs_IntEnable(&xemacpsif->emacps, XEMACPS_IXR_FRAMERX_MASK);
+	if (emacps_rx_process(xemac, budget) == 0) {
+		return 0;
+	}
+	XEmacPs_IntDisable(&xemacpsif->emacps, XEMACPS_IXR_FRAMERX_MASK);
+	return 1;
+}
+#endif
+
+#if ZYNQMP_RX_PRIORITY_QUEUE
+/* Screener registers, counted by design configuration register 8 */
+#define XEMACPSIF_DCFG8_OFFSET		0x298U
+#define XEMACPSIF_SCRT1_OFFSET(n)	(0x500U + 4U * (n))
+#define XEMACPSIF_SCRT2_OFFSET(n)	(0x540U + 4U * (n))
+#define XEMACPSIF_SCRT2_ETHT_OFFSET(n)	(0x6E0U + 4U * (n))
+#define XEMACPSIF_T2CMPW0_OFFSET(n)	(0x700U + 8U * (n))
+#define XEMACPSIF_T2CMPW1_OFFSET(n)	(0x704U + 8U * (n))
+
+#define XEMACPSIF_SCRT1_UDP_PORT_SHIFT	12
+#define XEMACPSIF_SCRT1_UDP_PORT_EN	0x20000000U
+#define XEMACPSIF_SCRT2_ETHT_SHIFT	9
+#define XEMACPSIF_SCRT2_ETHT_EN		0x00001000U
+#define XEMACPSIF_SCRT2_CMPA_SHIFT	13
+#define XEMACPSIF_SCRT2_CMPA_EN		0x00040000U
+#define XEMACPSIF_SCRT2_CMPB_SHIFT	19
+#define XEMACPSIF_SCRT2_CMPB_EN		0x01000000U
+#define XEMACPSIF_T2CMP_SHIFT		16
+#define XEMACPSIF_T2CMP_ETYPE		0x00000080U /* offset after the Ethernet type */
+#define XEMACPSIF_T2CMP_IPHDR		0x00000100U /* offset after the IP header */
+
+/* Limits of the screener fields that index the Ethernet type and compare registers */
+#define XEMACPSIF_SCRT2_ETHT_MAX	8U
+#define XEMACPSIF_T2CMP_MAX		32U
+
+#define XEMACPSIF_RXQ1			1U
+
+/*
+ * Fills the free descriptors of receive queue 1 like setup_rx_bds() does for
+ * queue 0. The caller holds the protection that guards the ring.
+ */
+static void setup_rxq1_bds(xemacpsif_s *xemacpsif)
+{
+	XEmacPs_BdRing *rxring = &xemacpsif->rxq1_ring;
+	XEmacPs_Bd *rxbd;
+	struct pbuf *p;
+	u32_t bdindex;
+
+	while (XEmacPs_BdRingGetFreeCnt(rxring) > 0) {
+		p = xemacps_rx_pbuf_alloc(xemacpsif);
+		if (p == NULL) {
+#if LINK_STATS
+			lwip_stats.link.memerr++;
+			lwip_stats.link.drop++;
+#endif
+			return;
+		}
+		if (XEmacPs_BdRingAlloc(rxring, 1, &rxbd) != XST_SUCCESS) {
+			pbuf_free(p);
+			return;
+		}
+		if (XEmacPs_BdRingToHw(rxring, 1, rxbd) != XST_SUCCESS) {
+			pbuf_free(p);
+			XEmacPs_BdRingUnAlloc(rxring, 1, rxbd);
+			return;
+		}
+		if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+			xemacps_rx_invalidate(p, p->len);
+		}
+
+		bdindex = XEMACPS_BD_TO_INDEX(rxring, rxbd);
+		/* Status field should be cleared first to avoid drops */
+		XEmacPs_BdWrite(rxbd, XEMACPS_BD_STAT_OFFSET, 0);
+		dsb();
+#ifdef __aarch64__
+		XEmacPs_BdWrite(rxbd, XEMACPS_BD_ADDR_HI_OFFSET,
+			(((UINTPTR)p->payload) & ULONG64_HI_MASK) >> 32U);
+#endif
+		if (bdindex == (ZYNQMP_RXQ1_N_DESC - 1)) {
+			XEmacPs_BdWrite(rxbd, XEMACPS_BD_ADDR_OFFSET,
+				((UINTPTR)p->payload | XEMACPS_RXBUF_WRAP_MASK));
+		} else {
+			XEmacPs_BdWrite(rxbd, XEMACPS_BD_ADDR_OFFSET, (UINTPTR)p->payload);
+		}
+		xemacpsif->rxq1_pbufs[bdindex] = (UINTPTR)p;
+	}
+}
+
+/*
+ * Creates the ring of receive queue 1 in bdspace and fills it. Its buffers
+ * have the size queue 0 was configured with.
+ */
+static XStatus init_rxq1_dma(xemacpsif_s *xemacpsif, void *bdspace)
+{
+	UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+	XEmacPs_BdRing *rxring = &xemacpsif->rxq1_ring;
+	XEmacPs_Bd bdtemplate;
+	u32_t dmacr;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	XEmacPs_BdClear(&bdtemplate);
+	if (XEmacPs_BdRingCreateExt(rxring, (UINTPTR)bdspace, (UINTPTR)bdspace,
+			BD_ALIGNMENT, ZYNQMP_RXQ1_N_DESC,
+			xemacps_bd_size(xemacpsif)) != XST_SUCCESS ||
+	    XEmacPs_BdRingClone(rxring, &bdtemplate, XEMACPS_RECV) != XST_SUCCESS) {
+		LWIP_DEBUGF(NETIF_DEBUG, ("Error setting up RxBD space of queue 1\r\n"));
+		return XST_FAILURE;
+	}
+	xemacpsif->rxq1_bdspace = bdspace;
+
+	SYS_ARCH_PROTECT(lev);
+	setup_rxq1_bds(xemacpsif);
+	SYS_ARCH_UNPROTECT(lev);
+
+	dmacr = XEmacPs_ReadReg(base, XEMACPS_DMACR_OFFSET);
+	XEmacPs_WriteReg(base, XEMACPS_RXBUFQ1SIZE_OFFSET,
+		(dmacr & XEMACPS_DMACR_RXBUF_MASK) >> XEMACPS_DMACR_RXBUF_SHIFT);
+	XEmacPs_Out32(base + XEMACPS_RXQ1BASE_OFFSET, (UINTPTR)bdspace);
+	return XST_SUCCESS;
+}
+
+/*
+ * Adds the frames of up to budget descriptors of receive queue 1 to burst
+ * and refills the ring. Returns the number of descriptors processed.
+ */
+static s32_t emacps_rxq1_process(struct xemac_s *xemac,
+	struct netif_burst *burst, s32_t budget)
+{
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+	XEmacPs_BdRing *rxring = &xemacpsif->rxq1_ring;
+	XEmacPs_Bd *rxbdset, *curbdptr;
+	struct pbuf *p;
+	s32_t bd_processed, k;
+	u32_t bdindex;
+#ifdef ZYNQMP_USE_JUMBO
+	struct xemacps_rx_frame rx_frame = { NULL, 0, 0 };
+#else
+	u32_t rx_bytes;
+#endif
+
+	/* Anything resetting the ring holds the same lock */
+	sys_mutex_lock(&xemacpsif->rx_lock);
+	/* As on queue 0, a jumbo frame is never left stuck behind the budget */
+	bd_processed = XEmacPs_BdRingFromHwRx(rxring,
+		LWIP_MAX(LWIP_MIN(budget, ZYNQMP_RXQ1_N_DESC),
+			XEMACPSIF_RX_FRAME_BDS), &rxbdset);
+	for (k = 0, curbdptr = rxbdset; k < bd_processed;
+			k++, curbdptr = XEmacPs_BdRingNext(rxring, curbdptr)) {
+		bdindex = XEMACPS_BD_TO_INDEX(rxring, curbdptr);
+		p = (struct pbuf *)xemacpsif->rxq1_pbufs[bdindex];
+		xemacpsif->rxq1_pbufs[bdindex] = 0;
+
+#ifdef ZYNQMP_USE_JUMBO
+		p = xemacps_rx_assemble(xemacpsif, &rx_frame, curbdptr, p);
+#endif
+		if (p == NULL) {
+			continue;
+		}
+#ifndef ZYNQMP_USE_JUMBO
+		rx_bytes = XEmacPs_BdGetLength(curbdptr);
+		pbuf_realloc(p, rx_bytes);
+		if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+			xemacps_rx_invalidate(p, rx_bytes);
+		}
+#endif
+#if ZYNQMP_CHECKSUM_OFFLOAD
+		xemacps_rx_checksum(p, curbdptr);
+#endif
+#if LWIP_HWTSTAMP
+		xemacps_rx_tstamp(xemacpsif, p, curbdptr);
+#endif
+#if LINK_STATS
+		lwip_stats.link.recv++;
+#endif
+		xemacpsif->stats.rx_frames++;
+		netif_burst_add(burst, p);
+	}
+	if (bd_processed > 0) {
+		XEmacPs_BdRingFree(rxring, bd_processed, rxbdset);
+	}
+	setup_rxq1_bds(xemacpsif);
+	sys_mutex_unlock(&xemacpsif->rx_lock);
+
+#ifdef ZYNQMP_USE_JUMBO
+	/* Only complete frames are taken from the ring */
+	if (rx_frame.head != NULL) {
+		pbuf_free(rx_frame.head);
+	}
+#endif
+	return bd_processed;
+}
+
+/* Queue 1 is polled by its input thread with its interrupts masked */
+void emacps_recv_q1_handler(void *arg)
+{
+	struct xemac_s *xemac = (struct xemac_s *)(arg);
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+
+	XEmacPs_WriteReg(xemacpsif->emacps.Config.BaseAddress,
+		XEMACPS_INTQ1_IDR_OFFSET, XEMACPS_INTQ1_IXR_RX_MASK);
+	sys_sem_signal(&xemacpsif->rxq1_sem);
+}
+
+/*
+ * Returns 1 while queue 1 may hold more frames and 0 with the ring drained
+ * and its interrupts unmasked again, as emacps_rx_poll() does for queue 0.
+ */
+s32_t emacps_rxq1_poll(struct xemac_s *xemac, struct netif_burst *burst,
+		s32_t budget)
+{
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+	UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+
+	if (emacps_rxq1_process(xemac, burst, budget) >= budget) {
+		return 1;
+	}
+
+	XEmacPs_WriteReg(base, XEMACPS_INTQ1_IER_OFFSET, XEMACPS_INTQ1_IXR_RX_MASK);
+	if (emacps_rxq1_process(xemac, burst, budget) == 0) {
+		return 0;
+	}
+	XEmacPs_WriteReg(base, XEMACPS_INTQ1_IDR_OFFSET, XEMACPS_INTQ1_IXR_RX_MASK);
+	return 1;
+}
+
+/* Returns the Ethernet type register holding ethertype, -1 if none is left */
+static s32_t xemacps_screen_etype(xemacpsif_s *xemacpsif, u16_t ethertype,
+	u32_t count)
+{
+	UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+	u32_t i;
+
+	for (i = 0; i < xemacpsif->screen_etype_used; i++) {
+		if (XEmacPs_ReadReg(base, XEMACPSIF_SCRT2_ETHT_OFFSET(i)) == ethertype) {
+			return i;
+		}
+	}
+	if (i >= LWIP_MIN(count, XEMACPSIF_SCRT2_ETHT_MAX)) {
+		return -1;
+	}
+	XEmacPs_WriteReg(base, XEMACPSIF_SCRT2_ETHT_OFFSET(i), ethertype);
+	xemacpsif->screen_etype_used++;
+	return i;
+}
+
+/*
+ * Programs a type 2 screener matching ethertype and, unless tcp_port is 0,
+ * the TCP destination port of IPv4 frames. The compare registers match 16
+ * bits in network byte order under a mask at an offset into the frame.
+ */
+static err_t xemacps_screen_t2(xemacpsif_s *xemacpsif, u16_t ethertype,
+	u16_t tcp_port)
+{
+	UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+	u32_t dcfg8 = XEmacPs_ReadReg(base, XEMACPSIF_DCFG8_OFFSET);
+	u32_t cmp = xemacpsif->screen_cmp_used;
+	u32_t scrt2;
+	s32_t etype;
+
+	if (xemacpsif->screen_t2_used >= ((dcfg8 >> 16) & 0xFFU) ||
+	    (tcp_port != 0 &&
+	     cmp + 2 > LWIP_MIN(dcfg8 & 0xFFU, XEMACPSIF_T2CMP_MAX))) {
+		return ERR_MEM;
+	}
+	etype = xemacps_screen_etype(xemacpsif, ethertype, (dcfg8 >> 8) & 0xFFU);
+	if (etype < 0) {
+		return ERR_MEM;
+	}
+
+	scrt2 = XEMACPSIF_RXQ1 | XEMACPSIF_SCRT2_ETHT_EN |
+		((u32_t)etype << XEMACPSIF_SCRT2_ETHT_SHIFT);
+	if (tcp_port != 0) {
+		/* The protocol is the second byte of the 16 bits at IP offset 8 */
+		XEmacPs_WriteReg(base, XEMACPSIF_T2CMPW0_OFFSET(cmp),
+			((u32_t)IP_PROTO_TCP << XEMACPSIF_T2CMP_SHIFT) | 0x00FFU);
+		XEmacPs_WriteReg(base, XEMACPSIF_T2CMPW1_OFFSET(cmp),
+			XEMACPSIF_T2CMP_ETYPE | 8U);
+		/* The destination port follows the source port */
+		XEmacPs_WriteReg(base, XEMACPSIF_T2CMPW0_OFFSET(cmp + 1),
+			((u32_t)tcp_port << XEMACPSIF_T2CMP_SHIFT) | 0xFFFFU);
+		XEmacPs_WriteReg(base, XEMACPSIF_T2CMPW1_OFFSET(cmp + 1),
+			XEMACPSIF_T2CMP_IPHDR | 2U);
+		scrt2 |= XEMACPSIF_SCRT2_CMPA_EN |
+			(cmp << XEMACPSIF_SCRT2_CMPA_SHIFT) |
+			XEMACPSIF_SCRT2_CMPB_EN |
+			((cmp + 1) << XEMACPSIF_SCRT2_CMPB_SHIFT);
+		xemacpsif->screen_cmp_used += 2;
+	}
+	XEmacPs_WriteReg(base, XEMACPSIF_SCRT2_OFFSET(xemacpsif->screen_t2_used),
+		scrt2);
+	xemacpsif->screen_t2_used++;
+	return ERR_OK;
+}
+
+/* The kinds of rule xemacps_screen() programs */
+#define XEMACPSIF_SCREEN_UDP	0
+#define XEMACPSIF_SCREEN_TCP	1
+#define XEMACPSIF_SCREEN_ETYPE	2
+
+static err_t xemacps_screen(struct netif *netif, u8_t rule, u16_t value)
+{
+	struct xemac_s *xemac = (struct xemac_s *)(netif->state);
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)(xemac->state);
+	UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+	err_t err = ERR_MEM;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	if (xemacpsif->rxq1_bdspace == NULL) {
+		return ERR_IF;
+	}
+
+	SYS_ARCH_PROTECT(lev);
+	switch (rule) {
+		case XEMACPSIF_SCREEN_UDP:
+			if (xemacpsif->screen_t1_used <
+			    (XEmacPs_ReadReg(base, XEMACPSIF_DCFG8_OFFSET) >> 24)) {
+				XEmacPs_WriteReg(base,
+					XEMACPSIF_SCRT1_OFFSET(xemacpsif->screen_t1_used),
+					XEMACPSIF_RXQ1 | XEMACPSIF_SCRT1_UDP_PORT_EN |
+					((u32_t)value << XEMACPSIF_SCRT1_UDP_PORT_SHIFT));
+				xemacpsif->screen_t1_used++;
+				err = ERR_OK;
+			}
+			break;
+		case XEMACPSIF_SCREEN_TCP:
+			err = xemacps_screen_t2(xemacpsif, ETHTYPE_IP, value);
+			break;
+		default:
+			err = xemacps_screen_t2(xemacpsif, value, 0);
+			break;
+	}
+	SYS_ARCH_UNPROTECT(lev);
+
+	return err;
+}
+
+err_t xemacpsif_screen_udp_port(struct netif *netif, u16_t port)
+{
+	return xemacps_screen(netif, XEMACPSIF_SCREEN_UDP, port);
+}
+
+err_t xemacpsif_screen_tcp_port(struct netif *netif, u16_t port)
+{
+	if (port == 0) {
+		return ERR_ARG;
+	}
+	return xemacps_screen(netif, XEMACPSIF_SCREEN_TCP, port);
+}
+
+err_t xemacpsif_screen_ethertype(struct netif *netif, u16_t ethertype)
+{
+	return xemacps_screen(netif, XEMACPSIF_SCREEN_ETYPE, ethertype);
+}
+#endif
+#else
 #if !NO_SYS
 	sys_sem_signal(&xemac->sem_rx_data_available);
 	xInsideISR--;
@@ -620,6 +1660,7 @@ void emacps_recv_handler(void *arg)
 
 	return;
 }
+#endif
 
 void clean_dma_txdescs(struct xemac_s *xemac)
 {
@@ -635,9 +1676,15 @@ void clean_dma_txdescs(struct xemac_s *xemac)
 	/*
 	 * Create the TxBD ring
 	 */
+#ifdef __rtems__
+	XEmacPs_BdRingCreateExt(txringptr, (UINTPTR) xemacpsif->tx_bdspace,
+			(UINTPTR) xemacpsif->tx_bdspace, BD_ALIGNMENT,
+				 XLWIP_CONFIG_N_TX_DESC, xemacps_bd_size(xemacpsif));
+#else
 	XEmacPs_BdRingCreate(txringptr, (UINTPTR) xemacpsif->tx_bdspace,
 			(UINTPTR) xemacpsif->tx_bdspace, BD_ALIGNMENT,
 				 XLWIP_CONFIG_N_TX_DESC);
+#endif
 	XEmacPs_BdRingClone(txringptr, &bdtemplate, XEMACPS_SEND);
 }
 
@@ -687,6 +1734,20 @@ XStatus init_dma(struct xemac_s *xemac)
 	LWIP_DEBUGF(NETIF_DEBUG, ("rxringptr: 0x%08x\r\n", rxringptr));
 	LWIP_DEBUGF(NETIF_DEBUG, ("txringptr: 0x%08x\r\n", txringptr));
 
+#ifdef __rtems__
+	/*
+	 * Each GEM takes its rings once, so that all four fit and the error
+	 * handler calling this again does not use up the space.
+	 */
+	if (xemacpsif->rx_bdspace != NULL) {
+		bdrxterminate = xemacpsif->rx_terminate_bdspace;
+		bdtxterminate = xemacpsif->tx_terminate_bdspace;
+	} else if (bd_space_index + 4 * 0x10000 > sizeof(bd_space)) {
+		xil_printf("%s@%d: Error: Out of space for TX/RX buffer descriptors",
+				__FILE__, __LINE__);
+		return ERR_IF;
+	} else {
+#endif
 	/* Allocate 64k for Rx and Tx bds each to take care of extreme cases */
 	tempaddress = (UINTPTR)&(bd_space[bd_space_index]);
 	xemacpsif->rx_bdspace = (void *)tempaddress;
@@ -702,6 +1763,11 @@ XStatus init_dma(struct xemac_s *xemac)
 		bdtxterminate = (XEmacPs_Bd *)tempaddress;
 		bd_space_index += 0x10000;
 	}
+#ifdef __rtems__
+		xemacpsif->rx_terminate_bdspace = bdrxterminate;
+		xemacpsif->tx_terminate_bdspace = bdtxterminate;
+	}
+#endif
 
 	LWIP_DEBUGF(NETIF_DEBUG, ("rx_bdspace: %p \r\n", xemacpsif->rx_bdspace));
 	LWIP_DEBUGF(NETIF_DEBUG, ("tx_bdspace: %p \r\n", xemacpsif->tx_bdspace));
@@ -712,6 +1778,23 @@ XStatus init_dma(struct xemac_s *xemac)
 		return ERR_IF;
 	}
 
+#if defined(__rtems__) && LWIP_HWTSTAMP
+	if (XEMACPSIF_HAS_TSU(xemacpsif)) {
+		UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+
+		/* Every frame is stamped into its extended descriptors */
+		XEmacPs_WriteReg(base, XEMACPS_DMACR_OFFSET,
+			XEmacPs_ReadReg(base, XEMACPS_DMACR_OFFSET) |
+			XEMACPS_DMACR_TXEXTEND_MASK | XEMACPS_DMACR_RXEXTEND_MASK);
+		XEmacPs_WriteReg(base, XEMACPS_TXBDCTRL_OFFSET,
+			(XEmacPs_ReadReg(base, XEMACPS_TXBDCTRL_OFFSET) &
+			~XEMACPS_BDCTRL_TSMODE_MASK) | XEMACPS_BDCTRL_TSMODE_ALL);
+		XEmacPs_WriteReg(base, XEMACPS_RXBDCTRL_OFFSET,
+			(XEmacPs_ReadReg(base, XEMACPS_RXBDCTRL_OFFSET) &
+			~XEMACPS_BDCTRL_TSMODE_MASK) | XEMACPS_BDCTRL_TSMODE_ALL);
+	}
+#endif
+
 	/*
 	 * Setup RxBD space.
 	 *
@@ -724,9 +1807,15 @@ XStatus init_dma(struct xemac_s *xemac)
 	 * Create the RxBD ring
 	 */
 
+#ifdef __rtems__
+	status = XEmacPs_BdRingCreateExt(rxringptr, (UINTPTR) xemacpsif->rx_bdspace,
+				(UINTPTR) xemacpsif->rx_bdspace, BD_ALIGNMENT,
+				     XLWIP_CONFIG_N_RX_DESC, xemacps_bd_size(xemacpsif));
+#else
 	status = XEmacPs_BdRingCreate(rxringptr, (UINTPTR) xemacpsif->rx_bdspace,
 				(UINTPTR) xemacpsif->rx_bdspace, BD_ALIGNMENT,
 				     XLWIP_CONFIG_N_RX_DESC);
+#endif
 
 	if (status != XST_SUCCESS) {
 		LWIP_DEBUGF(NETIF_DEBUG, ("Error setting up RxBD space\r\n"));
@@ -744,9 +1833,15 @@ XStatus init_dma(struct xemac_s *xemac)
 	/*
 	 * Create the TxBD ring
 	 */
+#ifdef __rtems__
+	status = XEmacPs_BdRingCreateExt(txringptr, (UINTPTR) xemacpsif->tx_bdspace,
+				(UINTPTR) xemacpsif->tx_bdspace, BD_ALIGNMENT,
+				     XLWIP_CONFIG_N_TX_DESC, xemacps_bd_size(xemacpsif));
+#else
 	status = XEmacPs_BdRingCreate(txringptr, (UINTPTR) xemacpsif->tx_bdspace,
 				(UINTPTR) xemacpsif->tx_bdspace, BD_ALIGNMENT,
 				     XLWIP_CONFIG_N_TX_DESC);
+#endif
 
 	if (status != XST_SUCCESS) {
 		return ERR_IF;
@@ -762,7 +1857,9 @@ XStatus init_dma(struct xemac_s *xemac)
 	 * Allocate RX descriptors, 1 RxBD at a time.
 	 */
 	for (i = 0; i < XLWIP_CONFIG_N_RX_DESC; i++) {
-#ifdef ZYNQMP_USE_JUMBO
+#ifdef __rtems__
+		p = xemacps_rx_pbuf_alloc(xemacpsif);
+#elif defined(ZYNQMP_USE_JUMBO)
 		p = pbuf_alloc(PBUF_RAW, MAX_FRAME_SIZE_JUMBO, PBUF_POOL);
 #else
 		p = pbuf_alloc(PBUF_RAW, XEMACPS_MAX_FRAME_SIZE, PBUF_POOL);
@@ -801,11 +1898,19 @@ XStatus init_dma(struct xemac_s *xemac)
 		dsb();
 #ifdef ZYNQMP_USE_JUMBO
 		if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+#ifdef __rtems__
+			xemacps_rx_invalidate(p, p->len);
+#else
 			Xil_DCacheInvalidateRange((UINTPTR)p->payload, (UINTPTR)MAX_FRAME_SIZE_JUMBO);
+#endif
 		}
 #else
 		if (xemacpsif->emacps.Config.IsCacheCoherent == 0) {
+#ifdef __rtems__
+			xemacps_rx_invalidate(p, p->len);
+#else
 			Xil_DCacheInvalidateRange((UINTPTR)p->payload, (UINTPTR)XEMACPS_MAX_FRAME_SIZE);
+#endif
 		}
 #endif
 		XEmacPs_BdSetAddressRx(rxbd, (UINTPTR)p->payload);
@@ -835,18 +1940,31 @@ XStatus init_dma(struct xemac_s *xemac)
 		 * the controller to malfunction by fetching the descriptors
 		 * from these queues.
 		 */
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+		/* Receive queue 1 takes what the screeners steer to it */
+		if (init_rxq1_dma(xemacpsif, bdrxterminate) != XST_SUCCESS) {
+			return ERR_IF;
+		}
+#else
 		XEmacPs_BdClear(bdrxterminate);
 		XEmacPs_BdSetAddressRx(bdrxterminate, (XEMACPS_RXBUF_NEW_MASK |
 						XEMACPS_RXBUF_WRAP_MASK));
 		XEmacPs_Out32((xemacpsif->emacps.Config.BaseAddress + XEMACPS_RXQ1BASE_OFFSET),
 				   (UINTPTR)bdrxterminate);
+#endif
 		XEmacPs_BdClear(bdtxterminate);
 		XEmacPs_BdSetStatus(bdtxterminate, (XEMACPS_TXBUF_USED_MASK |
 						XEMACPS_TXBUF_WRAP_MASK));
 		XEmacPs_Out32((xemacpsif->emacps.Config.BaseAddress + XEMACPS_TXQBASE_OFFSET),
 				   (UINTPTR)bdtxterminate);
 	}
-#if !NO_SYS
+#if defined(__rtems__)
+	/* Spread the GEMs over the interrupt servers of the processors */
+	xPortInstallInterruptHandlerOnServer(xemac->topology_index,
+						xtopologyp->scugic_emac_intr,
+						( Xil_InterruptHandler ) XEmacPs_IntrHandler,
+						(void *)&xemacpsif->emacps);
+#elif !NO_SYS
 	xPortInstallInterruptHandler(xtopologyp->scugic_emac_intr,
 						( Xil_InterruptHandler ) XEmacPs_IntrHandler,
 						(void *)&xemacpsif->emacps);
@@ -864,7 +1982,15 @@ XStatus init_dma(struct xemac_s *xemac)
 	 * Enable the interrupt for emacps.
 	 */
 	XScuGic_EnableIntr(INTC_DIST_BASE_ADDR, (u32) xtopologyp->scugic_emac_intr);
+#ifdef __rtems__
+	xemacpsif->intr_num = (u32) xtopologyp->scugic_emac_intr;
+#else
 	emac_intr_num = (u32) xtopologyp->scugic_emac_intr;
+#endif
+#if defined(__rtems__) && LWIP_IRQ_MODERATION
+	/* Also restores the delay after the error handler reset the GEM */
+	xemacps_rx_moderation_apply(xemacpsif);
+#endif
 	return 0;
 }
 
@@ -913,6 +2039,9 @@ void free_txrx_pbufs(xemacpsif_s *xemacpsif)
 
 	index1 = get_base_index_txpbufsstorage (xemacpsif);
 
+#ifdef __rtems__
+	xemacps_tx_queue_flush(xemacpsif);
+#endif
 	for (index = index1; index < (index1 + XLWIP_CONFIG_N_TX_DESC); index++) {
 #ifdef __rtems__
 		SYS_ARCH_DECL_PROTECT(lev);
@@ -945,6 +2074,19 @@ void free_txrx_pbufs(xemacpsif_s *xemacpsif)
 		pbuf_free(p);
 
 	}
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+
+	for (index = 0; index < ZYNQMP_RXQ1_N_DESC; index++) {
+		SYS_ARCH_DECL_PROTECT(lev);
+		SYS_ARCH_PROTECT(lev);
+		p = (struct pbuf *)xemacpsif->rxq1_pbufs[index];
+		xemacpsif->rxq1_pbufs[index] = 0;
+		SYS_ARCH_UNPROTECT(lev);
+		if (p != NULL) {
+			pbuf_free(p);
+		}
+	}
+#endif
 }
 
 void free_onlytx_pbufs(xemacpsif_s *xemacpsif)
@@ -954,6 +2096,9 @@ void free_onlytx_pbufs(xemacpsif_s *xemacpsif)
 	struct pbuf *p;
 
 	index1 = get_base_index_txpbufsstorage (xemacpsif);
+#ifdef __rtems__
+	xemacps_tx_queue_flush(xemacpsif);
+#endif
 	for (index = index1; index < (index1 + XLWIP_CONFIG_N_TX_DESC); index++) {
 #ifdef __rtems__
 		SYS_ARCH_DECL_PROTECT(lev);
@@ -991,8 +2136,26 @@ void reset_dma(struct xemac_s *xemac)
 
 	XEmacPs_SetQueuePtr(&(xemacpsif->emacps), xemacpsif->emacps.RxBdRing.BaseBdAddr, 0, XEMACPS_RECV);
 	XEmacPs_SetQueuePtr(&(xemacpsif->emacps), xemacpsif->emacps.TxBdRing.BaseBdAddr, txqueuenum, XEMACPS_SEND);
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+	if (xemacpsif->rxq1_bdspace != NULL) {
+		XEmacPs_BdRingPtrReset(&xemacpsif->rxq1_ring, xemacpsif->rxq1_bdspace);
+		XEmacPs_Out32((xemacpsif->emacps.Config.BaseAddress + XEMACPS_RXQ1BASE_OFFSET),
+				   (UINTPTR)xemacpsif->rxq1_bdspace);
+	}
+#endif
 }
 
+#ifdef __rtems__
+void emac_disable_intr(xemacpsif_s *xemacpsif)
+{
+	XScuGic_DisableIntr(INTC_DIST_BASE_ADDR, xemacpsif->intr_num);
+}
+
+void emac_enable_intr(xemacpsif_s *xemacpsif)
+{
+	XScuGic_EnableIntr(INTC_DIST_BASE_ADDR, xemacpsif->intr_num);
+}
+#else
 void emac_disable_intr(void)
 {
 	XScuGic_DisableIntr(INTC_DIST_BASE_ADDR, emac_intr_num);
@@ -1002,3 +2165,4 @@ void emac_enable_intr(void)
 {
 	XScuGic_EnableIntr(INTC_DIST_BASE_ADDR, emac_intr_num);
 }
+#endif
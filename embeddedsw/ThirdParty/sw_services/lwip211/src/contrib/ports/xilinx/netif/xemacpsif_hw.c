@@ -30,6 +30,12 @@
 
 #include "netif/xemacpsif.h"
 #include "lwipopts.h"
+#ifdef __rtems__
+#include <string.h>
+#if LWIP_HWTSTAMP
+#include <time.h>
+#endif
+#endif
 
 #if XPAR_GIGE_PCS_PMA_1000BASEX_CORE_PRESENT == 1 || \
 	XPAR_GIGE_PCS_PMA_SGMII_CORE_PRESENT == 1
@@ -82,12 +88,31 @@ void init_emacps(xemacpsif_s *xemacps, struct netif *netif)
 
 #ifdef ZYNQMP_USE_JUMBO
 	XEmacPs_SetOptions(xemacpsp, XEMACPS_JUMBO_ENABLE_OPTION);
+#ifdef __rtems__
+	/* Let frames span several descriptors instead of one jumbo buffer */
+	XEmacPs_WriteReg(xemacpsp->Config.BaseAddress, XEMACPS_DMACR_OFFSET,
+		(XEmacPs_ReadReg(xemacpsp->Config.BaseAddress, XEMACPS_DMACR_OFFSET) &
+		~XEMACPS_DMACR_RXBUF_MASK) |
+		(((u32)XEMACPSIF_RX_BUF_SIZE / XEMACPS_RX_BUF_UNIT) <<
+		XEMACPS_DMACR_RXBUF_SHIFT));
+#endif
 #endif
 
 #ifdef LWIP_IGMP
 	XEmacPs_SetOptions(xemacpsp, XEMACPS_MULTICAST_OPTION);
 #endif
 
+#if defined(__rtems__) && ZYNQMP_CHECKSUM_OFFLOAD
+	XEmacPs_SetOptions(xemacpsp, XEMACPS_RX_CHKSUM_ENABLE_OPTION);
+#ifndef ZYNQMP_USE_JUMBO
+	/*
+	 * Jumbo frames do not fit the transmit packet buffer the GEM inserts
+	 * checksums in, the stack computes them instead.
+	 */
+	XEmacPs_SetOptions(xemacpsp, XEMACPS_TX_CHKSUM_ENABLE_OPTION);
+#endif
+#endif
+
 	/* set mac address */
 	status = XEmacPs_SetMacAddress(xemacpsp, (void*)(netif->hwaddr), 1);
 	if (status != XST_SUCCESS) {
@@ -113,6 +138,12 @@ void init_emacps(xemacpsif_s *xemacps, struct netif *netif)
 	link_speed = phy_setup_emacps(xemacpsp, XPAR_PCSPMA_SGMII_PHYADDR);
 #endif
 #else
+#ifdef __rtems__
+	/* The maps are shared by all GEMs; only this one's PHYs count */
+	memset(phymapemac0, 0, sizeof(phymapemac0));
+	memset(phymapemac1, 0, sizeof(phymapemac1));
+	phyaddrforemac = 0;
+#endif
 	detect_phy(xemacpsp);
 	for (i = 31; i > 0; i--) {
 		if (xemacpsp->Config.BaseAddress == XPAR_XEMACPS_0_BASEADDR) {
@@ -142,10 +173,19 @@ void init_emacps(xemacpsif_s *xemacps, struct netif *netif)
 	if (link_speed == XST_FAILURE) {
 		eth_link_status = ETH_LINK_DOWN;
 		xil_printf("Phy setup failure %s \n\r",__func__);
+#ifdef __rtems__
+		xemacps->link_status = ETH_LINK_DOWN;
+#endif
 		return;
 	} else {
 		eth_link_status = ETH_LINK_UP;
 	}
+#ifdef __rtems__
+	/* eth_link_detect() and the error handler use the state of this GEM */
+	xemacps->phy_addr = phyaddrforemac;
+	xemacps->link_speed = link_speed;
+	xemacps->link_status = ETH_LINK_UP;
+#endif
 
 	XEmacPs_SetOperatingSpeed(xemacpsp, link_speed);
 	/* Setting the operating speed of the MAC needs a delay. */
@@ -168,7 +208,11 @@ void init_emacps_on_error (xemacpsif_s *xemacps, struct netif *netif)
 		xil_printf("In %s:Emac Mac Address set failed...\r\n",__func__);
 	}
 
+#ifdef __rtems__
+	XEmacPs_SetOperatingSpeed(xemacpsp, xemacps->link_speed);
+#else
 	XEmacPs_SetOperatingSpeed(xemacpsp, link_speed);
+#endif
 
 	/* Setting the operating speed of the MAC needs a delay. */
 	{
@@ -196,6 +240,14 @@ void setup_isr (struct xemac_s *xemac)
 	XEmacPs_SetHandler(&xemacpsif->emacps, XEMACPS_HANDLER_ERROR,
 				    (void *) emacps_error_handler,
 				    (void *) xemac);
+
+#if defined(__rtems__) && ZYNQMP_RX_PRIORITY_QUEUE
+	if (xemacpsif->emacps.Version > 2) {
+		XEmacPs_SetHandler(&xemacpsif->emacps, XEMACPS_HANDLER_DMARECVQ1,
+				    (void *) emacps_recv_q1_handler,
+				    (void *) xemac);
+	}
+#endif
 }
 
 void start_emacps (xemacpsif_s *xemacps)
@@ -233,29 +285,45 @@ void emacps_error_handler(void *arg,u8 Direction, u32 ErrorWord)
 	xemacpsif = (xemacpsif_s *)(xemac->state);
 	rxring = &XEmacPs_GetRxRing(&xemacpsif->emacps);
 	txring = &XEmacPs_GetTxRing(&xemacpsif->emacps);
+#if defined(__rtems__) && ZYNQMP_RX_POLL_BUDGET
+	/* The input thread refills the ring once it is woken */
+	LWIP_UNUSED_ARG(rxring);
+#endif
 
 	if (ErrorWord != 0) {
 		switch (Direction) {
 			case XEMACPS_RECV:
 			if (ErrorWord & XEMACPS_RXSR_HRESPNOK_MASK) {
 				LWIP_DEBUGF(NETIF_DEBUG, ("Receive DMA error\r\n"));
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+				emacps_dma_error(xemac);
+#else
 				HandleEmacPsError(xemac);
+#endif
 			}
 			if (ErrorWord & XEMACPS_RXSR_RXOVR_MASK) {
 				LWIP_DEBUGF(NETIF_DEBUG, ("Receive over run\r\n"));
 				emacps_recv_handler(arg);
+#if !defined(__rtems__) || !ZYNQMP_RX_POLL_BUDGET
 				setup_rx_bds(xemacpsif, rxring);
+#endif
 			}
 			if (ErrorWord & XEMACPS_RXSR_BUFFNA_MASK) {
 				LWIP_DEBUGF(NETIF_DEBUG, ("Receive buffer not available\r\n"));
 				emacps_recv_handler(arg);
+#if !defined(__rtems__) || !ZYNQMP_RX_POLL_BUDGET
 				setup_rx_bds(xemacpsif, rxring);
+#endif
 			}
 			break;
 			case XEMACPS_SEND:
 			if (ErrorWord & XEMACPS_TXSR_HRESPNOK_MASK) {
 				LWIP_DEBUGF(NETIF_DEBUG, ("Transmit DMA error\r\n"));
+#if defined(__rtems__) && XEMACPSIF_RX_THREADED
+				emacps_dma_error(xemac);
+#else
 				HandleEmacPsError(xemac);
+#endif
 			}
 			if (ErrorWord & XEMACPS_TXSR_URUN_MASK) {
 				LWIP_DEBUGF(NETIF_DEBUG, ("Transmit under run\r\n"));
@@ -280,3 +348,177 @@ void emacps_error_handler(void *arg,u8 Direction, u32 ErrorWord)
 	xInsideISR--;
 #endif
 }
+
+#if defined(__rtems__) && LWIP_HWTSTAMP
+/* Nanoseconds the TSU advances per clock cycle, with 24 fraction bits */
+#define XEMACPSIF_TSU_INCR \
+	((((u64_t)1000000000U) << 24) / ZYNQMP_TSU_CLOCK_HZ)
+#define XEMACPSIF_TSU_INCR_NS_MAX	0xFFU
+#define XEMACPSIF_TSU_SECHI_MASK	0x0000FFFFU
+#define XEMACPSIF_TSU_ADJ_SUB		0x80000000U
+/* Descriptor timestamps hold nanoseconds and the low six bits of seconds */
+#define XEMACPSIF_TS_NSEC_MASK		0x3FFFFFFFU
+#define XEMACPSIF_TS_SEC_MASK		0x3FU
+#define XEMACPSIF_NSEC_PER_SEC		1000000000
+
+static UINTPTR xemacps_phc_base(struct netif *netif)
+{
+	struct xemac_s *xemac = (struct xemac_s *)netif->state;
+	xemacpsif_s *xemacpsif = (xemacpsif_s *)xemac->state;
+
+	return xemacpsif->emacps.Config.BaseAddress;
+}
+
+static void xemacps_tsu_set_incr(UINTPTR base, u64_t incr)
+{
+	u32_t subns = (u32_t)incr & 0x00FFFFFFU;
+
+	/* The sub-nanoseconds take effect with the nanoseconds written next */
+	XEmacPs_WriteReg(base, XEMACPS_1588_SUBNS_INC_OFFSET,
+		((subns & 0xFFU) << 24) | (subns >> 8));
+	XEmacPs_WriteReg(base, XEMACPS_1588_INC_OFFSET,
+		(u32_t)(incr >> 24) & XEMACPSIF_TSU_INCR_NS_MAX);
+}
+
+static void xemacps_tsu_read(UINTPTR base, u64_t *sec, u32_t *nsec)
+{
+	u32_t first, second, seclo, sechi;
+
+	first = XEmacPs_ReadReg(base, XEMACPS_1588_NANOSEC_OFFSET);
+	seclo = XEmacPs_ReadReg(base, XEMACPS_1588_SEC_OFFSET);
+	sechi = XEmacPs_ReadReg(base, XEMACPS_1588_SECHI_OFFSET);
+	second = XEmacPs_ReadReg(base, XEMACPS_1588_NANOSEC_OFFSET);
+	if (second < first) {
+		/* The seconds may predate the wrap, read them again */
+		first = second;
+		seclo = XEmacPs_ReadReg(base, XEMACPS_1588_SEC_OFFSET);
+		sechi = XEmacPs_ReadReg(base, XEMACPS_1588_SECHI_OFFSET);
+	}
+	*sec = ((u64_t)(sechi & XEMACPSIF_TSU_SECHI_MASK) << 32) | seclo;
+	*nsec = first;
+}
+
+static void xemacps_tsu_write(UINTPTR base, u64_t sec, u32_t nsec)
+{
+	/* No carry from the old nanoseconds into the new seconds */
+	XEmacPs_WriteReg(base, XEMACPS_1588_NANOSEC_OFFSET, 0);
+	XEmacPs_WriteReg(base, XEMACPS_1588_SECHI_OFFSET,
+		(u32_t)(sec >> 32) & XEMACPSIF_TSU_SECHI_MASK);
+	XEmacPs_WriteReg(base, XEMACPS_1588_SEC_OFFSET, (u32_t)sec);
+	XEmacPs_WriteReg(base, XEMACPS_1588_NANOSEC_OFFSET, nsec);
+}
+
+/* Starts the TSU at its nominal rate from the time of the system */
+void xemacps_tsu_init(xemacpsif_s *xemacpsif)
+{
+	UINTPTR base = xemacpsif->emacps.Config.BaseAddress;
+	struct timespec now;
+
+	xemacps_tsu_set_incr(base, XEMACPSIF_TSU_INCR);
+	clock_gettime(CLOCK_REALTIME, &now);
+	xemacps_tsu_write(base, (u64_t)now.tv_sec, (u32_t)now.tv_nsec);
+}
+
+/*
+ * Completes the timestamp words ts0 and ts1 of a descriptor with the upper
+ * seconds of the TSU, which has moved on by less than a minute since.
+ */
+void xemacps_tsu_stamp(xemacpsif_s *xemacpsif, u32_t ts0, u32_t ts1,
+		u32_t *sec, u32_t *nsec)
+{
+	u64_t now, stamp;
+	u32_t now_nsec;
+
+	xemacps_tsu_read(xemacpsif->emacps.Config.BaseAddress, &now, &now_nsec);
+	stamp = (now & ~(u64_t)XEMACPSIF_TS_SEC_MASK) |
+		((ts1 << 2) & XEMACPSIF_TS_SEC_MASK) | (ts0 >> 30);
+	if (stamp > now) {
+		stamp -= XEMACPSIF_TS_SEC_MASK + 1;
+	}
+	*sec = (u32_t)stamp;
+	*nsec = ts0 & XEMACPSIF_TS_NSEC_MASK;
+}
+
+static err_t xemacps_phc_gettime(struct netif *netif, struct timespec *ts)
+{
+	u64_t sec;
+	u32_t nsec;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	xemacps_tsu_read(xemacps_phc_base(netif), &sec, &nsec);
+	SYS_ARCH_UNPROTECT(lev);
+	ts->tv_sec = (time_t)sec;
+	ts->tv_nsec = (long)nsec;
+	return ERR_OK;
+}
+
+static err_t xemacps_phc_settime(struct netif *netif, const struct timespec *ts)
+{
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	SYS_ARCH_PROTECT(lev);
+	xemacps_tsu_write(xemacps_phc_base(netif), (u64_t)ts->tv_sec,
+		(u32_t)ts->tv_nsec);
+	SYS_ARCH_UNPROTECT(lev);
+	return ERR_OK;
+}
+
+static err_t xemacps_phc_adjtime(struct netif *netif, s64_t delta_ns)
+{
+	UINTPTR base = xemacps_phc_base(netif);
+	s64_t sec;
+	s32_t nsec;
+	u64_t now;
+	u32_t now_nsec;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	/* Steps below a second are applied by the TSU without stopping it */
+	if (delta_ns > -XEMACPSIF_NSEC_PER_SEC && delta_ns < XEMACPSIF_NSEC_PER_SEC) {
+		XEmacPs_WriteReg(base, XEMACPS_1588_ADJ_OFFSET, delta_ns < 0 ?
+			XEMACPSIF_TSU_ADJ_SUB | (u32_t)-delta_ns : (u32_t)delta_ns);
+		return ERR_OK;
+	}
+
+	SYS_ARCH_PROTECT(lev);
+	xemacps_tsu_read(base, &now, &now_nsec);
+	sec = (s64_t)now + delta_ns / XEMACPSIF_NSEC_PER_SEC;
+	nsec = (s32_t)now_nsec + (s32_t)(delta_ns % XEMACPSIF_NSEC_PER_SEC);
+	if (nsec < 0) {
+		nsec += XEMACPSIF_NSEC_PER_SEC;
+		sec--;
+	} else if (nsec >= XEMACPSIF_NSEC_PER_SEC) {
+		nsec -= XEMACPSIF_NSEC_PER_SEC;
+		sec++;
+	}
+	if (sec < 0) {
+		SYS_ARCH_UNPROTECT(lev);
+		return ERR_VAL;
+	}
+	xemacps_tsu_write(base, (u64_t)sec, (u32_t)nsec);
+	SYS_ARCH_UNPROTECT(lev);
+	return ERR_OK;
+}
+
+static err_t xemacps_phc_adjfreq(struct netif *netif, s32_t ppb)
+{
+	s64_t incr = (s64_t)XEMACPSIF_TSU_INCR;
+	SYS_ARCH_DECL_PROTECT(lev);
+
+	incr += incr * ppb / XEMACPSIF_NSEC_PER_SEC;
+	if (incr <= 0 || (incr >> 24) > XEMACPSIF_TSU_INCR_NS_MAX) {
+		return ERR_VAL;
+	}
+	SYS_ARCH_PROTECT(lev);
+	xemacps_tsu_set_incr(xemacps_phc_base(netif), (u64_t)incr);
+	SYS_ARCH_UNPROTECT(lev);
+	return ERR_OK;
+}
+
+const struct netif_phc xemacpsif_phc = {
+	xemacps_phc_gettime,
+	xemacps_phc_settime,
+	xemacps_phc_adjtime,
+	xemacps_phc_adjfreq
+};
+#endif
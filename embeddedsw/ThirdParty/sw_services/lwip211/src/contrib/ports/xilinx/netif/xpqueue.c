@@ -33,6 +33,109 @@
 #include "netif/xpqueue.h"
 #include "xil_printf.h"
 
+#ifdef __rtems__
+#include <rtems/rtems/cache.h>
+
+pq_queue_t *
+pq_create_queue_size(unsigned int size)
+{
+	pq_queue_t *q;
+
+	if (size == 0 || (size & (size - 1)) != 0)
+		return NULL;
+
+	q = rtems_cache_aligned_malloc(sizeof(*q) + size * sizeof(q->data[0]));
+	if (!q)
+		return q;
+
+	atomic_init(&q->head, 0);
+	atomic_init(&q->tail, 0);
+	q->mask = size - 1;
+	q->hwm = 0;
+	q->full = 0;
+
+	return q;
+}
+
+pq_queue_t *
+pq_create_queue()
+{
+	return pq_create_queue_size(PQ_QUEUE_SIZE);
+}
+
+void
+pq_delete_queue(pq_queue_t *q)
+{
+	free(q);
+}
+
+/* Called by the producer only */
+unsigned int
+pq_enqueue_bulk(pq_queue_t *q, void **p, unsigned int n)
+{
+	unsigned int head = atomic_load_explicit(&q->head, memory_order_relaxed);
+	unsigned int tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+	unsigned int space = q->mask + 1 - (head - tail);
+	unsigned int i;
+
+	if (n > space) {
+		q->full += n - space;
+		n = space;
+	}
+
+	for (i = 0; i < n; i++)
+		q->data[(head + i) & q->mask] = p[i];
+
+	/* publish the entries before the new head */
+	atomic_store_explicit(&q->head, head + n, memory_order_release);
+
+	if (head + n - tail > q->hwm)
+		q->hwm = head + n - tail;
+
+	return n;
+}
+
+/* Called by the consumer only */
+unsigned int
+pq_dequeue_bulk(pq_queue_t *q, void **p, unsigned int n)
+{
+	unsigned int tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+	unsigned int head = atomic_load_explicit(&q->head, memory_order_acquire);
+	unsigned int i;
+
+	if (n > head - tail)
+		n = head - tail;
+
+	for (i = 0; i < n; i++)
+		p[i] = q->data[(tail + i) & q->mask];
+
+	/* hand the slots back to the producer */
+	atomic_store_explicit(&q->tail, tail + n, memory_order_release);
+
+	return n;
+}
+
+int
+pq_enqueue(pq_queue_t *q, void *p)
+{
+	return pq_enqueue_bulk(q, &p, 1) == 1 ? 0 : -1;
+}
+
+void*
+pq_dequeue(pq_queue_t *q)
+{
+	void *p;
+
+	return pq_dequeue_bulk(q, &p, 1) == 1 ? p : NULL;
+}
+
+int
+pq_qlength(pq_queue_t *q)
+{
+	return atomic_load_explicit(&q->head, memory_order_acquire) -
+		atomic_load_explicit(&q->tail, memory_order_acquire);
+}
+#else
 #define NUM_QUEUES	2
 
 pq_queue_t pq_queue[NUM_QUEUES];
@@ -91,3 +194,4 @@ pq_qlength(pq_queue_t *q)
 {
 	return q->len;
 }
+#endif
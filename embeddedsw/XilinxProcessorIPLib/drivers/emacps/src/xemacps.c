@@ -103,6 +103,9 @@ LONG XEmacPs_CfgInitialize(XEmacPs *InstancePtr, XEmacPs_Config * CfgPtr,
 	InstancePtr->SendHandler = ((XEmacPs_Handler)((void*)XEmacPs_StubHandler));
 	InstancePtr->RecvHandler = ((XEmacPs_Handler)(void*)XEmacPs_StubHandler);
 	InstancePtr->ErrorHandler = ((XEmacPs_ErrHandler)(void*)XEmacPs_StubHandler);
+#ifdef __rtems__
+	InstancePtr->RecvQ1Handler = NULL;
+#endif
 
 	/* Reset the hardware and set default options */
 	InstancePtr->IsReady = XIL_COMPONENT_IS_READY;
@@ -203,6 +206,13 @@ void XEmacPs_Start(XEmacPs *InstancePtr)
 	/* Enable TX Q1 Interrupts */
 	if (InstancePtr->Version > 2)
 		XEmacPs_IntQ1Enable(InstancePtr, XEMACPS_INTQ1_IXR_ALL_MASK);
+#ifdef __rtems__
+	/* Enable RX Q1 Interrupts */
+	if ((InstancePtr->Version > 2) && (InstancePtr->RecvQ1Handler != NULL))
+		XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
+				   XEMACPS_INTQ1_IER_OFFSET,
+				   XEMACPS_INTQ1_IXR_RX_MASK);
+#endif
 
 	/* Mark as started */
 	InstancePtr->IsStarted = XIL_COMPONENT_IS_STARTED;
@@ -438,6 +438,9 @@ extern "C" {
 #define XEMACPS_HANDLER_DMASEND 1U
 #define XEMACPS_HANDLER_DMARECV 2U
 #define XEMACPS_HANDLER_ERROR   3U
+#ifdef __rtems__
+#define XEMACPS_HANDLER_DMARECVQ1 4U
+#endif
 /*@}*/
 
 /* Constants to determine the configuration of the hardware device. They are
@@ -545,6 +548,11 @@ typedef struct XEmacPs_Instance {
 
 	XEmacPs_ErrHandler ErrorHandler;
 	void *ErrorRef;
+#ifdef __rtems__
+	/* Receive queue 1 is only serviced with a handler installed */
+	XEmacPs_Handler RecvQ1Handler;
+	void *RecvQ1Ref;
+#endif
 	u32 Version;
 	u32 RxBufMask;
 	u32 MaxMtuSize;
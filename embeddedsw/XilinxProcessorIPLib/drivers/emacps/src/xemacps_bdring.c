@@ -173,8 +173,24 @@ static void XEmacPs_BdSetTxWrap(UINTPTR BdPtr);
  * @note
  * Make sure to pass in the right alignment value.
  *****************************************************************************/
+#ifdef __rtems__
 LONG XEmacPs_BdRingCreate(XEmacPs_BdRing * RingPtr, UINTPTR PhysAddr,
 			  UINTPTR VirtAddr, u32 Alignment, u32 BdCount)
+{
+	return XEmacPs_BdRingCreateExt(RingPtr, PhysAddr, VirtAddr, Alignment,
+			  BdCount, (u32)sizeof(XEmacPs_Bd));
+}
+
+/*
+ * Like XEmacPs_BdRingCreate() for descriptors of BdSize bytes, such as the
+ * extended descriptors that carry a timestamp after the words of XEmacPs_Bd.
+ */
+LONG XEmacPs_BdRingCreateExt(XEmacPs_BdRing * RingPtr, UINTPTR PhysAddr,
+			  UINTPTR VirtAddr, u32 Alignment, u32 BdCount, u32 BdSize)
+#else
+LONG XEmacPs_BdRingCreate(XEmacPs_BdRing * RingPtr, UINTPTR PhysAddr,
+			  UINTPTR VirtAddr, u32 Alignment, u32 BdCount)
+#endif
 {
 	u32 i;
 	UINTPTR BdVirtAddr;
@@ -212,7 +228,11 @@ LONG XEmacPs_BdRingCreate(XEmacPs_BdRing * RingPtr, UINTPTR PhysAddr,
 	}
 
 	/* Figure out how many bytes will be between the start of adjacent BDs */
+#ifdef __rtems__
+	RingPtr->Separation = BdSize;
+#else
 	RingPtr->Separation = ((u32)sizeof(XEmacPs_Bd));
+#endif
 
 	/* Must make sure the ring doesn't span address 0x00000000. If it does,
 	 * then the next/prev BD traversal macros will fail.
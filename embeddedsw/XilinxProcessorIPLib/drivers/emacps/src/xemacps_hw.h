@@ -252,6 +252,12 @@ typedef enum { MDC_DIV_8 = 0U, MDC_DIV_16, MDC_DIV_32, MDC_DIV_48,
 #define XEMACPS_LAST_OFFSET          0x000001B4U /**< Last statistic counter
 						      offset, for clearing */
 
+#ifdef __rtems__
+#define XEMACPS_1588_SUBNS_INC_OFFSET 0x000001BCU /**< 1588 sub-nanosecond
+						      increment */
+#define XEMACPS_1588_SECHI_OFFSET    0x000001C0U /**< 1588 second counter,
+						      bits 47:32 */
+#endif
 #define XEMACPS_1588_SEC_OFFSET      0x000001D0U /**< 1588 second counter */
 #define XEMACPS_1588_NANOSEC_OFFSET  0x000001D4U /**< 1588 nanosecond counter */
 #define XEMACPS_1588_ADJ_OFFSET      0x000001D8U /**< 1588 nanosecond
@@ -281,8 +287,18 @@ typedef enum { MDC_DIV_8 = 0U, MDC_DIV_16, MDC_DIV_32, MDC_DIV_48,
 							reg */
 #define XEMACPS_RXQ1BASE_OFFSET	     0x00000480U /**< RX Q1 Base address
 							reg */
+#ifdef __rtems__
+#define XEMACPS_RXBUFQ1SIZE_OFFSET   0x000004A0U /**< RX Q1 Buffer size
+							reg */
+#endif
 #define XEMACPS_MSBBUF_TXQBASE_OFFSET  0x000004C8U /**< MSB Buffer TX Q Base
 							reg */
+#ifdef __rtems__
+#define XEMACPS_TXBDCTRL_OFFSET      0x000004CCU /**< TX extended descriptor
+							control reg */
+#define XEMACPS_RXBDCTRL_OFFSET      0x000004D0U /**< RX extended descriptor
+							control reg */
+#endif
 #define XEMACPS_MSBBUF_RXQBASE_OFFSET  0x000004D4U /**< MSB Buffer RX Q Base
 							reg */
 #define XEMACPS_INTQ1_IER_OFFSET     0x00000600U /**< Interrupt Q1 Enable
@@ -401,6 +417,15 @@ typedef enum { MDC_DIV_8 = 0U, MDC_DIV_16, MDC_DIV_32, MDC_DIV_48,
 #define XEMACPS_DMACR_INCR16_AHB_BURST	0x00000010U /**< 16 bytes AHB bursts */
 /*@}*/
 
+#ifdef __rtems__
+/** @name extended descriptor control register bit definitions
+ * @{
+ */
+#define XEMACPS_BDCTRL_TSMODE_MASK		0x00000030U /**< Frames to timestamp, bits 5:4 */
+#define XEMACPS_BDCTRL_TSMODE_ALL		0x00000030U /**< Timestamp all frames */
+/*@}*/
+#endif
+
 /** @name transmit status register bit definitions
  * @{
  */
@@ -448,6 +473,13 @@ typedef enum { MDC_DIV_8 = 0U, MDC_DIV_16, MDC_DIV_32, MDC_DIV_48,
 
 #define XEMACPS_INTQ1_IXR_ALL_MASK	((u32)XEMACPS_INTQ1SR_TXCOMPL_MASK | \
 					 (u32)XEMACPS_INTQ1SR_TXERR_MASK)
+#ifdef __rtems__
+#define XEMACPS_INTQ1SR_RXCOMPL_MASK	0x00000002U /**< Frame received OK */
+#define XEMACPS_INTQ1SR_RXUSED_MASK	0x00000004U /**< Rx used bit read */
+
+#define XEMACPS_INTQ1_IXR_RX_MASK	((u32)XEMACPS_INTQ1SR_RXCOMPL_MASK | \
+					 (u32)XEMACPS_INTQ1SR_RXUSED_MASK)
+#endif
 
 /*@}*/
 
@@ -100,6 +100,13 @@ LONG XEmacPs_SetHandler(XEmacPs *InstancePtr, u32 HandlerType,
 		InstancePtr->ErrorHandler = ((XEmacPs_ErrHandler)(void *)FuncPointer);
 		InstancePtr->ErrorRef = CallBackRef;
 		break;
+#ifdef __rtems__
+	case XEMACPS_HANDLER_DMARECVQ1:
+		Status = (LONG)(XST_SUCCESS);
+		InstancePtr->RecvQ1Handler = ((XEmacPs_Handler)(void *)FuncPointer);
+		InstancePtr->RecvQ1Ref = CallBackRef;
+		break;
+#endif
 	default:
 		Status = (LONG)(XST_INVALID_PARAM);
 		break;
@@ -174,6 +181,17 @@ void XEmacPs_IntrHandler(void *XEmacPsPtr)
 		InstancePtr->SendHandler(InstancePtr->SendRef);
 	}
 
+#ifdef __rtems__
+	/* Receive Q1 complete or buffer not available interrupt */
+	if ((InstancePtr->Version > 2) && (InstancePtr->RecvQ1Handler != NULL) &&
+			((RegQ1ISR & XEMACPS_INTQ1_IXR_RX_MASK) != 0x00000000U)) {
+		XEmacPs_WriteReg(InstancePtr->Config.BaseAddress,
+				   XEMACPS_INTQ1_STS_OFFSET,
+				   RegQ1ISR & XEMACPS_INTQ1_IXR_RX_MASK);
+		InstancePtr->RecvQ1Handler(InstancePtr->RecvQ1Ref);
+	}
+#endif
+
 	/* Transmit complete interrupt */
 	if ((RegISR & XEMACPS_IXR_TXCOMPL_MASK) != 0x00000000U) {
 		/* Clear TX status register TX complete indication but preserve
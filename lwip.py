@@ -25,10 +25,32 @@
 #  (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 #  OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-from rtems_waf import rtems
 import json
 import os
 
+# Compiler and linker flags for each build profile. The profile is selected
+# per BSP by BUILD_PROFILE in config.ini or --lwip-build-profile.
+build_profiles = {
+    'debug': {
+        'cflags': ['-g', '-Wall', '-O0'],
+        'linkflags': [],
+    },
+    'release': {
+        'cflags': ['-g', '-Wall', '-O2'],
+        'linkflags': [],
+    },
+    'size': {
+        'cflags': ['-g', '-Wall', '-Os'],
+        'linkflags': [],
+    },
+    'lto': {
+        # Fat objects keep liblwip.a usable by applications linked without LTO
+        'cflags': ['-g', '-Wall', '-O2', '-flto', '-ffat-lto-objects'],
+        'linkflags': ['-O2', '-flto'],
+    },
+}
+default_build_profile = 'debug'
+
 
 def removeprefix(data, prefix):
     if data.startswith(prefix):
@@ -37,6 +59,10 @@ def removeprefix(data, prefix):
 
 
 def build(bld):
+    # Imported here so the host build in rtemslwip/posix can use the build
+    # profiles without the rtems_waf submodule
+    from rtems_waf import rtems
+
     source_files = []
     driver_source = []
     drv_incl = []
@@ -44,6 +70,9 @@ def build(bld):
                                             bld.env.RTEMS_ARCH_BSP)
     arch = rtems.arch(bld.env.RTEMS_ARCH_BSP)
     bsp = rtems.bsp(bld.env.RTEMS_ARCH_BSP)
+    profile = bld.env.LWIP_BUILD_PROFILE or default_build_profile
+    cflags = build_profiles[profile]['cflags']
+    linkflags = build_profiles[profile]['linkflags']
 
     # file-import.json is kept separate from the rest of the defs because it
     # describes which files are imported from upstream lwip
@@ -87,7 +116,7 @@ def build(bld):
 
     bld(features='c',
         target='lwip_obj',
-        cflags='-g -Wall -O0',
+        cflags=cflags,
         includes=' '.join(lwip_obj_incl),
         source=source_files,
         )
@@ -98,13 +127,13 @@ def build(bld):
 
     bld(features='c',
         target='driver_obj',
-        cflags='-g -Wall -O0',
+        cflags=cflags,
         includes=' '.join(drv_obj_incl),
         source=driver_source,
         )
     bld(features='c cstlib',
         target='lwip',
-        cflags='-g -Wall -O0',
+        cflags=cflags,
         use=['lwip_obj', 'driver_obj'])
     bld.install_files("${PREFIX}/" + arch_lib_path, ["liblwip.a"])
 
@@ -124,6 +153,11 @@ def build(bld):
     [install_headers(path) for path in common_includes]
     [install_headers(path) for path in drv_incl]
 
+    # Lets tests of BSP specific drivers build as no-ops on other BSPs
+    bsp_defines = []
+    if bsp.startswith('xilinx_zynqmp'):
+        bsp_defines.append('LWIP_BSP_XILINX_ZYNQMP')
+
     test_app_incl = []
     test_app_incl.extend(drv_incl)
     test_app_incl.extend(common_includes)
@@ -131,7 +165,77 @@ def build(bld):
     bld.program(features='c',
                 target='networking01.exe',
                 source='rtemslwip/test/networking01/sample_app.c',
-                cflags='-g -Wall -O0',
+                cflags=cflags,
+                linkflags=linkflags,
+                use='lwip',
+                lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
+                includes=' '.join(test_app_incl))
+
+    bld.program(features='c',
+                target='benchmark01.exe',
+                source='rtemslwip/test/benchmark01/init.c',
+                cflags=cflags,
+                linkflags=linkflags,
+                defines=['LWIP_BUILD_PROFILE="' + profile + '"'],
+                use='lwip',
+                lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
+                includes=' '.join(test_app_incl))
+
+    bld.program(features='c',
+                target='sockscale01.exe',
+                source='rtemslwip/test/sockscale01/init.c',
+                cflags=cflags,
+                linkflags=linkflags,
+                defines=['LWIP_BUILD_PROFILE="' + profile + '"'],
+                use='lwip',
+                lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
+                includes=' '.join(test_app_incl))
+
+    bld.program(features='c',
+                target='iperf01.exe',
+                source='rtemslwip/test/iperf01/init.c',
+                cflags=cflags,
+                linkflags=linkflags,
+                use='lwip',
+                lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
+                includes=' '.join(test_app_incl))
+
+    bld.program(features='c',
+                target='rxbench01.exe',
+                source='rtemslwip/test/rxbench01/init.c',
+                cflags=cflags,
+                linkflags=linkflags,
+                defines=['LWIP_BUILD_PROFILE="' + profile + '"'],
+                use='lwip',
+                lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
+                includes=' '.join(test_app_incl))
+
+    bld.program(features='c',
+                target='multigem01.exe',
+                source='rtemslwip/test/multigem01/init.c',
+                cflags=cflags,
+                linkflags=linkflags,
+                defines=bsp_defines,
+                use='lwip',
+                lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
+                includes=' '.join(test_app_incl))
+
+    bld.program(features='c',
+                target='netem01.exe',
+                source=['rtemslwip/test/netem01/init.c',
+                        'rtemslwip/test/netem01/netem_suite.c'],
+                cflags=cflags,
+                linkflags=linkflags,
+                use='lwip',
+                lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
+                includes=' '.join(test_app_incl))
+
+    bld.program(features='c',
+                target='hwtstamp01.exe',
+                source=['rtemslwip/test/hwtstamp01/init.c',
+                        'rtemslwip/test/hwtstamp01/hwtstamp_suite.c'],
+                cflags=cflags,
+                linkflags=linkflags,
                 use='lwip',
                 lib=['rtemscpu', 'rtemsbsp', 'rtemstest', 'lwip'],
                 includes=' '.join(test_app_incl))
@@ -146,7 +250,8 @@ def build(bld):
                 target='telnetd01.exe',
                 source='rtemslwip/test/telnetd01/init.c',
                 use='telnetd lwip rtemstest ftpd',
-                cflags='-g -Wall -O0',
+                cflags=cflags,
+                linkflags=linkflags,
                 includes=' '.join(test_app_incl))
 
 
@@ -161,3 +266,14 @@ def bsp_configure(conf, arch_bsp):
     section_flags = ["-fdata-sections", "-ffunction-sections"]
     add_flags(conf.env.CFLAGS, section_flags)
     add_flags(conf.env.CXXFLAGS, section_flags)
+    profile = conf.env.LWIP_BUILD_PROFILE or default_build_profile
+    if profile == 'lto':
+        # The archive index of LTO objects needs the linker plugin
+        cc = conf.env.CC[0] if isinstance(conf.env.CC, list) else conf.env.CC
+        if cc.endswith('gcc'):
+            gcc_ar = conf.find_program(os.path.basename(cc) + '-ar',
+                                       path_list=[os.path.dirname(cc)],
+                                       var='GCC_AR',
+                                       mandatory=False)
+            if gcc_ar:
+                conf.env.AR = conf.env.GCC_AR
@@ -188,6 +188,15 @@ recv_raw(void *arg, struct raw_pcb *pcb, struct pbuf *p,
       buf->ptr = q;
       ip_addr_copy(buf->addr, *ip_current_src_addr());
       buf->port = pcb->protocol;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_NETBUF_RECVINFO
+      /* The netbuf may still hold the flags of an earlier datagram */
+      buf->flags = 0;
+#endif /* __rtems__ && LWIP_NETBUF_RECVINFO */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+      /* The copy keeps the time of reception */
+      q->tstamp_sec = p->tstamp_sec;
+      q->tstamp_nsec = p->tstamp_nsec;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 
       len = q->tot_len;
       if (sys_mbox_trypost(&conn->recvmbox, buf) != ERR_OK) {
@@ -262,6 +271,10 @@ recv_udp(void *arg, struct udp_pcb *pcb, struct pbuf *p,
     ip_addr_set(&buf->addr, addr);
     buf->port = port;
 #if LWIP_NETBUF_RECVINFO
+#if defined(__rtems__) || defined(LWIP_HOST_BUILD)
+    /* The netbuf may still hold the flags of an earlier datagram */
+    buf->flags = 0;
+#endif /* __rtems__ */
     if (conn->flags & NETCONN_FLAG_PKTINFO) {
       /* get the UDP header - always in the first pbuf, ensured by udp_input */
       const struct udp_hdr *udphdr = (const struct udp_hdr *)ip_next_header_ptr();
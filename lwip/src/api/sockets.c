@@ -64,6 +64,15 @@
 
 #include <string.h>
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+#include <netif_hwtstamp.h>
+
+/* SO_TIMESTAMPING flags that are accepted */
+#define SOF_TIMESTAMPING_SUPPORTED (SOF_TIMESTAMPING_TX_HARDWARE | \
+  SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE | \
+  SOF_TIMESTAMPING_OPT_TSONLY)
+#endif /* __rtems__ && LWIP_HWTSTAMP */
+
 #ifdef LWIP_HOOK_FILENAME
 #include LWIP_HOOK_FILENAME
 #endif
@@ -530,6 +539,9 @@ alloc_socket(struct netconn *newconn, int accepted)
       sockets[i].sendevent  = (NETCONNTYPE_GROUP(newconn->type) == NETCONN_TCP ? (accepted != 0) : 1);
       sockets[i].errevent   = 0;
 #endif /* LWIP_SOCKET_SELECT || LWIP_SOCKET_POLL */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+      sockets[i].tstamp_flags = 0;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
       return i + LWIP_SOCKET_OFFSET;
     }
     SYS_ARCH_UNPROTECT(lev);
@@ -803,6 +815,9 @@ lwip_close(int s)
     return -1;
   }
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  netif_hwtstamp_tx_release(s);
+#endif /* __rtems__ && LWIP_HWTSTAMP */
   free_socket(sock, is_tcp);
   set_errno(0);
   return 0;
@@ -1155,6 +1170,9 @@ lwip_recvfrom_udp_raw(struct lwip_sock *sock, int flags, struct msghdr *msg, u16
 
   if (msg->msg_control) {
     u8_t wrote_msg = 0;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+    socklen_t controllen = msg->msg_controllen;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 #if LWIP_NETBUF_RECVINFO
     /* Check if packet info was recorded */
     if (buf->flags & NETBUF_FLAG_DESTADDR) {
@@ -1177,6 +1195,27 @@ lwip_recvfrom_udp_raw(struct lwip_sock *sock, int flags, struct msghdr *msg, u16
       }
     }
 #endif /* LWIP_NETBUF_RECVINFO */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+    /* The hardware time of reception follows any packet info */
+    if ((sock->tstamp_flags & SOF_TIMESTAMPING_RX_HARDWARE) &&
+        (buf->p->tstamp_sec != 0 || buf->p->tstamp_nsec != 0)) {
+      socklen_t used = wrote_msg ? msg->msg_controllen : 0;
+      if (controllen - used >= CMSG_SPACE(sizeof(struct scm_timestamping))) {
+        struct cmsghdr *chdr = (struct cmsghdr *)((u8_t *)msg->msg_control + used);
+        struct scm_timestamping *tss = (struct scm_timestamping *)CMSG_DATA(chdr);
+        chdr->cmsg_level = SOL_SOCKET;
+        chdr->cmsg_type = SCM_TIMESTAMPING;
+        chdr->cmsg_len = CMSG_LEN(sizeof(struct scm_timestamping));
+        memset(tss, 0, sizeof(*tss));
+        tss->ts[2].tv_sec = buf->p->tstamp_sec;
+        tss->ts[2].tv_nsec = buf->p->tstamp_nsec;
+        msg->msg_controllen = used + CMSG_SPACE(sizeof(struct scm_timestamping));
+        wrote_msg = 1;
+      } else {
+        msg->msg_flags |= MSG_CTRUNC;
+      }
+    }
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 
     if (!wrote_msg) {
       msg->msg_controllen = 0;
@@ -1276,6 +1315,44 @@ lwip_recv(int s, void *mem, size_t len, int flags)
   return lwip_recvfrom(s, mem, len, flags, NULL, NULL);
 }
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+/* Returns the oldest transmit timestamp of socket s as an SCM_TIMESTAMPING
+ * message without data, the socket's error queue only ever holds those. */
+static ssize_t
+lwip_recvmsg_errqueue(struct lwip_sock *sock, int s, struct msghdr *msg)
+{
+  struct timespec ts;
+
+  if (!netif_hwtstamp_tx_take(s, &ts)) {
+    sock_set_errno(sock, EAGAIN);
+    done_socket(sock);
+    return -1;
+  }
+
+  msg->msg_flags = 0;
+  if (msg->msg_name != NULL) {
+    msg->msg_namelen = 0;
+  }
+  if (msg->msg_control != NULL &&
+      msg->msg_controllen >= CMSG_SPACE(sizeof(struct scm_timestamping))) {
+    struct cmsghdr *chdr = CMSG_FIRSTHDR(msg);
+    struct scm_timestamping *tss = (struct scm_timestamping *)CMSG_DATA(chdr);
+    chdr->cmsg_level = SOL_SOCKET;
+    chdr->cmsg_type = SCM_TIMESTAMPING;
+    chdr->cmsg_len = CMSG_LEN(sizeof(struct scm_timestamping));
+    memset(tss, 0, sizeof(*tss));
+    tss->ts[2] = ts;
+    msg->msg_controllen = CMSG_SPACE(sizeof(struct scm_timestamping));
+  } else {
+    msg->msg_controllen = 0;
+    msg->msg_flags |= MSG_CTRUNC;
+  }
+  sock_set_errno(sock, 0);
+  done_socket(sock);
+  return 0;
+}
+#endif /* __rtems__ && LWIP_HWTSTAMP */
+
 ssize_t
 lwip_recvmsg(int s, struct msghdr *message, int flags)
 {
@@ -1285,8 +1362,13 @@ lwip_recvmsg(int s, struct msghdr *message, int flags)
 
   LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_recvmsg(%d, message=%p, flags=0x%x)\n", s, (void *)message, flags));
   LWIP_ERROR("lwip_recvmsg: invalid message pointer", message != NULL, return ERR_ARG;);
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  LWIP_ERROR("lwip_recvmsg: unsupported flags", (flags & ~(MSG_PEEK|MSG_DONTWAIT|MSG_ERRQUEUE)) == 0,
+             set_errno(EOPNOTSUPP); return -1;);
+#else /* __rtems__ && LWIP_HWTSTAMP */
   LWIP_ERROR("lwip_recvmsg: unsupported flags", (flags & ~(MSG_PEEK|MSG_DONTWAIT)) == 0,
              set_errno(EOPNOTSUPP); return -1;);
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 
   if ((message->msg_iovlen <= 0) || (message->msg_iovlen > IOV_MAX)) {
     set_errno(EMSGSIZE);
@@ -1298,6 +1380,12 @@ lwip_recvmsg(int s, struct msghdr *message, int flags)
     return -1;
   }
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  if (flags & MSG_ERRQUEUE) {
+    return lwip_recvmsg_errqueue(sock, s, message);
+  }
+#endif /* __rtems__ && LWIP_HWTSTAMP */
+
   /* check for valid vectors */
   buflen = 0;
   for (i = 0; i < message->msg_iovlen; i++) {
@@ -1557,6 +1645,11 @@ lwip_sendmsg(int s, const struct msghdr *msg, int flags)
       }
 #endif /* LWIP_IPV4 && LWIP_IPV6 */
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+      if ((sock->tstamp_flags & SOF_TIMESTAMPING_TX_HARDWARE) && chain_buf.p != NULL) {
+        chain_buf.p->tstamp_id = netif_hwtstamp_tx_request(s);
+      }
+#endif /* __rtems__ && LWIP_HWTSTAMP */
       /* send the data */
       err = netconn_send(sock->conn, &chain_buf);
     }
@@ -1668,6 +1761,11 @@ lwip_sendto(int s, const void *data, size_t size, int flags,
     }
 #endif /* LWIP_IPV4 && LWIP_IPV6 */
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+    if (sock->tstamp_flags & SOF_TIMESTAMPING_TX_HARDWARE) {
+      buf.p->tstamp_id = netif_hwtstamp_tx_request(s);
+    }
+#endif /* __rtems__ && LWIP_HWTSTAMP */
     /* send the data */
     err = netconn_send(sock->conn, &buf);
   }
@@ -3016,6 +3114,16 @@ lwip_getsockopt_impl(int s, int level, int optname, void *optval, socklen_t *opt
           *(int *)optval = udp_is_flag_set(sock->conn->pcb.udp, UDP_FLAGS_NOCHKSUM) ? 1 : 0;
           break;
 #endif /* LWIP_UDP*/
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+        case SO_TIMESTAMPING:
+          LWIP_SOCKOPT_CHECK_OPTLEN_CONN(sock, *optlen, int);
+          if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+            done_socket(sock);
+            return ENOPROTOOPT;
+          }
+          *(int *)optval = sock->tstamp_flags;
+          break;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
         default:
           LWIP_DEBUGF(SOCKETS_DEBUG, ("lwip_getsockopt(%d, SOL_SOCKET, UNIMPL: optname=0x%x, ..)\n",
                                       s, optname));
@@ -3424,6 +3532,21 @@ lwip_setsockopt_impl(int s, int level, int optname, const void *optval, socklen_
           }
           break;
 #endif /* LWIP_UDP */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+        case SO_TIMESTAMPING:
+          LWIP_SOCKOPT_CHECK_OPTLEN_CONN(sock, optlen, int);
+          /* Segments of a TCP stream are not stamped */
+          if (NETCONNTYPE_GROUP(netconn_type(sock->conn)) == NETCONN_TCP) {
+            done_socket(sock);
+            return ENOPROTOOPT;
+          }
+          if ((*(const int *)optval & ~SOF_TIMESTAMPING_SUPPORTED) != 0) {
+            done_socket(sock);
+            return EINVAL;
+          }
+          sock->tstamp_flags = (u16_t)*(const int *)optval;
+          break;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
         case SO_BINDTODEVICE: {
           const struct ifreq *iface;
           struct netif *n = NULL;
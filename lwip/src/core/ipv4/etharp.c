@@ -57,6 +57,10 @@
 
 #include <string.h>
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+#include <netif_gso.h>
+#endif /* __rtems__ && LWIP_GSO */
+
 #ifdef LWIP_HOOK_FILENAME
 #include LWIP_HOOK_FILENAME
 #endif
@@ -1010,6 +1014,11 @@ etharp_query(struct netif *netif, const ip4_addr_t *ipaddr, struct pbuf *q)
     /* entry is still pending, queue the given packet 'q' */
     struct pbuf *p;
     int copy_needed = 0;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+    /* Only the first segment of a GSO packet waits for the address, TCP
+     * retransmits the others */
+    netif_gso_truncate(q);
+#endif /* __rtems__ && LWIP_GSO */
     /* IF q includes a pbuf that must be copied, copy the whole chain into a
      * new PBUF_RAM. See the definition of PBUF_NEEDS_COPY for details. */
     p = q;
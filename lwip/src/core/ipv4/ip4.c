@@ -59,6 +59,10 @@
 
 #include <string.h>
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+#include <netif_gso.h>
+#endif /* __rtems__ && LWIP_GSO */
+
 #ifdef LWIP_HOOK_FILENAME
 #include LWIP_HOOK_FILENAME
 #endif
@@ -496,7 +500,11 @@ ip4_input(struct pbuf *p, struct netif *inp)
 
   /* verify checksum */
 #if CHECKSUM_CHECK_IP
+#ifdef __rtems__
+  IF__NETIF_CHECKSUM_ENABLED_RX(inp, p, NETIF_CHECKSUM_CHECK_IP) {
+#else /* __rtems__ */
   IF__NETIF_CHECKSUM_ENABLED(inp, NETIF_CHECKSUM_CHECK_IP) {
+#endif /* __rtems__ */
     if (inet_chksum(iphdr, iphdr_hlen) != 0) {
 
       LWIP_DEBUGF(IP_DEBUG | LWIP_DBG_LEVEL_SERIOUS,
@@ -932,6 +940,12 @@ ip4_output_if_opt_src(struct pbuf *p, const ip4_addr_t *src, const ip4_addr_t *d
     chk_sum += iphdr->_id;
 #endif /* CHECKSUM_GEN_IP_INLINE */
     ++ip_id;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+    if ((p->flags & PBUF_FLAG_GSO) != 0) {
+      /* netif_gso_output() numbers the other segments from this one on */
+      ip_id = (u16_t)(ip_id + netif_gso_count(p) - 1);
+    }
+#endif /* __rtems__ && LWIP_GSO */
 
     if (src == NULL) {
       ip4_addr_copy(iphdr->src, *IP4_ADDR_ANY4);
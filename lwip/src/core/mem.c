@@ -338,6 +338,222 @@ mem_free(void *rmem)
   memp_free(hmem->poolnr, hmem);
 }
 
+#elif MEM_TLSF
+/* lwIP heap implemented with a two-level segregated fit allocator */
+
+#include <tlsf.h>
+
+/** With MEM_OVERFLOW_CHECK, the user size is kept in front of the guard */
+#if MEM_OVERFLOW_CHECK
+struct mem_tlsf_hdr {
+  mem_size_t user_size;
+};
+#define MEM_TLSF_HDR LWIP_MEM_ALIGN_SIZE(sizeof(struct mem_tlsf_hdr))
+#else
+#define MEM_TLSF_HDR 0
+#endif
+
+#define MEM_SIZE_ALIGNED     LWIP_MEM_ALIGN_SIZE(MEM_SIZE)
+#define MEM_TLSF_POOL_SIZE   (MEM_SIZE_ALIGNED + TLSF_POOL_OVERHEAD(MEM_ALIGNMENT))
+
+#ifndef LWIP_RAM_HEAP_POINTER
+LWIP_DECLARE_MEMORY_ALIGNED(ram_heap, MEM_TLSF_POOL_SIZE);
+#define LWIP_RAM_HEAP_POINTER ram_heap
+#endif /* LWIP_RAM_HEAP_POINTER */
+
+static struct tlsf mem_tlsf;
+
+#if LWIP_ALLOW_MEM_FREE_FROM_OTHER_CONTEXT
+/* Allocation and free take bounded time, so both may run with the
+ * lightweight protection held, which also allows freeing from interrupts */
+#define LWIP_MEM_TLSF_DECL_PROTECT() SYS_ARCH_DECL_PROTECT(lev)
+#define LWIP_MEM_TLSF_PROTECT()      SYS_ARCH_PROTECT(lev)
+#define LWIP_MEM_TLSF_UNPROTECT()    SYS_ARCH_UNPROTECT(lev)
+#else /* LWIP_ALLOW_MEM_FREE_FROM_OTHER_CONTEXT */
+static sys_mutex_t mem_mutex;
+#define LWIP_MEM_TLSF_DECL_PROTECT()
+#define LWIP_MEM_TLSF_PROTECT()      sys_mutex_lock(&mem_mutex)
+#define LWIP_MEM_TLSF_UNPROTECT()    sys_mutex_unlock(&mem_mutex)
+#endif /* LWIP_ALLOW_MEM_FREE_FROM_OTHER_CONTEXT */
+
+#if MEM_OVERFLOW_CHECK
+static void
+mem_tlsf_check_element(void *ptr, size_t size, void *arg)
+{
+  struct mem_tlsf_hdr *hdr = (struct mem_tlsf_hdr *)ptr;
+  LWIP_UNUSED_ARG(size);
+  LWIP_UNUSED_ARG(arg);
+  mem_overflow_check_raw((u8_t *)ptr + MEM_TLSF_HDR + MEM_SANITY_OFFSET,
+                         hdr->user_size, "heap", "");
+}
+
+static void
+mem_tlsf_init_element(void *ptr, mem_size_t user_size)
+{
+  struct mem_tlsf_hdr *hdr = (struct mem_tlsf_hdr *)ptr;
+  hdr->user_size = user_size;
+  mem_overflow_init_raw((u8_t *)ptr + MEM_TLSF_HDR + MEM_SANITY_OFFSET,
+                        user_size);
+}
+#else /* MEM_OVERFLOW_CHECK */
+#define mem_tlsf_check_element(ptr, size, arg)
+#define mem_tlsf_init_element(ptr, user_size)
+#endif /* MEM_OVERFLOW_CHECK */
+
+#if MEM_OVERFLOW_CHECK >= 2
+#define MEM_TLSF_CHECK_ALL() tlsf_walk_used(&mem_tlsf, mem_tlsf_check_element, NULL)
+#else
+#define MEM_TLSF_CHECK_ALL()
+#endif
+
+/**
+ * Initialize the heap as a single free block
+ */
+void
+mem_init(void)
+{
+  tlsf_init(&mem_tlsf, LWIP_MEM_ALIGN(LWIP_RAM_HEAP_POINTER),
+            MEM_TLSF_POOL_SIZE, MEM_ALIGNMENT);
+
+  MEM_STATS_AVAIL(avail, MEM_SIZE_ALIGNED);
+
+#if !LWIP_ALLOW_MEM_FREE_FROM_OTHER_CONTEXT
+  if (sys_mutex_new(&mem_mutex) != ERR_OK) {
+    LWIP_ASSERT("failed to create mem_mutex", 0);
+  }
+#endif
+}
+
+/**
+ * Allocate a block of memory with a minimum of 'size' bytes.
+ *
+ * @param size_in is the minimum size of the requested block in bytes.
+ * @return pointer to allocated memory or NULL if no free memory was found.
+ *
+ * Note that the returned value will always be aligned (as defined by MEM_ALIGNMENT).
+ */
+void *
+mem_malloc(mem_size_t size_in)
+{
+  u8_t *mem;
+  LWIP_MEM_TLSF_DECL_PROTECT();
+
+  if (size_in == 0) {
+    return NULL;
+  }
+
+  LWIP_MEM_TLSF_PROTECT();
+  MEM_TLSF_CHECK_ALL();
+  mem = (u8_t *)tlsf_malloc(&mem_tlsf,
+                            (size_t)size_in + MEM_TLSF_HDR + MEM_SANITY_OVERHEAD);
+  if (mem != NULL) {
+    MEM_STATS_INC_USED(used, (mem_size_t)tlsf_block_size(&mem_tlsf, mem));
+  } else {
+    MEM_STATS_INC(err);
+  }
+  LWIP_MEM_TLSF_UNPROTECT();
+
+  if (mem == NULL) {
+    LWIP_DEBUGF(MEM_DEBUG | LWIP_DBG_LEVEL_SERIOUS, ("mem_malloc: could not allocate %"S16_F" bytes\n", (s16_t)size_in));
+    return NULL;
+  }
+
+  mem_tlsf_init_element(mem, size_in);
+  LWIP_ASSERT("mem_malloc: allocated memory properly aligned.",
+              ((mem_ptr_t)mem + MEM_TLSF_HDR + MEM_SANITY_OFFSET) % MEM_ALIGNMENT == 0);
+  return mem + MEM_TLSF_HDR + MEM_SANITY_OFFSET;
+}
+
+/**
+ * Put a struct mem back on the heap
+ *
+ * @param rmem is the data portion of a struct mem as returned by a previous
+ *             call to mem_malloc()
+ */
+void
+mem_free(void *rmem)
+{
+  u8_t *mem;
+  LWIP_MEM_TLSF_DECL_PROTECT();
+
+  if (rmem == NULL) {
+    LWIP_DEBUGF(MEM_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_LEVEL_SERIOUS, ("mem_free(p == NULL) was called.\n"));
+    return;
+  }
+  if ((((mem_ptr_t)rmem) & (MEM_ALIGNMENT - 1)) != 0) {
+    LWIP_MEM_ILLEGAL_FREE("mem_free: sanity check alignment");
+    LWIP_DEBUGF(MEM_DEBUG | LWIP_DBG_LEVEL_SEVERE, ("mem_free: sanity check alignment\n"));
+    /* protect mem stats from concurrent access */
+    MEM_STATS_INC_LOCKED(illegal);
+    return;
+  }
+
+  mem = (u8_t *)rmem - MEM_TLSF_HDR - MEM_SANITY_OFFSET;
+  if (!tlsf_contains(&mem_tlsf, mem)) {
+    LWIP_MEM_ILLEGAL_FREE("mem_free: illegal memory");
+    LWIP_DEBUGF(MEM_DEBUG | LWIP_DBG_LEVEL_SEVERE, ("mem_free: illegal memory\n"));
+    /* protect mem stats from concurrent access */
+    MEM_STATS_INC_LOCKED(illegal);
+    return;
+  }
+
+  mem_tlsf_check_element(mem, 0, NULL);
+
+  LWIP_MEM_TLSF_PROTECT();
+  MEM_STATS_DEC_USED(used, (mem_size_t)tlsf_block_size(&mem_tlsf, mem));
+  tlsf_free(&mem_tlsf, mem);
+  MEM_TLSF_CHECK_ALL();
+  LWIP_MEM_TLSF_UNPROTECT();
+}
+
+/**
+ * Shrink memory returned by mem_malloc().
+ *
+ * @param rmem pointer to memory allocated by mem_malloc the is to be shrinked
+ * @param new_size required size after shrinking (needs to be smaller than or
+ *                equal to the previous size)
+ * @return for compatibility reasons: is always == rmem, at the moment
+ *         or NULL if newsize is > old size, in which case rmem is NOT touched
+ *         or freed!
+ */
+void *
+mem_trim(void *rmem, mem_size_t new_size)
+{
+  u8_t *mem;
+  size_t size;
+  size_t old_size;
+  LWIP_MEM_TLSF_DECL_PROTECT();
+
+  if (new_size == 0) {
+    new_size = 1;
+  }
+
+  mem = (u8_t *)rmem - MEM_TLSF_HDR - MEM_SANITY_OFFSET;
+  if (!tlsf_contains(&mem_tlsf, mem)) {
+    LWIP_DEBUGF(MEM_DEBUG | LWIP_DBG_LEVEL_SEVERE, ("mem_trim: illegal memory\n"));
+    /* protect mem stats from concurrent access */
+    MEM_STATS_INC_LOCKED(illegal);
+    return rmem;
+  }
+
+  mem_tlsf_check_element(mem, 0, NULL);
+
+  size = (size_t)new_size + MEM_TLSF_HDR + MEM_SANITY_OVERHEAD;
+  LWIP_MEM_TLSF_PROTECT();
+  old_size = tlsf_block_size(&mem_tlsf, mem);
+  if (size > old_size) {
+    LWIP_MEM_TLSF_UNPROTECT();
+    LWIP_ASSERT("mem_trim can only shrink memory", 0);
+    return NULL;
+  }
+  tlsf_shrink(&mem_tlsf, mem, size);
+  MEM_STATS_DEC_USED(used, (mem_size_t)(old_size - tlsf_block_size(&mem_tlsf, mem)));
+  LWIP_MEM_TLSF_UNPROTECT();
+
+  mem_tlsf_init_element(mem, new_size);
+  return rmem;
+}
+
 #else /* MEM_USE_POOLS */
 /* lwIP replacement for your libc malloc() */
 
@@ -51,6 +51,12 @@
 
 #include <string.h>
 
+#ifdef __rtems__
+#if MEMP_USE_MAGAZINES
+#include <rtems.h>
+#endif /* MEMP_USE_MAGAZINES */
+#endif /* __rtems__ */
+
 /* Make sure we include everything we need for size calculation required by memp_std.h */
 #include "lwip/pbuf.h"
 #include "lwip/raw.h"
@@ -165,6 +171,111 @@ memp_overflow_check_all(void)
 #endif /* MEMP_OVERFLOW_CHECK >= 2 */
 #endif /* MEMP_OVERFLOW_CHECK */
 
+#if MEMP_USE_ELASTIC
+/* Elements added to growing pools are carved from this region and stay with
+ * their pool. It is only touched under SYS_ARCH_PROTECT. */
+LWIP_DECLARE_MEMORY_ALIGNED(memp_elastic_region, MEMP_ELASTIC_REGION_SIZE);
+static size_t memp_elastic_region_used;
+
+/* Called under SYS_ARCH_PROTECT with the free list of desc empty. Adds up to
+ * MEMP_ELASTIC_GROW_NUM elements and returns the number added. */
+static u16_t
+memp_elastic_grow(const struct memp_desc *desc)
+{
+  struct memp_elastic *elastic = desc->elastic;
+  size_t elem_size = MEMP_SIZE + desc->size;
+  size_t avail = (MEMP_ELASTIC_REGION_SIZE - memp_elastic_region_used) / elem_size;
+  u8_t *mem;
+  u16_t n;
+  u16_t i;
+
+  n = (u16_t)LWIP_MIN(MEMP_ELASTIC_GROW_NUM, desc->num - elastic->num);
+  if (avail < n) {
+    n = (u16_t)avail;
+  }
+  if (n == 0) {
+    return 0;
+  }
+
+  mem = (u8_t *)LWIP_MEM_ALIGN(memp_elastic_region) + memp_elastic_region_used;
+  for (i = 0; i < n; i++) {
+    /* cast through void* to get rid of alignment warnings */
+    struct memp *memp = (struct memp *)(void *)(mem + i * elem_size);
+
+    memp->next = *desc->tab;
+    *desc->tab = memp;
+  }
+  memp_elastic_region_used += n * elem_size;
+  elastic->num = (u16_t)(elastic->num + n);
+  elastic->grows++;
+  return n;
+}
+
+/* Called under SYS_ARCH_PROTECT */
+static void
+memp_elastic_account(const struct memp_desc *desc, int delta)
+{
+  struct memp_elastic *elastic = desc->elastic;
+
+  elastic->used = (u16_t)(elastic->used + delta);
+  if (elastic->used > elastic->high_water) {
+    elastic->high_water = elastic->used;
+  }
+}
+
+/**
+ * Get the sizing information of an elastic pool.
+ *
+ * @param desc the pool
+ * @param stats receives the information
+ */
+void
+memp_elastic_get_stats(const struct memp_desc *desc, struct memp_elastic_stats *stats)
+{
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  SYS_ARCH_PROTECT(old_level);
+  stats->min = LWIP_MEMPOOL_BASE_NUM(desc->num);
+  stats->max = desc->num;
+  stats->num = desc->elastic->num;
+  stats->high_water = desc->elastic->high_water;
+  stats->grows = desc->elastic->grows;
+  stats->failures = desc->elastic->failures;
+  SYS_ARCH_UNPROTECT(old_level);
+}
+
+/**
+ * Print the sizing information of all built-in pools and the use of the
+ * elastic region. A pool without failures needs no more than its high water
+ * mark, a pool with failures needs a larger cap or region.
+ */
+void
+memp_elastic_report(void)
+{
+  struct memp_elastic_stats stats;
+  u16_t i;
+
+  for (i = 0; i < LWIP_ARRAYSIZE(memp_pools); i++) {
+    memp_elastic_get_stats(memp_pools[i], &stats);
+    LWIP_PLATFORM_DIAG(("\nMEMP ELASTIC %"U16_F"\n\t", i));
+#if defined(LWIP_DEBUG) || LWIP_STATS_DISPLAY
+    LWIP_PLATFORM_DIAG(("name: %s\n\t", memp_pools[i]->desc));
+#endif
+    LWIP_PLATFORM_DIAG(("min: %"U16_F"\n\t", stats.min));
+    LWIP_PLATFORM_DIAG(("max: %"U16_F"\n\t", stats.max));
+    LWIP_PLATFORM_DIAG(("num: %"U16_F"\n\t", stats.num));
+    LWIP_PLATFORM_DIAG(("high water: %"U16_F"\n\t", stats.high_water));
+    LWIP_PLATFORM_DIAG(("grows: %"U16_F"\n\t", stats.grows));
+    LWIP_PLATFORM_DIAG(("failures: %"U32_F"\n", stats.failures));
+  }
+  LWIP_PLATFORM_DIAG(("\nMEMP ELASTIC REGION\n\tused: %"U32_F"\n\tsize: %"U32_F"\n",
+                      (u32_t)memp_elastic_region_used, (u32_t)MEMP_ELASTIC_REGION_SIZE));
+}
+#else /* MEMP_USE_ELASTIC */
+#define memp_elastic_grow(desc) 0
+#define memp_elastic_account(desc, delta)
+#endif /* MEMP_USE_ELASTIC */
+
 /**
  * Initialize custom memory pool.
  * Related functions: memp_malloc_pool, memp_free_pool
@@ -184,14 +295,14 @@ memp_init_pool(const struct memp_desc *desc)
   memp = (struct memp *)LWIP_MEM_ALIGN(desc->base);
 #if MEMP_MEM_INIT
   /* force memset on pool memory */
-  memset(memp, 0, (size_t)desc->num * (MEMP_SIZE + desc->size
+  memset(memp, 0, (size_t)LWIP_MEMPOOL_BASE_NUM(desc->num) * (MEMP_SIZE + desc->size
 #if MEMP_OVERFLOW_CHECK
                                        + MEM_SANITY_REGION_AFTER_ALIGNED
 #endif
                                       ));
 #endif
   /* create a linked list of memp elements */
-  for (i = 0; i < desc->num; ++i) {
+  for (i = 0; i < LWIP_MEMPOOL_BASE_NUM(desc->num); ++i) {
     memp->next = *desc->tab;
     *desc->tab = memp;
 #if MEMP_OVERFLOW_CHECK
@@ -207,6 +318,13 @@ memp_init_pool(const struct memp_desc *desc)
 #if MEMP_STATS
   desc->stats->avail = desc->num;
 #endif /* MEMP_STATS */
+#if MEMP_USE_MAGAZINES
+  memset(desc->magazines, 0, MEMP_MAGAZINE_MAX_CPUS * sizeof(*desc->magazines));
+#endif /* MEMP_USE_MAGAZINES */
+#if MEMP_USE_ELASTIC
+  memset(desc->elastic, 0, sizeof(*desc->elastic));
+  desc->elastic->num = LWIP_MEMPOOL_BASE_NUM(desc->num);
+#endif /* MEMP_USE_ELASTIC */
 #endif /* !MEMP_MEM_MALLOC */
 
 #if MEMP_STATS && (defined(LWIP_DEBUG) || LWIP_STATS_DISPLAY)
@@ -225,6 +343,10 @@ memp_init(void)
 {
   u16_t i;
 
+#if MEMP_USE_ELASTIC
+  memp_elastic_region_used = 0;
+#endif /* MEMP_USE_ELASTIC */
+
   /* for every pool: */
   for (i = 0; i < LWIP_ARRAYSIZE(memp_pools); i++) {
     memp_init_pool(memp_pools[i]);
@@ -240,6 +362,206 @@ memp_init(void)
 #endif /* MEMP_OVERFLOW_CHECK >= 2 */
 }
 
+#if MEMP_USE_MAGAZINES
+/*
+ * The cache of the current processor is only touched with interrupts disabled
+ * locally, which also keeps the thread from migrating. The global free list
+ * is only touched under SYS_ARCH_PROTECT, which may block on SMP and is never
+ * taken with interrupts disabled. Elements held in caches count as used in
+ * the pool statistics.
+ *
+ * Elements cached by one processor cannot be allocated on another, so small
+ * pools are not cached at all and the caches of the larger ones can hold at
+ * most a quarter of the pool.
+ */
+#define MEMP_MAGAZINE_MIN_NUM (4 * MEMP_MAGAZINE_MAX_CPUS * 2 * MEMP_MAGAZINE_SIZE)
+
+static struct memp_magazine *
+memp_magazine_get(const struct memp_desc *desc)
+{
+  uint32_t cpu;
+
+  if (desc->num < MEMP_MAGAZINE_MIN_NUM) {
+    return NULL;
+  }
+  cpu = rtems_scheduler_get_processor();
+  return cpu < MEMP_MAGAZINE_MAX_CPUS ? &desc->magazines[cpu] : NULL;
+}
+
+/* Moves up to count elements from the global free list to objs */
+static u16_t
+memp_global_get(const struct memp_desc *desc, struct memp **objs, u16_t count)
+{
+  u16_t n = 0;
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  SYS_ARCH_PROTECT(old_level);
+  while (n < count && (*desc->tab != NULL || memp_elastic_grow(desc))) {
+    objs[n++] = *desc->tab;
+    *desc->tab = (*desc->tab)->next;
+  }
+  memp_elastic_account(desc, n);
+#if MEMP_STATS
+  desc->stats->used += n;
+  if (desc->stats->used > desc->stats->max) {
+    desc->stats->max = desc->stats->used;
+  }
+#endif
+  SYS_ARCH_UNPROTECT(old_level);
+  return n;
+}
+
+static void
+memp_global_put(const struct memp_desc *desc, struct memp **objs, u16_t count)
+{
+  u16_t i;
+  SYS_ARCH_DECL_PROTECT(old_level);
+
+  SYS_ARCH_PROTECT(old_level);
+  for (i = 0; i < count; i++) {
+    objs[i]->next = *desc->tab;
+    *desc->tab = objs[i];
+  }
+  memp_elastic_account(desc, -count);
+#if MEMP_STATS
+  desc->stats->used -= count;
+#endif
+#if MEMP_SANITY_CHECK
+  LWIP_ASSERT("memp sanity", memp_sanity(desc));
+#endif /* MEMP_SANITY_CHECK */
+  SYS_ARCH_UNPROTECT(old_level);
+}
+
+static struct memp *
+memp_magazine_malloc(const struct memp_desc *desc)
+{
+  struct memp *batch[MEMP_MAGAZINE_SIZE];
+  struct memp_magazine *mag;
+  struct memp *memp = NULL;
+  rtems_interrupt_level level;
+  u16_t n;
+  u16_t i;
+
+  rtems_interrupt_local_disable(level);
+  mag = memp_magazine_get(desc);
+  if (mag != NULL) {
+    if (mag->count > 0) {
+      memp = mag->objs[--mag->count];
+      mag->hits++;
+    } else {
+      mag->misses++;
+    }
+  }
+  rtems_interrupt_local_enable(level);
+
+  if (memp != NULL) {
+    return memp;
+  }
+
+  /* Refill with one batch, the thread may run on another processor after */
+  n = memp_global_get(desc, batch, mag != NULL ? MEMP_MAGAZINE_SIZE : 1);
+  if (n == 0) {
+    return NULL;
+  }
+  memp = batch[--n];
+  if (n == 0) {
+    return memp;
+  }
+
+  i = 0;
+  rtems_interrupt_local_disable(level);
+  mag = memp_magazine_get(desc);
+  if (mag != NULL) {
+    while (i < n && mag->count < LWIP_ARRAYSIZE(mag->objs)) {
+      mag->objs[mag->count++] = batch[i++];
+    }
+  }
+  rtems_interrupt_local_enable(level);
+
+  if (i < n) {
+    memp_global_put(desc, &batch[i], (u16_t)(n - i));
+  }
+  return memp;
+}
+
+static void
+memp_magazine_free(const struct memp_desc *desc, struct memp *memp)
+{
+  struct memp *batch[MEMP_MAGAZINE_SIZE];
+  struct memp_magazine *mag;
+  rtems_interrupt_level level;
+  u16_t n = 0;
+
+  rtems_interrupt_local_disable(level);
+  mag = memp_magazine_get(desc);
+  if (mag != NULL) {
+    if (mag->count == LWIP_ARRAYSIZE(mag->objs)) {
+      /* Drain the batch that has been cached the longest */
+      n = MEMP_MAGAZINE_SIZE;
+      memcpy(batch, mag->objs, sizeof(batch));
+      memmove(mag->objs, &mag->objs[MEMP_MAGAZINE_SIZE], sizeof(batch));
+      mag->count = MEMP_MAGAZINE_SIZE;
+      mag->drains++;
+    }
+    mag->objs[mag->count++] = memp;
+    memp = NULL;
+  }
+  rtems_interrupt_local_enable(level);
+
+  if (n > 0) {
+    memp_global_put(desc, batch, n);
+  }
+  if (memp != NULL) {
+    memp_global_put(desc, &memp, 1);
+  }
+}
+
+/**
+ * Get the cache counters of a pool summed over all processors.
+ *
+ * @param desc the pool
+ * @param stats receives the counters
+ */
+void
+memp_magazine_get_stats(const struct memp_desc *desc, struct memp_magazine_stats *stats)
+{
+  u16_t i;
+
+  memset(stats, 0, sizeof(*stats));
+  for (i = 0; i < MEMP_MAGAZINE_MAX_CPUS; i++) {
+    stats->hits += desc->magazines[i].hits;
+    stats->misses += desc->magazines[i].misses;
+    stats->drains += desc->magazines[i].drains;
+    stats->cached += desc->magazines[i].count;
+  }
+}
+
+/**
+ * Print the cache counters of all built-in pools.
+ */
+void
+memp_magazine_stats_display(void)
+{
+  struct memp_magazine_stats stats;
+  u16_t i;
+
+  for (i = 0; i < LWIP_ARRAYSIZE(memp_pools); i++) {
+    if (memp_pools[i]->num < MEMP_MAGAZINE_MIN_NUM) {
+      continue;
+    }
+    memp_magazine_get_stats(memp_pools[i], &stats);
+    LWIP_PLATFORM_DIAG(("\nMEMP CACHE %"U16_F"\n\t", i));
+#if defined(LWIP_DEBUG) || LWIP_STATS_DISPLAY
+    LWIP_PLATFORM_DIAG(("name: %s\n\t", memp_pools[i]->desc));
+#endif
+    LWIP_PLATFORM_DIAG(("hits: %"U32_F"\n\t", stats.hits));
+    LWIP_PLATFORM_DIAG(("misses: %"U32_F"\n\t", stats.misses));
+    LWIP_PLATFORM_DIAG(("drains: %"U32_F"\n\t", stats.drains));
+    LWIP_PLATFORM_DIAG(("cached: %"U32_F"\n", stats.cached));
+  }
+}
+#endif /* MEMP_USE_MAGAZINES */
+
 static void *
 #if !MEMP_OVERFLOW_CHECK
 do_memp_malloc_pool(const struct memp_desc *desc)
@@ -250,6 +572,25 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
   struct memp *memp;
   SYS_ARCH_DECL_PROTECT(old_level);
 
+#if MEMP_USE_MAGAZINES
+  memp = memp_magazine_malloc(desc);
+  if (memp != NULL) {
+    LWIP_ASSERT("memp_malloc: memp properly aligned",
+                ((mem_ptr_t)memp % MEM_ALIGNMENT) == 0);
+    return ((u8_t *)memp + MEMP_SIZE);
+  }
+  SYS_ARCH_PROTECT(old_level);
+#if MEMP_USE_ELASTIC
+  desc->elastic->failures++;
+#endif /* MEMP_USE_ELASTIC */
+#if MEMP_STATS
+  desc->stats->err++;
+#endif
+  SYS_ARCH_UNPROTECT(old_level);
+  LWIP_DEBUGF(MEMP_DEBUG | LWIP_DBG_LEVEL_SERIOUS, ("memp_malloc: out of memory in pool %s\n", desc->desc));
+  return NULL;
+#else /* MEMP_USE_MAGAZINES */
+
 #if MEMP_MEM_MALLOC
   memp = (struct memp *)mem_malloc(MEMP_SIZE + MEMP_ALIGN_SIZE(desc->size));
   SYS_ARCH_PROTECT(old_level);
@@ -257,6 +598,9 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
   SYS_ARCH_PROTECT(old_level);
 
   memp = *desc->tab;
+  if (memp == NULL && memp_elastic_grow(desc)) {
+    memp = *desc->tab;
+  }
 #endif /* MEMP_MEM_MALLOC */
 
   if (memp != NULL) {
@@ -279,6 +623,7 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
 #endif /* MEMP_OVERFLOW_CHECK */
     LWIP_ASSERT("memp_malloc: memp properly aligned",
                 ((mem_ptr_t)memp % MEM_ALIGNMENT) == 0);
+    memp_elastic_account(desc, 1);
 #if MEMP_STATS
     desc->stats->used++;
     if (desc->stats->used > desc->stats->max) {
@@ -289,6 +634,9 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
     /* cast through u8_t* to get rid of alignment warnings */
     return ((u8_t *)memp + MEMP_SIZE);
   } else {
+#if MEMP_USE_ELASTIC
+    desc->elastic->failures++;
+#endif /* MEMP_USE_ELASTIC */
 #if MEMP_STATS
     desc->stats->err++;
 #endif
@@ -297,6 +645,7 @@ do_memp_malloc_pool_fn(const struct memp_desc *desc, const char *file, const int
   }
 
   return NULL;
+#endif /* MEMP_USE_MAGAZINES */
 }
 
 /**
@@ -367,6 +716,10 @@ do_memp_free_pool(const struct memp_desc *desc, void *mem)
   /* cast through void* to get rid of alignment warnings */
   memp = (struct memp *)(void *)((u8_t *)mem - MEMP_SIZE);
 
+#if MEMP_USE_MAGAZINES
+  LWIP_UNUSED_ARG(old_level);
+  memp_magazine_free(desc, memp);
+#else /* MEMP_USE_MAGAZINES */
   SYS_ARCH_PROTECT(old_level);
 
 #if MEMP_OVERFLOW_CHECK == 1
@@ -384,6 +737,7 @@ do_memp_free_pool(const struct memp_desc *desc, void *mem)
 #else /* MEMP_MEM_MALLOC */
   memp->next = *desc->tab;
   *desc->tab = memp;
+  memp_elastic_account(desc, -1);
 
 #if MEMP_SANITY_CHECK
   LWIP_ASSERT("memp sanity", memp_sanity(desc));
@@ -391,6 +745,7 @@ do_memp_free_pool(const struct memp_desc *desc, void *mem)
 
   SYS_ARCH_UNPROTECT(old_level);
 #endif /* !MEMP_MEM_MALLOC */
+#endif /* MEMP_USE_MAGAZINES */
 }
 
 /**
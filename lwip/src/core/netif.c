@@ -326,6 +326,13 @@ netif_add(struct netif *netif,
   NETIF_SET_CHECKSUM_CTRL(netif, NETIF_CHECKSUM_ENABLE_ALL);
   netif->mtu = 0;
   netif->flags = 0;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+  netif->gso_max_size = LWIP_GSO_MAX_SIZE;
+  netif->gso_offload = 0;
+#endif /* __rtems__ && LWIP_GSO */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  netif->phc = NULL;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 #ifdef netif_get_client_data
   memset(netif->client_data, 0, sizeof(netif->client_data));
 #endif /* LWIP_NUM_NETIF_CLIENT_DATA */
@@ -374,6 +381,12 @@ netif_add(struct netif *netif,
   if (init(netif) != ERR_OK) {
     return NULL;
   }
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+  /* GSO packets are split up by ethernet_output() */
+  if ((netif->flags & NETIF_FLAG_ETHARP) == 0) {
+    netif->gso_max_size = 0;
+  }
+#endif /* __rtems__ && LWIP_GSO */
 #if LWIP_IPV6 && LWIP_ND6_ALLOW_RA_UPDATES
   /* Initialize the MTU for IPv6 to the one set by the netif driver.
      This can be updated later by RA. */
@@ -186,6 +186,11 @@ pbuf_init_alloced_pbuf(struct pbuf *p, void *payload, u16_t tot_len, u16_t len,
   p->flags = flags;
   p->ref = 1;
   p->if_idx = NETIF_NO_INDEX;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  p->tstamp_id = 0;
+  p->tstamp_sec = 0;
+  p->tstamp_nsec = 0;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 }
 
 /**
@@ -250,9 +255,16 @@ pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
           /* bail out unsuccessfully */
           return NULL;
         }
+#if defined(__rtems__) && PBUF_POOL_CACHE_LINE_SIZE
+        /* the buffer starts on the first cache line after the struct pbuf */
+        qlen = LWIP_MIN(rem_len, (u16_t)(PBUF_POOL_PAYLOAD_SIZE - LWIP_MEM_ALIGN_SIZE(offset)));
+        pbuf_init_alloced_pbuf(q, (u8_t *)PBUF_CACHE_ALIGN((u8_t *)q + SIZEOF_STRUCT_PBUF) + LWIP_MEM_ALIGN_SIZE(offset),
+                               rem_len, qlen, type, 0);
+#else /* __rtems__ */
         qlen = LWIP_MIN(rem_len, (u16_t)(PBUF_POOL_BUFSIZE_ALIGNED - LWIP_MEM_ALIGN_SIZE(offset)));
         pbuf_init_alloced_pbuf(q, LWIP_MEM_ALIGN((void *)((u8_t *)q + SIZEOF_STRUCT_PBUF + offset)),
                                rem_len, qlen, type, 0);
+#endif /* __rtems__ */
         LWIP_ASSERT("pbuf_alloc: pbuf q->payload properly aligned",
                     ((mem_ptr_t)q->payload % MEM_ALIGNMENT) == 0);
         LWIP_ASSERT("PBUF_POOL_BUFSIZE must be bigger than MEM_ALIGNMENT",
@@ -473,6 +473,10 @@ raw_sendto_if_src(struct raw_pcb *pcb, struct pbuf *p, const ip_addr_t *dst_ip,
       /* chain header q in front of given pbuf p */
       pbuf_chain(q, p);
     }
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+    /* The driver looks for the timestamp request in the first pbuf */
+    q->tstamp_id = p->tstamp_id;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
     /* { first pbuf q points to header pbuf } */
     LWIP_DEBUGF(RAW_DEBUG, ("raw_sendto: added header pbuf %p before given pbuf %p\n", (void *)q, (void *)p));
   } else {
@@ -157,7 +157,11 @@ tcp_input(struct pbuf *p, struct netif *inp)
   }
 
 #if CHECKSUM_CHECK_TCP
+#ifdef __rtems__
+  IF__NETIF_CHECKSUM_ENABLED_RX(inp, p, NETIF_CHECKSUM_CHECK_TCP) {
+#else /* __rtems__ */
   IF__NETIF_CHECKSUM_ENABLED(inp, NETIF_CHECKSUM_CHECK_TCP) {
+#endif /* __rtems__ */
     /* Verify TCP checksum. */
     u16_t chksum = ip_chksum_pseudo(p, IP_PROTO_TCP, p->tot_len,
                                     ip_current_src_addr(), ip_current_dest_addr());
@@ -1623,7 +1627,17 @@ tcp_receive(struct tcp_pcb *pcb)
 
 
         /* Acknowledge the segment(s). */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GRO
+        if (tcplen > pcb->mss) {
+          /* netif_gro() merged several segments, which would each have
+             counted towards the ACK of every second segment */
+          tcp_ack_now(pcb);
+        } else {
+          tcp_ack(pcb);
+        }
+#else /* __rtems__ && LWIP_GRO */
         tcp_ack(pcb);
+#endif /* __rtems__ && LWIP_GRO */
 
 #if LWIP_TCP_SACK_OUT
         if (LWIP_TCP_SACK_VALID(pcb, 0)) {
@@ -1870,6 +1884,17 @@ tcp_receive(struct tcp_pcb *pcb)
 
         /* We send the ACK packet after we've (potentially) dealt with SACKs,
            so they can be included in the acknowledgment. */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GRO
+        {
+          /* The sender counts on a duplicate ACK for each segment that
+             netif_gro() merged to detect the loss in front of them */
+          u16_t dupacks = (u16_t)((tcplen + pcb->mss - 1) / pcb->mss);
+
+          while (dupacks-- > 1) {
+            tcp_send_empty_ack(pcb);
+          }
+        }
+#endif /* __rtems__ && LWIP_GRO */
         tcp_send_empty_ack(pcb);
       }
     } else {
@@ -80,6 +80,10 @@
 
 #include <string.h>
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+#include <netif_gso.h>
+#endif /* __rtems__ && LWIP_GSO */
+
 #ifdef LWIP_HOOK_FILENAME
 #include LWIP_HOOK_FILENAME
 #endif
@@ -126,6 +130,11 @@
 
 /* Forward declarations.*/
 static err_t tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct netif *netif);
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+static u16_t tcp_gso_max_size(const struct tcp_pcb *pcb, const struct netif *netif);
+static err_t tcp_output_gso(struct tcp_seg *seg, struct tcp_pcb *pcb, struct netif *netif,
+                            u32_t wnd, u16_t gso_max_size, u16_t *gso_sent, err_t *gso_err);
+#endif /* __rtems__ && LWIP_GSO */
 
 /* tcp_route: common code that returns a fixed bound netif or calls ip_route */
 static struct netif *
@@ -1244,6 +1253,11 @@ tcp_output(struct tcp_pcb *pcb)
 #if TCP_CWND_DEBUG
   s16_t i = 0;
 #endif /* TCP_CWND_DEBUG */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+  u16_t gso_max_size;
+  u16_t gso_sent = 0;
+  err_t gso_err = ERR_OK;
+#endif /* __rtems__ && LWIP_GSO */
 
   LWIP_ASSERT_CORE_LOCKED();
 
@@ -1302,6 +1316,10 @@ tcp_output(struct tcp_pcb *pcb)
     ip_addr_copy(pcb->local_ip, *local_ip);
   }
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+  gso_max_size = tcp_gso_max_size(pcb, netif);
+#endif /* __rtems__ && LWIP_GSO */
+
   /* Handle the current segment not fitting within the window */
   if (lwip_ntohl(seg->tcphdr->seqno) - pcb->lastack + seg->len > wnd) {
     /* We need to start the persistent timer when the next unsent segment does not fit
@@ -1341,10 +1359,18 @@ tcp_output(struct tcp_pcb *pcb)
      *   either seg->next != NULL or pcb->unacked == NULL;
      *   RST is no sent using tcp_write/tcp_output.
      */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+    /* - if the segment already went out as part of a GSO packet */
+    if ((gso_sent == 0) && (tcp_do_output_nagle(pcb) == 0) &&
+        ((pcb->flags & (TF_NAGLEMEMERR | TF_FIN)) == 0)) {
+      break;
+    }
+#else /* __rtems__ && LWIP_GSO */
     if ((tcp_do_output_nagle(pcb) == 0) &&
         ((pcb->flags & (TF_NAGLEMEMERR | TF_FIN)) == 0)) {
       break;
     }
+#endif /* __rtems__ && LWIP_GSO */
 #if TCP_CWND_DEBUG
     LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_output: snd_wnd %"TCPWNDSIZE_F", cwnd %"TCPWNDSIZE_F", wnd %"U32_F", effwnd %"U32_F", seq %"U32_F", ack %"U32_F", i %"S16_F"\n",
                                  pcb->snd_wnd, pcb->cwnd, wnd,
@@ -1358,7 +1384,19 @@ tcp_output(struct tcp_pcb *pcb)
       TCPH_SET_FLAG(seg->tcphdr, TCP_ACK);
     }
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+    if (gso_sent > 0) {
+      /* sent by tcp_output_gso() along with the segments before it */
+      gso_sent--;
+      err = ERR_OK;
+    } else if (gso_max_size != 0) {
+      err = tcp_output_gso(seg, pcb, netif, wnd, gso_max_size, &gso_sent, &gso_err);
+    } else {
+      err = tcp_output_segment(seg, pcb, netif);
+    }
+#else /* __rtems__ && LWIP_GSO */
     err = tcp_output_segment(seg, pcb, netif);
+#endif /* __rtems__ && LWIP_GSO */
     if (err != ERR_OK) {
       /* segment could not be sent, for whatever reason */
       tcp_set_flags(pcb, TF_NAGLEMEMERR);
@@ -1407,6 +1445,13 @@ tcp_output(struct tcp_pcb *pcb)
       tcp_seg_free(seg);
     }
     seg = pcb->unsent;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+    if ((gso_sent == 0) && (gso_err != ERR_OK)) {
+      /* the netif did not take the rest of the GSO packet */
+      tcp_set_flags(pcb, TF_NAGLEMEMERR);
+      return gso_err;
+    }
+#endif /* __rtems__ && LWIP_GSO */
   }
 #if TCP_OVERSIZE
   if (pcb->unsent == NULL) {
@@ -1604,10 +1649,22 @@ tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct netif *netif
 #endif /* CHECKSUM_GEN_TCP */
   TCP_STATS_INC(tcp.xmit);
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+  if ((seg->p->flags & PBUF_FLAG_GSO) != 0) {
+    /* tcp_output_gso() sends it as part of a GSO packet */
+    err = ERR_OK;
+  } else {
+    NETIF_SET_HINTS(netif, &(pcb->netif_hints));
+    err = ip_output_if(seg->p, &pcb->local_ip, &pcb->remote_ip, pcb->ttl,
+                       pcb->tos, IP_PROTO_TCP, netif);
+    NETIF_RESET_HINTS(netif);
+  }
+#else /* __rtems__ && LWIP_GSO */
   NETIF_SET_HINTS(netif, &(pcb->netif_hints));
   err = ip_output_if(seg->p, &pcb->local_ip, &pcb->remote_ip, pcb->ttl,
                      pcb->tos, IP_PROTO_TCP, netif);
   NETIF_RESET_HINTS(netif);
+#endif /* __rtems__ && LWIP_GSO */
 
 #if TCP_CHECKSUM_ON_COPY
   if (seg_chksum_was_swapped) {
@@ -1621,6 +1678,126 @@ tcp_output_segment(struct tcp_seg *seg, struct tcp_pcb *pcb, struct netif *netif
   return err;
 }
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+/**
+ * Returns the TCP payload bytes tcp_output() may send to netif as one GSO
+ * packet, or 0 if the segments have to go out one by one. IPv6 and the
+ * loopback path of ip4_output_if() take single packets only.
+ */
+static u16_t
+tcp_gso_max_size(const struct tcp_pcb *pcb, const struct netif *netif)
+{
+#if LWIP_IPV4
+  if (IP_IS_V4(&pcb->remote_ip) &&
+      !ip4_addr_cmp(ip_2_ip4(&pcb->remote_ip), netif_ip4_addr(netif)) &&
+      !ip4_addr_isloopback(ip_2_ip4(&pcb->remote_ip))) {
+    return netif->gso_max_size;
+  }
+#else /* LWIP_IPV4 */
+  LWIP_UNUSED_ARG(pcb);
+  LWIP_UNUSED_ARG(netif);
+#endif /* LWIP_IPV4 */
+  return 0;
+}
+
+/**
+ * Called by tcp_output() to send a segment together with the segments
+ * queued behind it as one GSO packet, see netif_gso.h. Only segments that
+ * tcp_output() would send next are taken: they fit into wnd and
+ * gso_max_size, Nagle would not hold them back and the netif driver no
+ * longer references them. tcp_output() then moves them to the unacked
+ * queue as if they had been sent one by one.
+ *
+ * @param seg the first tcp_seg to send
+ * @param pcb the tcp_pcb for the TCP connection used to send the segments
+ * @param netif the netif used to send the segments
+ * @param wnd the send window of tcp_output()
+ * @param gso_max_size the most payload bytes to send at once
+ * @param gso_sent returns the number of segments sent after seg
+ * @param gso_err returns the error of the first segment after seg that
+ *        could not be sent
+ * @return the error of seg, which was not sent unless ERR_OK
+ */
+static err_t
+tcp_output_gso(struct tcp_seg *seg, struct tcp_pcb *pcb, struct netif *netif,
+               u32_t wnd, u16_t gso_max_size, u16_t *gso_sent, err_t *gso_err)
+{
+  struct tcp_seg *last = seg;
+  struct tcp_seg *s;
+  u32_t size = seg->len;
+  u16_t count = 1;
+  u16_t sent;
+  u8_t unsent;
+  err_t err;
+
+  *gso_sent = 0;
+  *gso_err = ERR_OK;
+
+  if ((seg->len == 0) || ((TCPH_FLAGS(seg->tcphdr) & TCP_SYN) != 0) ||
+      tcp_output_segment_busy(seg) || !netif_gso_segment_linkable(seg->p)) {
+    return tcp_output_segment(seg, pcb, netif);
+  }
+
+  for (s = seg->next; s != NULL; s = s->next) {
+    if ((size + s->len > gso_max_size) ||
+        (lwip_ntohl(s->tcphdr->seqno) - pcb->lastack + s->len > wnd) ||
+        tcp_output_segment_busy(s) || !netif_gso_segment_linkable(s->p)) {
+      break;
+    }
+    /* tcp_do_output_nagle() for s once seg is on the unacked queue */
+    if ((s->next == NULL) && (s->len < pcb->mss) &&
+        ((pcb->flags & (TF_NODELAY | TF_INFR | TF_NAGLEMEMERR | TF_FIN)) == 0) &&
+        (tcp_sndbuf(pcb) != 0) && (tcp_sndqueuelen(pcb) < TCP_SND_QUEUELEN)) {
+      break;
+    }
+    size += s->len;
+    count++;
+    last = s;
+  }
+  if (count == 1) {
+    return tcp_output_segment(seg, pcb, netif);
+  }
+
+  /* Build the headers of all segments and chain them up */
+  for (s = seg; s != last->next; s = s->next) {
+    if (pcb->state != SYN_SENT) {
+      TCPH_SET_FLAG(s->tcphdr, TCP_ACK);
+    }
+    s->p->flags |= PBUF_FLAG_GSO;
+    tcp_output_segment(s, pcb, netif);
+    if (s != last) {
+      netif_gso_segment_end(s->p)->next = s->next->p;
+    }
+  }
+
+  NETIF_SET_HINTS(netif, &(pcb->netif_hints));
+  err = ip_output_if(seg->p, &pcb->local_ip, &pcb->remote_ip, pcb->ttl,
+                     pcb->tos, IP_PROTO_TCP, netif);
+  NETIF_RESET_HINTS(netif);
+
+  /* Take the chain apart again and see how far it got: on error, the
+     segments sent are those that lost PBUF_FLAG_GSO on the way */
+  sent = 0;
+  unsent = 0;
+  for (s = seg; s != last->next; s = s->next) {
+    netif_gso_segment_end(s->p)->next = NULL;
+    if ((err != ERR_OK) && ((s->p->flags & PBUF_FLAG_GSO) != 0)) {
+      unsent = 1;
+    }
+    if (!unsent) {
+      sent++;
+    }
+    s->p->flags = (u8_t)(s->p->flags & ~PBUF_FLAG_GSO);
+  }
+  if (sent == 0) {
+    return err;
+  }
+  *gso_sent = (u16_t)(sent - 1);
+  *gso_err = (sent < count) ? err : ERR_OK;
+  return ERR_OK;
+}
+#endif /* __rtems__ && LWIP_GSO */
+
 /**
  * Requeue all unacked segments for retransmission
  *
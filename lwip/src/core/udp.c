@@ -73,6 +73,11 @@
 #define UDP_ENSURE_LOCAL_PORT_RANGE(port) ((u16_t)(((port) & (u16_t)~UDP_LOCAL_PORT_RANGE_START) + UDP_LOCAL_PORT_RANGE_START))
 #endif
 
+#ifdef __rtems__
+/* The largest IPv4 or IPv6 header in front of a datagram sent by lwIP */
+#define UDP_CHKSUM_MAX_IP_HLEN 60
+#endif /* __rtems__ */
+
 /* last local UDP port */
 static u16_t udp_port = UDP_LOCAL_PORT_RANGE_START;
 
@@ -329,7 +334,11 @@ udp_input(struct pbuf *p, struct netif *inp)
   if (for_us) {
     LWIP_DEBUGF(UDP_DEBUG | LWIP_DBG_TRACE, ("udp_input: calculating checksum\n"));
 #if CHECKSUM_CHECK_UDP
+#ifdef __rtems__
+    IF__NETIF_CHECKSUM_ENABLED_RX(inp, p, NETIF_CHECKSUM_CHECK_UDP) {
+#else /* __rtems__ */
     IF__NETIF_CHECKSUM_ENABLED(inp, NETIF_CHECKSUM_CHECK_UDP) {
+#endif /* __rtems__ */
 #if LWIP_UDPLITE
       if (ip_current_header_proto() == IP_PROTO_UDPLITE) {
         /* Do the UDP Lite checksum */
@@ -769,6 +778,10 @@ udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *d
       /* chain header q in front of given pbuf p (only if p contains data) */
       pbuf_chain(q, p);
     }
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+    /* The driver looks for the timestamp request in the first pbuf */
+    q->tstamp_id = p->tstamp_id;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
     /* first pbuf q points to header pbuf */
     LWIP_DEBUGF(UDP_DEBUG,
                 ("udp_send: added header pbuf %p before given pbuf %p\n", (void *)q, (void *)p));
@@ -819,7 +832,12 @@ udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *d
     udphdr->len = lwip_htons(chklen_hdr);
     /* calculate checksum */
 #if CHECKSUM_GEN_UDP
-    IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_UDP) {
+#ifdef __rtems__
+    /* Checksum offload does not cover UDP Lite */
+#else /* __rtems__ */
+    IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_UDP)
+#endif /* __rtems__ */
+    {
 #if LWIP_CHECKSUM_ON_COPY
       if (have_chksum) {
         chklen = UDP_HLEN;
@@ -850,7 +868,13 @@ udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *d
     udphdr->len = lwip_htons(q->tot_len);
     /* calculate checksum */
 #if CHECKSUM_GEN_UDP
+#if defined(__rtems__) && LWIP_CHECKSUM_CTRL_PER_NETIF
+    /* Checksum offload does not cover datagrams that get fragmented */
+    if (((netif->chksum_flags & NETIF_CHECKSUM_GEN_UDP) != 0) ||
+        (q->tot_len + UDP_CHKSUM_MAX_IP_HLEN > netif->mtu)) {
+#else /* __rtems__ */
     IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_UDP) {
+#endif /* __rtems__ */
       /* Checksum is mandatory over IPv6. */
       if (IP_IS_V6(dst_ip) || (pcb->flags & UDP_FLAGS_NOCHKSUM) == 0) {
         u16_t udpchksum;
@@ -93,12 +93,15 @@ extern const struct memp_desc* const memp_pools[MEMP_MAX];
  *   extern u8_t \_\_attribute\_\_((section(".onchip_mem"))) memp_memory_my_private_pool_base[];
  */
 #define LWIP_MEMPOOL_DECLARE(name,num,size,desc) \
-  LWIP_DECLARE_MEMORY_ALIGNED(memp_memory_ ## name ## _base, ((num) * (MEMP_SIZE + MEMP_ALIGN_SIZE(size)))); \
+  LWIP_DECLARE_MEMORY_ALIGNED(memp_memory_ ## name ## _base, (LWIP_MEMPOOL_BASE_NUM(num) * (MEMP_SIZE + MEMP_ALIGN_SIZE(size)))); \
     \
   LWIP_MEMPOOL_DECLARE_STATS_INSTANCE(memp_stats_ ## name) \
     \
   static struct memp *memp_tab_ ## name; \
     \
+  LWIP_MEMPOOL_DECLARE_MAGAZINES(name) \
+  LWIP_MEMPOOL_DECLARE_ELASTIC(name) \
+    \
   const struct memp_desc memp_ ## name = { \
     DECLARE_LWIP_MEMPOOL_DESC(desc) \
     LWIP_MEMPOOL_DECLARE_STATS_REFERENCE(memp_stats_ ## name) \
@@ -106,6 +109,8 @@ extern const struct memp_desc* const memp_pools[MEMP_MAX];
     (num), \
     memp_memory_ ## name ## _base, \
     &memp_tab_ ## name \
+    LWIP_MEMPOOL_MAGAZINES_REFERENCE(name) \
+    LWIP_MEMPOOL_ELASTIC_REFERENCE(name) \
   };
 
 #endif /* MEMP_MEM_MALLOC */
@@ -148,6 +153,37 @@ void *memp_malloc(memp_t type);
 #endif
 void  memp_free(memp_t type, void *mem);
 
+#if MEMP_USE_MAGAZINES
+/** Sum of the per-processor cache counters of a pool */
+struct memp_magazine_stats {
+  u32_t hits;
+  u32_t misses;
+  u32_t drains;
+  u32_t cached;
+};
+
+void memp_magazine_get_stats(const struct memp_desc *desc, struct memp_magazine_stats *stats);
+void memp_magazine_stats_display(void);
+#endif /* MEMP_USE_MAGAZINES */
+
+#if MEMP_USE_ELASTIC
+/** Sizing information of an elastic pool */
+struct memp_elastic_stats {
+  /** Elements in the static memory of the pool */
+  u16_t min;
+  /** Cap the pool may grow to */
+  u16_t max;
+  /** Elements currently owned by the pool */
+  u16_t num;
+  u16_t high_water;
+  u16_t grows;
+  u32_t failures;
+};
+
+void memp_elastic_get_stats(const struct memp_desc *desc, struct memp_elastic_stats *stats);
+void memp_elastic_report(void);
+#endif /* MEMP_USE_ELASTIC */
+
 #ifdef __cplusplus
 }
 #endif
@@ -150,6 +150,9 @@ enum lwip_internal_netif_client_data_index
 #endif /* LWIP_CHECKSUM_CTRL_PER_NETIF */
 
 struct netif;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+struct netif_phc;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 
 /** MAC Filter Actions, these are passed to a netif's igmp_mac_filter or
  * mld_mac_filter callback function. */
@@ -333,6 +336,19 @@ struct netif {
 #endif /* LWIP_CHECKSUM_CTRL_PER_NETIF*/
   /** maximum transfer unit (in bytes) */
   u16_t mtu;
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+  /** TCP payload bytes passed down as one GSO packet at most, 0 disables
+   * GSO. netif_add() sets it to LWIP_GSO_MAX_SIZE for ETHARP interfaces. */
+  u16_t gso_max_size;
+  /** Set by drivers that take GSO packets as they are and segment them in
+   * hardware, see netif_gso.h */
+  u8_t gso_offload;
+#endif /* __rtems__ && LWIP_GSO */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  /** Hardware clock that timestamps the packets of this netif, set by
+   * drivers that provide one, see netif_hwtstamp.h */
+  const struct netif_phc *phc;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 #if LWIP_IPV6 && LWIP_ND6_ALLOW_RA_UPDATES
   /** maximum transfer unit (in bytes), updated by RA */
   u16_t mtu6;
@@ -397,9 +413,18 @@ struct netif {
 #define NETIF_SET_CHECKSUM_CTRL(netif, chksumflags) do { \
   (netif)->chksum_flags = chksumflags; } while(0)
 #define IF__NETIF_CHECKSUM_ENABLED(netif, chksumflag) if (((netif) == NULL) || (((netif)->chksum_flags & (chksumflag)) != 0))
+#ifdef __rtems__
+/** Checks of received packets also run for packets the netif left unverified */
+#define IF__NETIF_CHECKSUM_ENABLED_RX(netif, p, chksumflag) \
+  if (((netif) == NULL) || (((netif)->chksum_flags & (chksumflag)) != 0) || \
+      (((p)->flags & PBUF_FLAG_CHKSUM_SW) != 0))
+#endif /* __rtems__ */
 #else /* LWIP_CHECKSUM_CTRL_PER_NETIF */
 #define NETIF_SET_CHECKSUM_CTRL(netif, chksumflags)
 #define IF__NETIF_CHECKSUM_ENABLED(netif, chksumflag)
+#ifdef __rtems__
+#define IF__NETIF_CHECKSUM_ENABLED_RX(netif, p, chksumflag)
+#endif /* __rtems__ */
 #endif /* LWIP_CHECKSUM_CTRL_PER_NETIF */
 
 #if LWIP_SINGLE_NETIF
@@ -181,6 +181,16 @@ typedef enum {
 #define PBUF_FLAG_LLMCAST   0x10U
 /** indicates this pbuf includes a TCP FIN flag */
 #define PBUF_FLAG_TCP_FIN   0x20U
+#ifdef __rtems__
+/** indicates the checksums of this received packet were not verified by a
+    netif that otherwise verifies them, so the stack has to check them */
+#define PBUF_FLAG_CHKSUM_SW 0x40U
+#endif /* __rtems__ */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+/** indicates this packet is a segment of a GSO packet that has not been
+    passed to the netif driver yet, see netif_gso.h */
+#define PBUF_FLAG_GSO       0x80U
+#endif /* __rtems__ && LWIP_GSO */
 
 /** Main packet buffer struct */
 struct pbuf {
@@ -220,10 +230,40 @@ struct pbuf {
   /** For incoming packets, this contains the input netif's index */
   u8_t if_idx;
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  /** For outgoing packets, the transmit timestamp request the netif driver
+      reports the time of sending for (0 for none), see netif_hwtstamp.h */
+  u16_t tstamp_id;
+  /** For incoming packets, the hardware time of reception (0 if unknown) */
+  u32_t tstamp_sec;
+  u32_t tstamp_nsec;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
+
   /** In case the user needs to store data custom data on a pbuf */
   LWIP_PBUF_CUSTOM_DATA
 };
 
+#ifdef __rtems__
+#if PBUF_POOL_CACHE_LINE_SIZE
+/* PBUF_POOL payloads start on a cache line of their own and end on a line
+ * boundary, so a driver can invalidate a received frame without touching the
+ * struct pbuf in front of it or the next element of the pool. */
+#define PBUF_CACHE_ALIGN_SIZE(size) \
+  (((size) + PBUF_POOL_CACHE_LINE_SIZE - 1U) & ~(PBUF_POOL_CACHE_LINE_SIZE - 1U))
+#define PBUF_CACHE_ALIGN(addr) \
+  ((void *)(((mem_ptr_t)(addr) + PBUF_POOL_CACHE_LINE_SIZE - 1) & \
+            ~(mem_ptr_t)(PBUF_POOL_CACHE_LINE_SIZE - 1)))
+/** Room for the struct pbuf and the worst case padding up to the first line
+ * of the payload, pool elements are only MEM_ALIGNMENT aligned */
+#define PBUF_POOL_HEADER_SIZE \
+  (LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf)) + \
+   (PBUF_POOL_CACHE_LINE_SIZE > MEM_ALIGNMENT ? \
+    PBUF_POOL_CACHE_LINE_SIZE - MEM_ALIGNMENT : 0))
+#define PBUF_POOL_PAYLOAD_SIZE \
+  PBUF_CACHE_ALIGN_SIZE(LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE))
+#endif /* PBUF_POOL_CACHE_LINE_SIZE */
+#endif /* __rtems__ */
+
 
 /** Helper struct for const-correctness only.
  * The only meaning of this one is to provide a const payload pointer
@@ -104,6 +104,77 @@ typedef enum {
 #define MEMP_POOL_LAST   ((memp_t) MEMP_POOL_HELPER_LAST)
 #endif /* MEM_USE_POOLS && MEMP_USE_CUSTOM_POOLS */
 
+#ifdef __rtems__
+/* Per-processor caches are not combined with the features that need every
+ * free element on the global list */
+#if MEMP_MAGAZINES && !MEMP_MEM_MALLOC && !MEMP_OVERFLOW_CHECK && !defined(LWIP_HOOK_MEMP_AVAILABLE)
+#define MEMP_USE_MAGAZINES 1
+#else
+#define MEMP_USE_MAGAZINES 0
+#endif
+/* Grown elements are not contiguous with the pool memory */
+#if MEMP_ELASTIC && !MEMP_MEM_MALLOC && !MEMP_OVERFLOW_CHECK
+#define MEMP_USE_ELASTIC 1
+#else
+#define MEMP_USE_ELASTIC 0
+#endif
+#else /* __rtems__ */
+#define MEMP_USE_MAGAZINES 0
+#define MEMP_USE_ELASTIC 0
+#endif /* __rtems__ */
+
+#if MEMP_USE_MAGAZINES
+/** Per-processor cache of free elements. It holds up to two batches of
+ * MEMP_MAGAZINE_SIZE elements and is refilled from and drained to the global
+ * free list one batch at a time. Aligned so processors do not share lines. */
+struct memp_magazine {
+  struct memp *objs[2 * MEMP_MAGAZINE_SIZE];
+  u16_t count;
+  /** Allocations served from the cache */
+  u32_t hits;
+  /** Allocations that had to go to the global free list */
+  u32_t misses;
+  /** Batches returned to the global free list */
+  u32_t drains;
+} __attribute__((aligned(MEMP_MAGAZINE_ALIGN)));
+
+#define LWIP_MEMPOOL_DECLARE_MAGAZINES(name) \
+  static struct memp_magazine memp_magazines_ ## name[MEMP_MAGAZINE_MAX_CPUS];
+#define LWIP_MEMPOOL_MAGAZINES_REFERENCE(name) , memp_magazines_ ## name
+#else /* MEMP_USE_MAGAZINES */
+#define LWIP_MEMPOOL_DECLARE_MAGAZINES(name)
+#define LWIP_MEMPOOL_MAGAZINES_REFERENCE(name)
+#endif /* MEMP_USE_MAGAZINES */
+
+#if MEMP_USE_ELASTIC
+/** Runtime state of a pool that starts with MEMP_ELASTIC_MIN_PERCENT of its
+ * elements and grows from the shared elastic region up to all of them */
+struct memp_elastic {
+  /** Elements currently owned by the pool */
+  u16_t num;
+  /** Elements currently allocated */
+  u16_t used;
+  /** Largest number of elements ever allocated at once */
+  u16_t high_water;
+  /** Number of times the pool has grown */
+  u16_t grows;
+  /** Allocations that failed at the cap or with the region exhausted */
+  u32_t failures;
+};
+
+/** Number of elements in the static memory of a pool of num elements */
+#define LWIP_MEMPOOL_BASE_NUM(num) \
+  (((num) * MEMP_ELASTIC_MIN_PERCENT / 100) > 0 ? \
+   ((num) * MEMP_ELASTIC_MIN_PERCENT / 100) : 1)
+#define LWIP_MEMPOOL_DECLARE_ELASTIC(name) \
+  static struct memp_elastic memp_elastic_ ## name;
+#define LWIP_MEMPOOL_ELASTIC_REFERENCE(name) , &memp_elastic_ ## name
+#else /* MEMP_USE_ELASTIC */
+#define LWIP_MEMPOOL_BASE_NUM(num) (num)
+#define LWIP_MEMPOOL_DECLARE_ELASTIC(name)
+#define LWIP_MEMPOOL_ELASTIC_REFERENCE(name)
+#endif /* MEMP_USE_ELASTIC */
+
 /** Memory pool descriptor */
 struct memp_desc {
 #if defined(LWIP_DEBUG) || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY
@@ -128,6 +199,14 @@ struct memp_desc {
   /** First free element of each pool. Elements form a linked list. */
   struct memp **tab;
 #endif /* MEMP_MEM_MALLOC */
+#if MEMP_USE_MAGAZINES
+  /** Caches indexed by processor */
+  struct memp_magazine *magazines;
+#endif /* MEMP_USE_MAGAZINES */
+#if MEMP_USE_ELASTIC
+  /** Growth state, num above is the cap */
+  struct memp_elastic *elastic;
+#endif /* MEMP_USE_ELASTIC */
 };
 
 #if defined(LWIP_DEBUG) || MEMP_OVERFLOW_CHECK || LWIP_STATS_DISPLAY
@@ -131,7 +131,11 @@ LWIP_MEMPOOL(MLD6_GROUP,     MEMP_NUM_MLD6_GROUP,      sizeof(struct mld_group),
  *     (Example: pbuf_payload_size=0 allocates only size for the struct)
  */
 LWIP_MEMPOOL(PBUF,           MEMP_NUM_PBUF,            sizeof(struct pbuf),           "PBUF_REF/ROM")
+#if defined(__rtems__) && PBUF_POOL_CACHE_LINE_SIZE
+LWIP_MEMPOOL(PBUF_POOL,      PBUF_POOL_SIZE,           PBUF_POOL_HEADER_SIZE + PBUF_POOL_PAYLOAD_SIZE, "PBUF_POOL")
+#else /* __rtems__ */
 LWIP_PBUF_MEMPOOL(PBUF_POOL, PBUF_POOL_SIZE,           PBUF_POOL_BUFSIZE,             "PBUF_POOL")
+#endif /* __rtems__ */
 
 
 /*
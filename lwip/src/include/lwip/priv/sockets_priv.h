@@ -89,6 +89,10 @@ struct lwip_sock {
 #define LWIP_SOCK_FD_FREE_TCP  1
 #define LWIP_SOCK_FD_FREE_FREE 2
 #endif
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+  /** SOF_TIMESTAMPING_* flags set with SO_TIMESTAMPING */
+  u16_t tstamp_flags;
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 };
 
 #ifndef set_errno
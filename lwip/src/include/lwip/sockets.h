@@ -244,6 +244,28 @@ struct ifreq {
 #endif /* __rtems__ */
 #define SO_NO_CHECK     0x100a /* don't create UDP checksum */
 #define SO_BINDTODEVICE 0x100b /* bind to device */
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_HWTSTAMP
+#define SO_TIMESTAMPING 0x100c /* packet timestamps, see netif_hwtstamp.h */
+#define SCM_TIMESTAMPING SO_TIMESTAMPING
+
+/* Flags of SO_TIMESTAMPING with the values of Linux. Hardware timestamps are
+ * always reported raw and MSG_ERRQUEUE always returns the timestamp only, so
+ * RAW_HARDWARE and OPT_TSONLY are accepted but change nothing. */
+#define SOF_TIMESTAMPING_TX_HARDWARE  0x0001 /* stamp sent datagrams */
+#define SOF_TIMESTAMPING_RX_HARDWARE  0x0004 /* stamp received datagrams */
+#define SOF_TIMESTAMPING_RAW_HARDWARE 0x0040
+#define SOF_TIMESTAMPING_OPT_TSONLY   0x0800
+
+#include <time.h>
+
+/* Payload of an SCM_TIMESTAMPING control message, ts[2] is the hardware
+ * timestamp and the others are zero */
+struct scm_timestamping {
+  struct timespec ts[3];
+};
+
+#define MSG_ERRQUEUE   0x2000000 /* Receive queued transmit timestamps */
+#endif /* __rtems__ && LWIP_HWTSTAMP */
 
 #ifndef __rtems__
 
@@ -51,6 +51,10 @@
 
 #include <string.h>
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+#include <netif_gso.h>
+#endif /* __rtems__ && LWIP_GSO */
+
 #include "netif/ppp/ppp_opts.h"
 #if PPPOE_SUPPORT
 #include "netif/ppp/pppoe.h"
@@ -308,6 +312,13 @@ ethernet_output(struct netif * netif, struct pbuf * p,
   LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE,
               ("ethernet_output: sending packet %p\n", (void *)p));
 
+#if (defined(__rtems__) || defined(LWIP_HOST_BUILD)) && LWIP_GSO
+  if (((p->flags & PBUF_FLAG_GSO) != 0) && !netif->gso_offload) {
+    /* send each segment of the GSO packet as a frame of its own */
+    return netif_gso_output(netif, p);
+  }
+#endif /* __rtems__ && LWIP_GSO */
+
   /* send the packet */
   return netif->linkoutput(netif, p);
 
@@ -25,87 +25,418 @@
  */
 
 #include <lwip/netif.h>
+#include <lwip/sys.h>
 #include <ifaddrs.h>
 #include <net/if.h>
 #include <netinet/in.h>
-static struct ifaddrs *create_ifaddr_from_netif(struct netif *netif)
+#include <errno.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*
+ * The interface address list is kept as a single reference counted snapshot
+ * that is only rebuilt when lwIP reports a change to a netif. Repeated calls
+ * to getifaddrs() on an unchanged configuration hand out the same snapshot and
+ * do not touch the heap. The cache holds one reference to the current
+ * snapshot and every caller of getifaddrs() holds another until it calls
+ * freeifaddrs().
+ */
+
+union ifaddrs_sockaddr {
+  struct sockaddr sa;
+  struct sockaddr_in sin;
+#if LWIP_IPV6
+  struct sockaddr_in6 sin6;
+#endif
+};
+
+struct ifaddrs_entry {
+  struct ifaddrs ifaddr;
+  union ifaddrs_sockaddr addr;
+  union ifaddrs_sockaddr netmask;
+  union ifaddrs_sockaddr dstaddr;
+  u8_t netif_index;
+};
+
+struct ifaddrs_netif_data {
+  u8_t netif_index;
+  char name[NETIF_NAMESIZE];
+  struct if_data data;
+};
+
+struct ifaddrs_snapshot {
+  unsigned int refcount;
+  unsigned int generation;
+  size_t entry_count;
+  size_t netif_count;
+  struct ifaddrs_netif_data *netif_data;
+  struct ifaddrs_entry entries[];
+};
+
+NETIF_DECLARE_EXT_CALLBACK(ifaddrs_netif_callback)
+static bool ifaddrs_callback_registered;
+static unsigned int ifaddrs_generation;
+static struct ifaddrs_snapshot *ifaddrs_current;
+
+static void ifaddrs_snapshot_release(struct ifaddrs_snapshot *snapshot)
 {
-  struct ifaddrs *ifaddr = malloc(sizeof(struct ifaddrs));
-  if ( ifaddr == NULL ) {
-    return NULL;
+  bool last;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  last = --snapshot->refcount == 0;
+  SYS_ARCH_UNPROTECT(lev);
+
+  if ( last ) {
+    free(snapshot);
   }
-  ifaddr->ifa_next = NULL;
-  ifaddr->ifa_name = netif->name;
+}
+
+static void ifaddrs_invalidate(
+  struct netif *netif,
+  netif_nsc_reason_t reason,
+  const netif_ext_callback_args_t *args
+)
+{
+  struct ifaddrs_snapshot *stale;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  (void) netif;
+  (void) reason;
+  (void) args;
+
+  SYS_ARCH_PROTECT(lev);
+  ++ifaddrs_generation;
+  stale = ifaddrs_current;
+  ifaddrs_current = NULL;
+  SYS_ARCH_UNPROTECT(lev);
+
+  if ( stale != NULL ) {
+    ifaddrs_snapshot_release(stale);
+  }
+}
+
+static unsigned int ifaddrs_netif_flags(struct netif *netif)
+{
+  unsigned int flags = 0;
 
-  ifaddr->ifa_flags = 0;
   if ( netif->flags & NETIF_FLAG_UP ) {
-    ifaddr->ifa_flags |= IFF_RUNNING;
+    flags |= IFF_RUNNING;
   }
   if ( netif->flags & NETIF_FLAG_LINK_UP ) {
-    ifaddr->ifa_flags |= IFF_UP;
+    flags |= IFF_UP;
   }
   if ( netif->flags & NETIF_FLAG_BROADCAST ) {
-    ifaddr->ifa_flags |= IFF_BROADCAST;
+    flags |= IFF_BROADCAST;
+  }
+  if ( netif->flags & (NETIF_FLAG_IGMP | NETIF_FLAG_MLD6) ) {
+    flags |= IFF_MULTICAST;
+  }
+  if ( netif->name[0] == 'l' && netif->name[1] == 'o' ) {
+    flags |= IFF_LOOPBACK;
+  }
+
+  return flags;
+}
+
+static size_t ifaddrs_count_netif_entries(struct netif *netif)
+{
+  size_t count = 0;
+#if LWIP_IPV6
+  int i;
+#endif
+
+#if LWIP_IPV4
+  count++;
+#endif
+#if LWIP_IPV6
+  for ( i = 0; i < LWIP_IPV6_NUM_ADDRESSES; i++ ) {
+    if ( ip6_addr_isvalid(netif_ip6_addr_state(netif, i)) ) {
+      count++;
+    }
   }
+#endif
 
-  ifaddr->ifa_addr = malloc(sizeof(struct sockaddr));
-  ifaddr->ifa_netmask = malloc(sizeof(struct sockaddr));
-  ifaddr->ifa_dstaddr = malloc(sizeof(struct sockaddr));
-  if ( ifaddr->ifa_addr == NULL
-       || ifaddr->ifa_netmask == NULL
-       || ifaddr->ifa_dstaddr == NULL ) {
-    freeifaddrs(ifaddr);
+  return count;
+}
+
+static void ifaddrs_update_netif_data(
+  struct ifaddrs_netif_data *netif_data,
+  struct netif *netif
+)
+{
+  struct if_data *data = &netif_data->data;
+
+  memset(data, 0, sizeof(*data));
+  data->ifi_mtu = netif->mtu;
+  data->ifi_addrlen = netif->hwaddr_len;
+  data->ifi_link_state = netif_is_link_up(netif) ?
+    LINK_STATE_UP : LINK_STATE_DOWN;
+#if MIB2_STATS
+  data->ifi_type = netif->link_type;
+  data->ifi_baudrate = netif->link_speed;
+  data->ifi_ipackets = netif->mib2_counters.ifinucastpkts +
+    netif->mib2_counters.ifinnucastpkts;
+  data->ifi_ierrors = netif->mib2_counters.ifinerrors;
+  data->ifi_opackets = netif->mib2_counters.ifoutucastpkts +
+    netif->mib2_counters.ifoutnucastpkts;
+  data->ifi_oerrors = netif->mib2_counters.ifouterrors;
+  data->ifi_ibytes = netif->mib2_counters.ifinoctets;
+  data->ifi_obytes = netif->mib2_counters.ifoutoctets;
+  data->ifi_imcasts = netif->mib2_counters.ifinnucastpkts;
+  data->ifi_omcasts = netif->mib2_counters.ifoutnucastpkts;
+  data->ifi_iqdrops = netif->mib2_counters.ifindiscards;
+  data->ifi_oqdrops = netif->mib2_counters.ifoutdiscards;
+  data->ifi_noproto = netif->mib2_counters.ifinunknownprotos;
+#endif
+}
+
+static struct ifaddrs_entry *ifaddrs_add_entry(
+  struct ifaddrs_snapshot *snapshot,
+  struct ifaddrs_netif_data *netif_data,
+  struct netif *netif
+)
+{
+  struct ifaddrs_entry *entry = &snapshot->entries[snapshot->entry_count];
+
+  if ( snapshot->entry_count > 0 ) {
+    snapshot->entries[snapshot->entry_count - 1].ifaddr.ifa_next =
+      &entry->ifaddr;
+  }
+  snapshot->entry_count++;
+
+  entry->netif_index = netif_get_index(netif);
+  entry->ifaddr.ifa_next = NULL;
+  entry->ifaddr.ifa_name = netif_data->name;
+  entry->ifaddr.ifa_flags = ifaddrs_netif_flags(netif);
+  entry->ifaddr.ifa_addr = &entry->addr.sa;
+  entry->ifaddr.ifa_netmask = &entry->netmask.sa;
+  entry->ifaddr.ifa_dstaddr = NULL;
+  entry->ifaddr.ifa_data = &netif_data->data;
+
+  return entry;
+}
+
+#if LWIP_IPV4
+static void ifaddrs_fill_ip4(struct ifaddrs_entry *entry, struct netif *netif)
+{
+  const ip4_addr_t *addr = netif_ip4_addr(netif);
+  const ip4_addr_t *netmask = netif_ip4_netmask(netif);
+
+  entry->addr.sin.sin_len = sizeof(entry->addr.sin);
+  entry->addr.sin.sin_family = AF_INET;
+  entry->addr.sin.sin_addr.s_addr = ip4_addr_get_u32(addr);
+
+  entry->netmask.sin.sin_len = sizeof(entry->netmask.sin);
+  entry->netmask.sin.sin_family = AF_INET;
+  entry->netmask.sin.sin_addr.s_addr = ip4_addr_get_u32(netmask);
+
+  if ( netif->flags & NETIF_FLAG_BROADCAST ) {
+    entry->dstaddr.sin.sin_len = sizeof(entry->dstaddr.sin);
+    entry->dstaddr.sin.sin_family = AF_INET;
+    entry->dstaddr.sin.sin_addr.s_addr =
+      ip4_addr_get_u32(addr) | ~ip4_addr_get_u32(netmask);
+    entry->ifaddr.ifa_broadaddr = &entry->dstaddr.sa;
+  }
+}
+#endif
+
+#if LWIP_IPV6
+static void ifaddrs_fill_ip6(
+  struct ifaddrs_entry *entry,
+  struct netif *netif,
+  int addr_index
+)
+{
+  const ip6_addr_t *addr = netif_ip6_addr(netif, addr_index);
+  int prefix_bits = 64;
+  int i;
+
+  entry->addr.sin6.sin6_len = sizeof(entry->addr.sin6);
+  entry->addr.sin6.sin6_family = AF_INET6;
+  memcpy(&entry->addr.sin6.sin6_addr, addr->addr, sizeof(addr->addr));
+  if ( ip6_addr_islinklocal(addr) ) {
+    entry->addr.sin6.sin6_scope_id = netif_get_index(netif);
+  }
+
+  /* lwIP only supports /64 prefixes for autoconfigured addresses */
+  entry->netmask.sin6.sin6_len = sizeof(entry->netmask.sin6);
+  entry->netmask.sin6.sin6_family = AF_INET6;
+  for ( i = 0; i < prefix_bits / 8; i++ ) {
+    entry->netmask.sin6.sin6_addr.s6_addr[i] = 0xff;
+  }
+}
+#endif
+
+static struct ifaddrs_snapshot *ifaddrs_snapshot_create(void)
+{
+  struct ifaddrs_snapshot *snapshot;
+  struct ifaddrs_netif_data *netif_data;
+  struct netif *netif;
+  size_t entry_count = 0;
+  size_t netif_count = 0;
+  size_t entries_size;
+
+  NETIF_FOREACH(netif) {
+    entry_count += ifaddrs_count_netif_entries(netif);
+    netif_count++;
+  }
+
+  /* Everything lives in one allocation which freeifaddrs() releases at once */
+  entries_size = sizeof(*snapshot) + entry_count * sizeof(struct ifaddrs_entry);
+  snapshot = calloc(1, entries_size + netif_count * sizeof(*netif_data));
+  if ( snapshot == NULL ) {
     return NULL;
   }
 
-  ifaddr->ifa_addr->sa_family = AF_INET;
-  ifaddr->ifa_netmask->sa_family = AF_INET;
-  ifaddr->ifa_dstaddr->sa_family = AF_INET;
-#define inet_addr_from_ip4addr(target_inaddr, source_ipaddr) ((target_inaddr)->s_addr = ip4_addr_get_u32(source_ipaddr))
-  inet_addr_from_ip4addr(&((struct sockaddr_in *)ifaddr->ifa_addr)->sin_addr, &netif->ip_addr.u_addr.ip4);
-  inet_addr_from_ip4addr(&((struct sockaddr_in *)ifaddr->ifa_netmask)->sin_addr, &netif->netmask.u_addr.ip4);
-  ((struct sockaddr_in *)ifaddr->ifa_netmask)->sin_addr.s_addr = netif->ip_addr.u_addr.ip4.addr & netif->netmask.u_addr.ip4.addr;
+  snapshot->refcount = 1;
+  snapshot->generation = ifaddrs_generation;
+  snapshot->netif_data = (struct ifaddrs_netif_data *)
+    ((char *) snapshot + entries_size);
+
+  netif_data = snapshot->netif_data;
+  NETIF_FOREACH(netif) {
+    struct ifaddrs_entry *entry;
+#if LWIP_IPV6
+    int i;
+#endif
+
+    netif_data->netif_index = netif_get_index(netif);
+    snprintf(
+      netif_data->name,
+      sizeof(netif_data->name),
+      "%c%c%u",
+      netif->name[0],
+      netif->name[1],
+      netif->num
+    );
+    ifaddrs_update_netif_data(netif_data, netif);
 
-  /* Set IFF_LOOPBACK flag if appropriate */
-  if (127 != (ip4_addr_get_u32(&netif->ip_addr.u_addr.ip4) >> 24)) {
-    ifaddr->ifa_flags |= IFF_LOOPBACK;
+#if LWIP_IPV4
+    entry = ifaddrs_add_entry(snapshot, netif_data, netif);
+    ifaddrs_fill_ip4(entry, netif);
+#endif
+#if LWIP_IPV6
+    for ( i = 0; i < LWIP_IPV6_NUM_ADDRESSES; i++ ) {
+      if ( !ip6_addr_isvalid(netif_ip6_addr_state(netif, i)) ) {
+        continue;
+      }
+      entry = ifaddrs_add_entry(snapshot, netif_data, netif);
+      ifaddrs_fill_ip6(entry, netif, i);
+    }
+#endif
+    (void) entry;
+    netif_data++;
+    snapshot->netif_count++;
   }
 
-  return ifaddr;
+  return snapshot;
+}
+
+/*
+ * Counters change with every packet and do not trigger a netif callback, so
+ * they are refreshed whenever the snapshot is handed out again. A snapshot is
+ * only written while the cache holds the sole reference to it. Callers read
+ * ifa_data without any lock, so a snapshot still held by one of them is left
+ * untouched and replaced in the cache by a fresh one.
+ */
+static void ifaddrs_snapshot_refresh(struct ifaddrs_snapshot *snapshot)
+{
+  size_t i;
+
+  for ( i = 0; i < snapshot->netif_count; i++ ) {
+    struct ifaddrs_netif_data *netif_data = &snapshot->netif_data[i];
+    struct netif *netif = netif_get_by_index(netif_data->netif_index);
+
+    if ( netif != NULL ) {
+      ifaddrs_update_netif_data(netif_data, netif);
+    }
+  }
+}
+
+static void ifaddrs_snapshot_install(struct ifaddrs_snapshot *snapshot)
+{
+  struct ifaddrs_snapshot *stale = NULL;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  if ( snapshot->generation == ifaddrs_generation ) {
+    /* One reference for the cache and one for the caller */
+    snapshot->refcount++;
+    stale = ifaddrs_current;
+    ifaddrs_current = snapshot;
+  }
+  SYS_ARCH_UNPROTECT(lev);
+
+  if ( stale != NULL ) {
+    ifaddrs_snapshot_release(stale);
+  }
 }
 
 int getifaddrs(struct ifaddrs **ifaddrs)
 {
-  struct netif *netif;
+  struct ifaddrs_snapshot *snapshot;
+  bool exclusive = false;
+  SYS_ARCH_DECL_PROTECT(lev);
+
   *ifaddrs = NULL;
 
   LWIP_ASSERT_CORE_LOCKED();
 
-  NETIF_FOREACH(netif) {
-    /* create ifaddr from netif */
-    struct ifaddrs *ifaddr = create_ifaddr_from_netif(netif);
-    if ( ifaddr == NULL ) {
-      freeifaddrs(*ifaddrs);
-      *ifaddrs = NULL;
+  if ( !ifaddrs_callback_registered ) {
+    netif_add_ext_callback(&ifaddrs_netif_callback, ifaddrs_invalidate);
+    ifaddrs_callback_registered = true;
+  }
+
+  SYS_ARCH_PROTECT(lev);
+  snapshot = ifaddrs_current;
+  if ( snapshot != NULL ) {
+    exclusive = snapshot->refcount == 1;
+    snapshot->refcount++;
+  }
+  SYS_ARCH_UNPROTECT(lev);
+
+  /*
+   * Only getifaddrs() hands out references and it runs with the core locked,
+   * so an exclusive snapshot stays exclusive while it is refreshed.
+   */
+  if ( snapshot != NULL && exclusive ) {
+    ifaddrs_snapshot_refresh(snapshot);
+  } else {
+    if ( snapshot != NULL ) {
+      ifaddrs_snapshot_release(snapshot);
+    }
+
+    snapshot = ifaddrs_snapshot_create();
+    if ( snapshot == NULL ) {
       errno = ENOMEM;
       return -1;
     }
-    ifaddr->ifa_next = *ifaddrs;
-    *ifaddrs = ifaddr;
+
+    ifaddrs_snapshot_install(snapshot);
+  }
+
+  if ( snapshot->entry_count == 0 ) {
+    ifaddrs_snapshot_release(snapshot);
+    return 0;
   }
 
+  *ifaddrs = &snapshot->entries[0].ifaddr;
   return 0;
 }
 
 void freeifaddrs(struct ifaddrs *ifaddrs)
 {
-  struct ifaddrs *ifaddr;
-  while ( ifaddrs != NULL ) {
-    ifaddr = ifaddrs;
-    ifaddrs = ifaddrs->ifa_next;
-    free(ifaddr->ifa_addr);
-    free(ifaddr->ifa_netmask);
-    free(ifaddr->ifa_dstaddr);
-    free(ifaddr);
+  struct ifaddrs_snapshot *snapshot;
+
+  if ( ifaddrs == NULL ) {
+    return;
   }
+
+  snapshot = (struct ifaddrs_snapshot *)
+    ((char *) ifaddrs - offsetof(struct ifaddrs_snapshot, entries));
+  ifaddrs_snapshot_release(snapshot);
 }
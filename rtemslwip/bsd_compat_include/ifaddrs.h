@@ -34,6 +34,7 @@ struct ifaddrs {
 	struct sockaddr	*ifa_netmask;
 	struct sockaddr	*ifa_dstaddr;
 #define	ifa_broadaddr	ifa_dstaddr	/* broadcast address interface */
+	void		*ifa_data;	/* struct if_data with interface counters */
 };
 
 int getifaddrs(struct ifaddrs **);
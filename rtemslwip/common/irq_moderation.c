@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/opt.h>
+#include <lwip/debug.h>
+#include <lwip/def.h>
+#include <lwip/sys.h>
+
+#include <string.h>
+
+#include <irq_moderation.h>
+
+void irq_moderation_init(struct irq_moderation *mod)
+{
+  static const struct irq_moderation_policy policy = {
+    .sample_ms = LWIP_IRQ_MODERATION_SAMPLE_MS,
+    .low_pps = LWIP_IRQ_MODERATION_LOW_PPS,
+    .high_pps = LWIP_IRQ_MODERATION_HIGH_PPS,
+    .min_usecs = LWIP_IRQ_MODERATION_MIN_USECS,
+    .max_usecs = LWIP_IRQ_MODERATION_MAX_USECS
+  };
+
+  memset(&mod->stats, 0, sizeof(mod->stats));
+  irq_moderation_set_policy(mod, &policy);
+}
+
+void irq_moderation_set_policy(
+  struct irq_moderation              *mod,
+  const struct irq_moderation_policy *policy
+)
+{
+  mod->policy = *policy;
+  if (mod->policy.sample_ms == 0) {
+    mod->policy.sample_ms = 1;
+  }
+  if (mod->policy.min_usecs == 0) {
+    mod->policy.min_usecs = 1;
+  }
+  if (mod->policy.max_usecs < mod->policy.min_usecs) {
+    mod->policy.max_usecs = mod->policy.min_usecs;
+  }
+  mod->sample_start = sys_now();
+  mod->sample_packets = 0;
+}
+
+int irq_moderation_update(struct irq_moderation *mod, u32_t packets)
+{
+  const struct irq_moderation_policy *policy = &mod->policy;
+  struct irq_moderation_stats *stats = &mod->stats;
+  u32_t now = sys_now();
+  u32_t elapsed = now - mod->sample_start;
+  u32_t usecs;
+
+  stats->packets += packets;
+  mod->sample_packets += packets;
+  if (elapsed < policy->sample_ms) {
+    return 0;
+  }
+
+  stats->pps = (u32_t) ((uint64_t) mod->sample_packets * 1000 / elapsed);
+  mod->sample_start = now;
+  mod->sample_packets = 0;
+
+  if (stats->pps >= policy->high_pps && stats->usecs < policy->max_usecs) {
+    usecs = stats->usecs == 0 ? policy->min_usecs : stats->usecs * 2U;
+    stats->usecs = (u16_t) LWIP_MIN(usecs, policy->max_usecs);
+    stats->raised++;
+    return 1;
+  }
+  if (stats->pps < policy->low_pps && stats->usecs != 0) {
+    stats->usecs = 0;
+    stats->lowered++;
+    return 1;
+  }
+  return 0;
+}
+
+void irq_moderation_stats_display(
+  const char                  *name,
+  const struct irq_moderation *mod
+)
+{
+  const struct irq_moderation_stats *stats = &mod->stats;
+
+  LWIP_UNUSED_ARG(name);
+  LWIP_UNUSED_ARG(stats);
+  LWIP_PLATFORM_DIAG(("\nIRQ MODERATION %s\n\t", name));
+  LWIP_PLATFORM_DIAG(("interrupts: %"U32_F"\n\t", stats->interrupts));
+  LWIP_PLATFORM_DIAG(("packets: %"U32_F"\n\t", stats->packets));
+  LWIP_PLATFORM_DIAG(("raised: %"U32_F"\n\t", stats->raised));
+  LWIP_PLATFORM_DIAG(("lowered: %"U32_F"\n\t", stats->lowered));
+  LWIP_PLATFORM_DIAG(("pps: %"U32_F"\n\t", stats->pps));
+  LWIP_PLATFORM_DIAG(("usecs: %"U16_F" (%"U16_F"..%"U16_F")\n",
+    stats->usecs, mod->policy.min_usecs, mod->policy.max_usecs));
+}
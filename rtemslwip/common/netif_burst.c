@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/opt.h>
+#include <lwip/ip.h>
+#include <lwip/stats.h>
+#include <lwip/tcpip.h>
+#include <netif/ethernet.h>
+
+#include <netif_burst.h>
+#include <netif_gro.h>
+
+static struct pbuf *burst_packet_end(struct pbuf *p)
+{
+  while (p->len != p->tot_len) {
+    p = p->next;
+  }
+  return p;
+}
+
+u16_t netif_burst_add(struct netif_burst *burst, struct pbuf *p)
+{
+  struct pbuf *end = burst_packet_end(p);
+
+  /*
+   * Empty pbufs after the last byte would be taken for the packets that
+   * follow, so they are dropped here while the packet still ends in NULL.
+   */
+  if (end->next != NULL) {
+    pbuf_free(end->next);
+    end->next = NULL;
+  }
+  if (burst->head == NULL) {
+    burst->head = p;
+  } else {
+    burst->tail->next = p;
+  }
+  burst->tail = end;
+  return ++burst->count;
+}
+
+/* Splits the list and feeds each packet to input_fn */
+static void burst_input(
+  struct pbuf    *p,
+  struct netif   *netif,
+  netif_input_fn  input_fn
+)
+{
+#if LWIP_GRO && LWIP_ETHERNET
+  if (input_fn == ethernet_input) {
+    p = netif_gro(p, netif);
+  }
+#endif
+  while (p != NULL) {
+    struct pbuf *end = burst_packet_end(p);
+    struct pbuf *next = end->next;
+
+    end->next = NULL;
+    if (input_fn(p, netif) != ERR_OK) {
+      LWIP_DEBUGF(NETIF_DEBUG, ("netif_input_burst: input error\n"));
+      pbuf_free(p);
+    }
+    p = next;
+  }
+}
+
+#if !NO_SYS
+/* Runs in the tcpip_thread or with the core lock held */
+static err_t burst_tcpip_input(struct pbuf *p, struct netif *netif)
+{
+#if LWIP_ETHERNET
+  if (netif->flags & (NETIF_FLAG_ETHARP | NETIF_FLAG_ETHERNET)) {
+    burst_input(p, netif, ethernet_input);
+  } else
+#endif
+  {
+    burst_input(p, netif, ip_input);
+  }
+  return ERR_OK;
+}
+#endif
+
+err_t netif_input_burst(struct pbuf *p, struct netif *netif)
+{
+#if !NO_SYS
+  if (netif->input == tcpip_input) {
+    return tcpip_inpkt(p, netif, burst_tcpip_input);
+  }
+#endif
+  burst_input(p, netif, netif->input);
+  return ERR_OK;
+}
+
+err_t netif_burst_flush(struct netif_burst *burst, struct netif *netif)
+{
+  err_t err = ERR_OK;
+
+  if (burst->head != NULL) {
+    err = netif_input_burst(burst->head, netif);
+    if (err != ERR_OK) {
+      u16_t i;
+
+      for (i = 0; i < burst->count; i++) {
+        LINK_STATS_INC(link.memerr);
+        LINK_STATS_INC(link.drop);
+      }
+      pbuf_free(burst->head);
+    }
+  }
+  netif_burst_init(burst);
+  return err;
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/opt.h>
+#include <lwip/def.h>
+#include <lwip/inet_chksum.h>
+#include <lwip/ip.h>
+#include <lwip/prot/ethernet.h>
+#include <lwip/prot/ip4.h>
+#include <lwip/prot/tcp.h>
+
+#include <string.h>
+
+#include <netif_burst.h>
+#include <netif_gro.h>
+
+#if LWIP_GRO
+
+/* A TCP segment as seen by netif_gro() */
+struct gro_seg {
+  struct ip_hdr  *iphdr;
+  struct tcp_hdr *tcphdr;
+  u16_t           hlen;   /* Link, IP and TCP headers */
+  u16_t           len;    /* TCP payload */
+  u32_t           seqno;
+};
+
+static struct netif_gro_stats gro_stats;
+
+/* Whether tcp_input() takes the TCP checksums of the netif as verified */
+static int gro_netif_verifies(const struct netif *netif)
+{
+#if CHECKSUM_CHECK_TCP
+#if LWIP_CHECKSUM_CTRL_PER_NETIF
+  return (netif->chksum_flags & NETIF_CHECKSUM_CHECK_TCP) == 0;
+#else
+  LWIP_UNUSED_ARG(netif);
+  return 0;
+#endif
+#else
+  LWIP_UNUSED_ARG(netif);
+  return 1;
+#endif
+}
+
+/* Returns 1 and fills in seg if p is a TCP segment that may be merged */
+static int gro_parse(struct pbuf *p, struct gro_seg *seg)
+{
+  struct eth_hdr *ethhdr = (struct eth_hdr *)p->payload;
+  u16_t iplen;
+  u16_t tcphlen;
+
+#ifdef __rtems__
+  if ((p->flags & PBUF_FLAG_CHKSUM_SW) != 0) {
+    return 0;
+  }
+#endif
+  if ((p->len < SIZEOF_ETH_HDR + IP_HLEN + TCP_HLEN) ||
+      (ethhdr->type != PP_HTONS(ETHTYPE_IP)) ||
+      ((ethhdr->dest.addr[0] & 1) != 0)) {
+    return 0;
+  }
+
+  seg->iphdr = (struct ip_hdr *)((u8_t *)p->payload + SIZEOF_ETH_HDR);
+  iplen = lwip_ntohs(IPH_LEN(seg->iphdr));
+  if ((IPH_V(seg->iphdr) != 4) || (IPH_HL_BYTES(seg->iphdr) != IP_HLEN) ||
+      (IPH_PROTO(seg->iphdr) != IP_PROTO_TCP) ||
+      ((IPH_OFFSET(seg->iphdr) & PP_HTONS(IP_OFFMASK | IP_MF)) != 0) ||
+      (p->tot_len != SIZEOF_ETH_HDR + iplen)) {
+    return 0;
+  }
+
+  seg->tcphdr = (struct tcp_hdr *)((u8_t *)seg->iphdr + IP_HLEN);
+  tcphlen = TCPH_HDRLEN_BYTES(seg->tcphdr);
+  seg->hlen = (u16_t)(SIZEOF_ETH_HDR + IP_HLEN + tcphlen);
+  if ((tcphlen < TCP_HLEN) || (p->len < seg->hlen) ||
+      (iplen <= IP_HLEN + tcphlen) ||
+      ((TCPH_FLAGS(seg->tcphdr) & ~TCP_PSH) != TCP_ACK)) {
+    return 0;
+  }
+  seg->len = (u16_t)(iplen - IP_HLEN - tcphlen);
+  seg->seqno = lwip_ntohl(seg->tcphdr->seqno);
+  return 1;
+}
+
+/* Returns 1 if seg continues the flow of held */
+static int gro_match(const struct gro_seg *held, const struct gro_seg *seg)
+{
+  const u8_t *held_eth = (const u8_t *)held->iphdr - SIZEOF_ETH_HDR;
+  const u8_t *seg_eth = (const u8_t *)seg->iphdr - SIZEOF_ETH_HDR;
+
+  return (seg->seqno == held->seqno + held->len) &&
+         (seg->hlen == held->hlen) &&
+         (memcmp(held_eth, seg_eth, 2 * ETH_HWADDR_LEN + ETH_PAD_SIZE) == 0) &&
+         (IPH_TOS(seg->iphdr) == IPH_TOS(held->iphdr)) &&
+         (IPH_TTL(seg->iphdr) == IPH_TTL(held->iphdr)) &&
+         ip4_addr_cmp(&seg->iphdr->src, &held->iphdr->src) &&
+         ip4_addr_cmp(&seg->iphdr->dest, &held->iphdr->dest) &&
+         (seg->tcphdr->src == held->tcphdr->src) &&
+         (seg->tcphdr->dest == held->tcphdr->dest) &&
+         (seg->tcphdr->ackno == held->tcphdr->ackno) &&
+         (seg->tcphdr->wnd == held->tcphdr->wnd) &&
+         (memcmp(seg->tcphdr + 1, held->tcphdr + 1,
+            seg->hlen - SIZEOF_ETH_HDR - IP_HLEN - TCP_HLEN) == 0);
+}
+
+/* Completes the headers of a merged packet and appends it to out */
+static void gro_flush(
+  struct netif_burst   *out,
+  struct pbuf          *p,
+  const struct gro_seg *held,
+  u32_t                 len
+)
+{
+  u16_t iplen = (u16_t)(held->hlen - SIZEOF_ETH_HDR + len);
+
+  if (IPH_LEN(held->iphdr) != lwip_htons(iplen)) {
+    /* ip4_input() may still check the header checksum */
+    IPH_LEN_SET(held->iphdr, lwip_htons(iplen));
+    IPH_CHKSUM_SET(held->iphdr, 0);
+    IPH_CHKSUM_SET(held->iphdr, inet_chksum(held->iphdr, IP_HLEN));
+  }
+  netif_burst_add(out, p);
+  gro_stats.packets++;
+}
+
+struct pbuf *netif_gro(struct pbuf *p, struct netif *netif)
+{
+  struct netif_burst out;
+  struct pbuf *held = NULL;
+  struct gro_seg held_seg;
+  struct gro_seg seg;
+  u32_t held_len = 0;
+
+  if (!gro_netif_verifies(netif)) {
+    return p;
+  }
+
+  netif_burst_init(&out);
+  while (p != NULL) {
+    struct pbuf *end = p;
+    struct pbuf *next;
+
+    while (end->len != end->tot_len) {
+      end = end->next;
+    }
+    next = end->next;
+    end->next = NULL;
+
+    if (!gro_parse(p, &seg)) {
+      if (held != NULL) {
+        gro_flush(&out, held, &held_seg, held_len);
+        held = NULL;
+      }
+      netif_burst_add(&out, p);
+      gro_stats.packets++;
+    } else if ((held != NULL) &&
+               (held->tot_len + seg.len <= LWIP_GRO_MAX_SIZE) &&
+               gro_match(&held_seg, &seg)) {
+      TCPH_SET_FLAG(held_seg.tcphdr, TCPH_FLAGS(seg.tcphdr) & TCP_PSH);
+      pbuf_remove_header(p, seg.hlen);
+      pbuf_cat(held, p);
+      held_seg.seqno = seg.seqno;
+      held_len += seg.len;
+      held_seg.len = seg.len;
+      gro_stats.merged++;
+    } else {
+      if (held != NULL) {
+        gro_flush(&out, held, &held_seg, held_len);
+      }
+      held = p;
+      held_seg = seg;
+      held_len = seg.len;
+    }
+
+    /* The sender wants PSH segments delivered without waiting */
+    if ((held != NULL) && ((TCPH_FLAGS(held_seg.tcphdr) & TCP_PSH) != 0)) {
+      gro_flush(&out, held, &held_seg, held_len);
+      held = NULL;
+    }
+    p = next;
+  }
+  if (held != NULL) {
+    gro_flush(&out, held, &held_seg, held_len);
+  }
+  return out.head;
+}
+
+void netif_gro_get_stats(struct netif_gro_stats *stats)
+{
+  *stats = gro_stats;
+}
+
+#endif /* LWIP_GRO */
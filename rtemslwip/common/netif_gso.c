@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/opt.h>
+#include <lwip/def.h>
+#include <lwip/inet_chksum.h>
+#include <lwip/ip.h>
+#include <lwip/snmp.h>
+#include <lwip/stats.h>
+#include <lwip/prot/ethernet.h>
+#include <lwip/prot/ip4.h>
+
+#include <string.h>
+
+#include <netif_gso.h>
+
+#if LWIP_GSO
+
+/* Room for the link and IP headers replicated for each segment */
+#define GSO_HDR_MAX (SIZEOF_ETH_HDR + SIZEOF_VLAN_HDR + IP_HLEN_MAX)
+
+static struct netif_gso_stats gso_stats;
+
+u16_t netif_gso_count(struct pbuf *p)
+{
+  u16_t count = 0;
+
+  while (p != NULL) {
+    p = netif_gso_segment_end(p)->next;
+    count++;
+  }
+  return count;
+}
+
+void netif_gso_truncate(struct pbuf *p)
+{
+  netif_gso_segment_end(p)->next = NULL;
+}
+
+err_t netif_gso_output(struct netif *netif, struct pbuf *p)
+{
+  u8_t hdr[GSO_HDR_MAX];
+  struct pbuf *first = p;
+  struct eth_hdr *ethhdr = (struct eth_hdr *)p->payload;
+  struct ip_hdr *iphdr;
+  u16_t link_hlen = SIZEOF_ETH_HDR;
+  u16_t hlen;
+  u16_t id;
+  err_t err = ERR_OK;
+
+  if (ethhdr->type == PP_HTONS(ETHTYPE_VLAN)) {
+    link_hlen += SIZEOF_VLAN_HDR;
+  }
+  iphdr = (struct ip_hdr *)((u8_t *)p->payload + link_hlen);
+  hlen = (u16_t)(link_hlen + IPH_HL_BYTES(iphdr));
+  id = lwip_ntohs(IPH_ID(iphdr));
+  LWIP_ASSERT("netif_gso_output: headers not in first pbuf", p->len >= hlen);
+  /* The driver may still move the payload of a frame it was given */
+  MEMCPY(hdr, p->payload, hlen);
+  iphdr = (struct ip_hdr *)&hdr[link_hlen];
+
+  gso_stats.packets++;
+  while (p != NULL) {
+    struct pbuf *end = netif_gso_segment_end(p);
+    struct pbuf *next = end->next;
+
+    end->next = NULL;
+    if (p != first) {
+      if (pbuf_add_header(p, hlen) != 0) {
+        LINK_STATS_INC(link.lenerr);
+        err = ERR_BUF;
+        break;
+      }
+      IPH_LEN_SET(iphdr, lwip_htons((u16_t)(p->tot_len - link_hlen)));
+      IPH_ID_SET(iphdr, lwip_htons(++id));
+      IPH_CHKSUM_SET(iphdr, 0);
+#if CHECKSUM_GEN_IP
+      IF__NETIF_CHECKSUM_ENABLED(netif, NETIF_CHECKSUM_GEN_IP) {
+        IPH_CHKSUM_SET(iphdr, inet_chksum(iphdr, (u16_t)(hlen - link_hlen)));
+      }
+#endif /* CHECKSUM_GEN_IP */
+      MEMCPY(p->payload, hdr, hlen);
+      IP_STATS_INC(ip.xmit);
+      MIB2_STATS_INC(mib2.ipoutrequests);
+    }
+
+    err = netif->linkoutput(netif, p);
+    if (err != ERR_OK) {
+      break;
+    }
+    p->flags = (u8_t)(p->flags & ~PBUF_FLAG_GSO);
+    gso_stats.segments++;
+    p = next;
+  }
+  return err;
+}
+
+void netif_gso_get_stats(struct netif_gso_stats *stats)
+{
+  *stats = gso_stats;
+}
+
+#endif /* LWIP_GSO */
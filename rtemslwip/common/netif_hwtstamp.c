@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/opt.h>
+#include <lwip/sys.h>
+
+#include <netif_hwtstamp.h>
+
+#if LWIP_HWTSTAMP
+
+/* A transmit timestamp request of a socket */
+struct hwtstamp_tx_slot {
+  int   s;
+  u16_t id;      /* 0 while the slot is unused */
+  u8_t  done;
+  u32_t sec;
+  u32_t nsec;
+};
+
+static struct hwtstamp_tx_slot tx_slots[LWIP_HWTSTAMP_TX_SLOTS];
+static u16_t tx_last_id;
+
+err_t netif_phc_gettime(struct netif *netif, struct timespec *ts)
+{
+  if (netif == NULL || netif->phc == NULL || netif->phc->gettime == NULL) {
+    return ERR_IF;
+  }
+  return netif->phc->gettime(netif, ts);
+}
+
+err_t netif_phc_settime(struct netif *netif, const struct timespec *ts)
+{
+  if (netif == NULL || netif->phc == NULL || netif->phc->settime == NULL) {
+    return ERR_IF;
+  }
+  if (ts->tv_sec < 0 || ts->tv_nsec < 0 || ts->tv_nsec >= 1000000000) {
+    return ERR_VAL;
+  }
+  return netif->phc->settime(netif, ts);
+}
+
+err_t netif_phc_adjtime(struct netif *netif, s64_t delta_ns)
+{
+  if (netif == NULL || netif->phc == NULL || netif->phc->adjtime == NULL) {
+    return ERR_IF;
+  }
+  return netif->phc->adjtime(netif, delta_ns);
+}
+
+err_t netif_phc_adjfreq(struct netif *netif, s32_t ppb)
+{
+  if (netif == NULL || netif->phc == NULL || netif->phc->adjfreq == NULL) {
+    return ERR_IF;
+  }
+  return netif->phc->adjfreq(netif, ppb);
+}
+
+u16_t netif_hwtstamp_tx_request(int s)
+{
+  struct hwtstamp_tx_slot *slot;
+  u16_t id;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  id = ++tx_last_id;
+  if (id == 0) {
+    id = ++tx_last_id;
+  }
+  slot = &tx_slots[id % LWIP_HWTSTAMP_TX_SLOTS];
+  slot->s = s;
+  slot->id = id;
+  slot->done = 0;
+  SYS_ARCH_UNPROTECT(lev);
+  return id;
+}
+
+void netif_hwtstamp_tx_done(u16_t id, u32_t sec, u32_t nsec)
+{
+  struct hwtstamp_tx_slot *slot = &tx_slots[id % LWIP_HWTSTAMP_TX_SLOTS];
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  /* The request may have been replaced or released in the meantime */
+  if (id != 0 && slot->id == id) {
+    slot->done = 1;
+    slot->sec = sec;
+    slot->nsec = nsec;
+  }
+  SYS_ARCH_UNPROTECT(lev);
+}
+
+int netif_hwtstamp_tx_take(int s, struct timespec *ts)
+{
+  struct hwtstamp_tx_slot *oldest = NULL;
+  u16_t age, oldest_age = 0;
+  int i;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  for (i = 0; i < LWIP_HWTSTAMP_TX_SLOTS; i++) {
+    struct hwtstamp_tx_slot *slot = &tx_slots[i];
+
+    if (slot->id == 0 || slot->done == 0 || slot->s != s) {
+      continue;
+    }
+    age = (u16_t)(tx_last_id - slot->id);
+    if (oldest == NULL || age > oldest_age) {
+      oldest = slot;
+      oldest_age = age;
+    }
+  }
+  if (oldest != NULL) {
+    ts->tv_sec = oldest->sec;
+    ts->tv_nsec = oldest->nsec;
+    oldest->id = 0;
+  }
+  SYS_ARCH_UNPROTECT(lev);
+  return oldest != NULL;
+}
+
+void netif_hwtstamp_tx_release(int s)
+{
+  int i;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  for (i = 0; i < LWIP_HWTSTAMP_TX_SLOTS; i++) {
+    if (tx_slots[i].s == s) {
+      tx_slots[i].id = 0;
+    }
+  }
+  SYS_ARCH_UNPROTECT(lev);
+}
+
+#endif /* LWIP_HWTSTAMP */
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/sys.h>
+#include <rtems/rtems/cache.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <rxpool.h>
+
+#if LWIP_RX_POOL
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "LWIP_RX_POOL requires LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+#define RXPOOL_ALIGN(size, align) (((size) + (align) - 1) & ~((align) - 1))
+
+static void rxpool_free(struct pbuf *p)
+{
+  struct rxpool_buf *buf = (struct rxpool_buf *) p;
+  struct rxpool *pool = buf->pool;
+  bool was_empty;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  was_empty = pool->free_list == NULL;
+  buf->next = pool->free_list;
+  pool->free_list = buf;
+  pool->stats.free++;
+  SYS_ARCH_UNPROTECT(lev);
+
+  if ( was_empty && pool->recycle != NULL ) {
+    (*pool->recycle)(pool->recycle_arg);
+  }
+}
+
+static size_t rxpool_line_size(void)
+{
+  size_t line = rtems_cache_get_data_line_size();
+
+  return line < MEM_ALIGNMENT ? MEM_ALIGNMENT : line;
+}
+
+/*
+ * The struct pbuf and the payload never share a cache line, so the payload
+ * can be invalidated while the stack still owns the pbuf.
+ */
+static size_t rxpool_header_size(void)
+{
+  return RXPOOL_ALIGN(sizeof(struct rxpool_buf), rxpool_line_size());
+}
+
+static size_t rxpool_stride(u16_t buf_size)
+{
+  return rxpool_header_size() +
+    RXPOOL_ALIGN((size_t) buf_size, rxpool_line_size());
+}
+
+size_t rxpool_mem_size(u16_t count, u16_t buf_size)
+{
+  return rxpool_stride(buf_size) * count;
+}
+
+void rxpool_init_mem(
+  struct rxpool    *pool,
+  void             *mem,
+  u16_t             count,
+  u16_t             buf_size,
+  rxpool_recycle_fn recycle,
+  void             *recycle_arg
+)
+{
+  size_t header = rxpool_header_size();
+  size_t stride = rxpool_stride(buf_size);
+  u16_t i;
+
+  memset(pool, 0, sizeof(*pool));
+  pool->recycle = recycle;
+  pool->recycle_arg = recycle_arg;
+  pool->buf_size = buf_size;
+  pool->stats.size = count;
+  pool->stats.free = count;
+  pool->stats.low_water = count;
+
+  for ( i = 0; i < count; i++ ) {
+    struct rxpool_buf *buf = (struct rxpool_buf *) ((u8_t *) mem + i * stride);
+
+    buf->custom.custom_free_function = rxpool_free;
+    buf->pool = pool;
+    buf->payload = (u8_t *) buf + header;
+    buf->next = pool->free_list;
+    pool->free_list = buf;
+  }
+}
+
+err_t rxpool_init(
+  struct rxpool    *pool,
+  u16_t             count,
+  u16_t             buf_size,
+  rxpool_recycle_fn recycle,
+  void             *recycle_arg
+)
+{
+  void *mem = rtems_cache_aligned_malloc(rxpool_mem_size(count, buf_size));
+
+  if ( mem == NULL ) {
+    memset(pool, 0, sizeof(*pool));
+    return ERR_MEM;
+  }
+
+  rxpool_init_mem(pool, mem, count, buf_size, recycle, recycle_arg);
+  return ERR_OK;
+}
+
+struct pbuf *rxpool_take(struct rxpool *pool)
+{
+  struct rxpool_buf *buf;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  buf = pool->free_list;
+  if ( buf == NULL ) {
+    pool->stats.empty++;
+    SYS_ARCH_UNPROTECT(lev);
+    return NULL;
+  }
+  pool->free_list = buf->next;
+  pool->stats.takes++;
+  pool->stats.free--;
+  if ( pool->stats.free < pool->stats.low_water ) {
+    pool->stats.low_water = pool->stats.free;
+  }
+  SYS_ARCH_UNPROTECT(lev);
+
+  /*
+   * PBUF_REF keeps the stack from growing the payload into the struct pbuf
+   * in front of it, headers are prepended to a copy instead.
+   */
+  return pbuf_alloced_custom(
+    PBUF_RAW,
+    pool->buf_size,
+    PBUF_REF,
+    &buf->custom,
+    buf->payload,
+    pool->buf_size
+  );
+}
+
+void rxpool_get_stats(struct rxpool *pool, struct rxpool_stats *stats)
+{
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  *stats = pool->stats;
+  SYS_ARCH_UNPROTECT(lev);
+}
+
+#endif
@@ -16,14 +16,332 @@
 #include <sys/socket.h>
 #include <netinet/in.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <time.h>
+#include <arpa/inet.h>
 
 #include <unistd.h>
 
+#include <lwipopts.h>
+#include <remote_syslog.h>
+
 static int LogStatus = LOG_CONS;
 static const char *LogTag = "syslog";
 static int LogFacility = LOG_USER;
 static int LogMask = 0xff;
 
+/*
+ * Remote transport.  Producers claim a slot in a bounded lock-free ring
+ * (one sequence number per slot, so any number of tasks may log at once),
+ * format the message straight into it and publish it.  A single drain task
+ * owns the socket and is the only consumer.  Nothing on the producer side
+ * blocks: when the ring is full the message is counted and discarded.
+ */
+#if (REMOTE_SYSLOG_RING_SIZE & (REMOTE_SYSLOG_RING_SIZE - 1)) != 0
+#error "REMOTE_SYSLOG_RING_SIZE must be a power of two"
+#endif
+
+#define REMOTE_SYSLOG_RING_MASK (REMOTE_SYSLOG_RING_SIZE - 1)
+#define REMOTE_SYSLOG_EVENT RTEMS_EVENT_0
+
+struct syslog_slot {
+	atomic_uint seq;
+	int pri;
+	int perror;
+	rtems_id tid;
+	struct timespec ts;
+	size_t len;
+	char msg[REMOTE_SYSLOG_MSG_SIZE];
+};
+
+static struct syslog_slot *SyslogRing;
+static atomic_uint SyslogHead;
+static atomic_uint SyslogTail;
+static rtems_id SyslogTask;
+static struct remote_syslog_config SyslogConfig;
+static struct sockaddr_storage SyslogServer;
+static socklen_t SyslogServerLen;
+static int SyslogSocket = -1;
+static char SyslogBatch[REMOTE_SYSLOG_BATCH_SIZE];
+
+static struct {
+	atomic_uint queued;
+	atomic_uint sent;
+	atomic_uint dropped_overflow;
+	atomic_uint dropped_send;
+	atomic_uint truncated;
+	atomic_uint high_water;
+} SyslogStats;
+
+static struct syslog_slot *
+syslog_ring_claim (void)
+{
+	unsigned int pos = atomic_load_explicit (&SyslogHead, memory_order_relaxed);
+
+	for (;;) {
+		struct syslog_slot *slot = &SyslogRing[pos & REMOTE_SYSLOG_RING_MASK];
+		unsigned int seq = atomic_load_explicit (&slot->seq, memory_order_acquire);
+		int diff = (int) (seq - pos);
+
+		if (diff == 0) {
+			if (atomic_compare_exchange_weak_explicit (&SyslogHead, &pos,
+			    pos + 1, memory_order_relaxed, memory_order_relaxed))
+				return slot;
+		} else if (diff < 0) {
+			return NULL;
+		} else {
+			pos = atomic_load_explicit (&SyslogHead, memory_order_relaxed);
+		}
+	}
+}
+
+static void
+syslog_ring_publish (struct syslog_slot *slot)
+{
+	unsigned int pos = atomic_load_explicit (&slot->seq, memory_order_relaxed);
+	unsigned int depth;
+	unsigned int high;
+
+	atomic_store_explicit (&slot->seq, pos + 1, memory_order_release);
+	atomic_fetch_add_explicit (&SyslogStats.queued, 1, memory_order_relaxed);
+
+	depth = pos + 1 - atomic_load_explicit (&SyslogTail, memory_order_relaxed);
+	high = atomic_load_explicit (&SyslogStats.high_water, memory_order_relaxed);
+	while (depth > high && depth <= REMOTE_SYSLOG_RING_SIZE &&
+	    !atomic_compare_exchange_weak_explicit (&SyslogStats.high_water,
+	    &high, depth, memory_order_relaxed, memory_order_relaxed))
+		;
+
+	(void) rtems_event_send (SyslogTask, REMOTE_SYSLOG_EVENT);
+}
+
+static int
+remote_syslog_enqueue (int pri, const char *fmt, va_list ap)
+{
+	struct syslog_slot *slot;
+	int cnt;
+
+	if (SyslogRing == NULL)
+		return 0;
+
+	slot = syslog_ring_claim ();
+	if (slot == NULL) {
+		atomic_fetch_add_explicit (&SyslogStats.dropped_overflow, 1,
+		    memory_order_relaxed);
+		return 1;
+	}
+
+	slot->pri = pri;
+	slot->perror = LogStatus & LOG_PERROR;
+	rtems_task_ident (RTEMS_SELF, 0, &slot->tid);
+	clock_gettime (CLOCK_REALTIME, &slot->ts);
+	cnt = vsnprintf (slot->msg, sizeof (slot->msg), fmt, ap);
+	if (cnt < 0)
+		cnt = 0;
+	if (cnt > sizeof (slot->msg) - 1) {
+		atomic_fetch_add_explicit (&SyslogStats.truncated, 1,
+		    memory_order_relaxed);
+		cnt = sizeof (slot->msg) - 1;
+	}
+	while (cnt > 0 && slot->msg[cnt-1] == '\n')
+		slot->msg[--cnt] = '\0';
+	slot->len = cnt;
+
+	syslog_ring_publish (slot);
+	return 1;
+}
+
+static int
+remote_syslog_format (const struct syslog_slot *slot, char *buf, size_t size)
+{
+	struct tm tm;
+	char stamp[32];
+	int cnt;
+
+	gmtime_r (&slot->ts.tv_sec, &tm);
+	strftime (stamp, sizeof (stamp), "%Y-%m-%dT%H:%M:%S", &tm);
+
+	/* <PRI>VERSION TIMESTAMP HOSTNAME APP-NAME PROCID MSGID SD MSG */
+	cnt = snprintf (buf, size, "<%d>1 %s.%06ldZ %s %s %08lx - - %.*s",
+	    slot->pri, stamp, slot->ts.tv_nsec / 1000,
+	    SyslogConfig.hostname != NULL ? SyslogConfig.hostname : "-",
+	    LogTag != NULL ? LogTag : "-", (unsigned long) slot->tid,
+	    (int) slot->len, slot->msg);
+	if (cnt > (int) size - 1)
+		cnt = size - 1;
+	return cnt;
+}
+
+static int
+remote_syslog_connect (void)
+{
+	if (SyslogSocket >= 0)
+		return 0;
+
+	SyslogSocket = socket (SyslogServer.ss_family,
+	    SyslogConfig.use_tcp ? SOCK_STREAM : SOCK_DGRAM, 0);
+	if (SyslogSocket < 0)
+		return -1;
+
+	if (connect (SyslogSocket, (struct sockaddr *) &SyslogServer,
+	    SyslogServerLen) != 0) {
+		close (SyslogSocket);
+		SyslogSocket = -1;
+		return -1;
+	}
+	return 0;
+}
+
+static void
+remote_syslog_send (const char *buf, size_t len, unsigned int count)
+{
+	if (remote_syslog_connect () != 0 ||
+	    send (SyslogSocket, buf, len, 0) != (ssize_t) len) {
+		/* Stream sockets are reopened on the next batch */
+		if (SyslogConfig.use_tcp && SyslogSocket >= 0) {
+			close (SyslogSocket);
+			SyslogSocket = -1;
+		}
+		atomic_fetch_add_explicit (&SyslogStats.dropped_send, count,
+		    memory_order_relaxed);
+		return;
+	}
+	atomic_fetch_add_explicit (&SyslogStats.sent, count,
+	    memory_order_relaxed);
+}
+
+/*
+ * UDP carries exactly one message per datagram as required by RFC 5426, so
+ * a batch there is a burst of sends per wakeup.  TCP coalesces every pending
+ * message into as few segments as the batch buffer allows.
+ */
+static void
+remote_syslog_drain (void)
+{
+	char frame[REMOTE_SYSLOG_MSG_SIZE + 128];
+	size_t batch_len = 0;
+	unsigned int batch_count = 0;
+	unsigned int tail = atomic_load_explicit (&SyslogTail, memory_order_relaxed);
+
+	for (;;) {
+		struct syslog_slot *slot = &SyslogRing[tail & REMOTE_SYSLOG_RING_MASK];
+		unsigned int seq = atomic_load_explicit (&slot->seq, memory_order_acquire);
+		int len;
+
+		if (seq != tail + 1)
+			break;
+
+		len = remote_syslog_format (slot, frame, sizeof (frame));
+		if (slot->perror)
+			printf ("%.*s\n", (int) slot->len, slot->msg);
+
+		atomic_store_explicit (&slot->seq,
+		    tail + REMOTE_SYSLOG_RING_SIZE, memory_order_release);
+		tail++;
+		atomic_store_explicit (&SyslogTail, tail, memory_order_relaxed);
+
+		if (!SyslogConfig.use_tcp) {
+			remote_syslog_send (frame, len, 1);
+			continue;
+		}
+
+		if (batch_len + len + 12 > sizeof (SyslogBatch)) {
+			remote_syslog_send (SyslogBatch, batch_len, batch_count);
+			batch_len = 0;
+			batch_count = 0;
+		}
+		batch_len += snprintf (SyslogBatch + batch_len,
+		    sizeof (SyslogBatch) - batch_len, "%d %.*s", len, len, frame);
+		batch_count++;
+	}
+
+	if (batch_count > 0)
+		remote_syslog_send (SyslogBatch, batch_len, batch_count);
+}
+
+static rtems_task
+remote_syslog_task (rtems_task_argument arg)
+{
+	(void) arg;
+
+	for (;;) {
+		rtems_event_set events;
+
+		rtems_event_receive (REMOTE_SYSLOG_EVENT, RTEMS_EVENT_ANY | RTEMS_WAIT,
+		    RTEMS_NO_TIMEOUT, &events);
+		remote_syslog_drain ();
+	}
+}
+
+rtems_status_code
+remote_syslog_start (const struct remote_syslog_config *config)
+{
+	struct sockaddr_in *sin = (struct sockaddr_in *) &SyslogServer;
+	struct sockaddr_in6 *sin6 = (struct sockaddr_in6 *) &SyslogServer;
+	uint16_t port = config->port != 0 ? config->port : 514;
+	struct syslog_slot *ring;
+	rtems_status_code sc;
+	unsigned int i;
+
+	if (SyslogRing != NULL)
+		return RTEMS_INCORRECT_STATE;
+
+	memset (&SyslogServer, 0, sizeof (SyslogServer));
+	if (inet_pton (AF_INET, config->server, &sin->sin_addr) == 1) {
+		sin->sin_len = sizeof (*sin);
+		sin->sin_family = AF_INET;
+		sin->sin_port = htons (port);
+		SyslogServerLen = sizeof (*sin);
+	} else if (inet_pton (AF_INET6, config->server, &sin6->sin6_addr) == 1) {
+		sin6->sin6_len = sizeof (*sin6);
+		sin6->sin6_family = AF_INET6;
+		sin6->sin6_port = htons (port);
+		SyslogServerLen = sizeof (*sin6);
+	} else {
+		return RTEMS_INVALID_ADDRESS;
+	}
+
+	ring = calloc (REMOTE_SYSLOG_RING_SIZE, sizeof (*ring));
+	if (ring == NULL)
+		return RTEMS_NO_MEMORY;
+	for (i = 0; i < REMOTE_SYSLOG_RING_SIZE; i++)
+		atomic_init (&ring[i].seq, i);
+
+	SyslogConfig = *config;
+	sc = rtems_task_create (rtems_build_name ('S', 'L', 'O', 'G'),
+	    config->priority != 0 ? config->priority : REMOTE_SYSLOG_TASK_PRIORITY,
+	    RTEMS_MINIMUM_STACK_SIZE * 4, RTEMS_DEFAULT_MODES,
+	    RTEMS_FLOATING_POINT, &SyslogTask);
+	if (sc != RTEMS_SUCCESSFUL) {
+		free (ring);
+		return sc;
+	}
+
+	sc = rtems_task_start (SyslogTask, remote_syslog_task, 0);
+	if (sc != RTEMS_SUCCESSFUL) {
+		rtems_task_delete (SyslogTask);
+		free (ring);
+		return sc;
+	}
+
+	/* Producers start using the ring once it is visible */
+	atomic_thread_fence (memory_order_release);
+	SyslogRing = ring;
+	return RTEMS_SUCCESSFUL;
+}
+
+void
+remote_syslog_get_stats (struct remote_syslog_stats *stats)
+{
+	stats->queued = atomic_load (&SyslogStats.queued);
+	stats->sent = atomic_load (&SyslogStats.sent);
+	stats->dropped_overflow = atomic_load (&SyslogStats.dropped_overflow);
+	stats->dropped_send = atomic_load (&SyslogStats.dropped_send);
+	stats->truncated = atomic_load (&SyslogStats.truncated);
+	stats->high_water = atomic_load (&SyslogStats.high_water);
+}
+
 void
 syslog (int pri, const char *fmt, ...)
 {
@@ -60,6 +378,9 @@ vsyslog (int pri, const char *fmt, va_list ap)
 	if ((pri & LOG_FACMASK) == 0)
 		pri |= LogFacility;
 
+	if (remote_syslog_enqueue (pri, fmt, ap))
+		return;
+
 	cnt = snprintf (cbuf, sizeof (cbuf), "<%d>", pri);
 	if (LogTag && cnt < sizeof (cbuf) - 1)
 		cnt += snprintf (cbuf + cnt, sizeof (cbuf) - cnt, "%s", LogTag);
@@ -94,5 +415,9 @@ setlogmask (int pmask)
 void
 openlog(const char *ident, int option, int facility)
 {
-	/* Do nothing */
+	if (ident != NULL)
+		LogTag = ident;
+	LogStatus = option;
+	if (facility != 0 && (facility & ~LOG_FACMASK) == 0)
+		LogFacility = facility;
 }
@@ -0,0 +1,373 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <tlsf.h>
+
+/*
+ * Every block starts with this header, padded to the alignment. The free list
+ * links are kept in the payload of free blocks. The pool ends with a used
+ * sentinel block of size zero so that merging never runs off the end.
+ */
+struct tlsf_block {
+  struct tlsf_block *prev_phys;
+  size_t             size;  /* payload size, low bit set while free */
+};
+
+struct tlsf_links {
+  struct tlsf_block *next;
+  struct tlsf_block *prev;
+};
+
+#define TLSF_BLOCK_FREE ( (size_t) 1 )
+
+static size_t align_up( size_t x, size_t align )
+{
+  return ( x + align - 1 ) & ~( align - 1 );
+}
+
+static unsigned int fls_size( size_t x )
+{
+  return (unsigned int) ( sizeof( unsigned long ) * 8 - 1 -
+    (unsigned int) __builtin_clzl( (unsigned long) x ) );
+}
+
+static size_t block_size( const struct tlsf_block *block )
+{
+  return block->size & ~TLSF_BLOCK_FREE;
+}
+
+static bool block_is_free( const struct tlsf_block *block )
+{
+  return ( block->size & TLSF_BLOCK_FREE ) != 0;
+}
+
+static void *block_payload( const struct tlsf *tlsf, struct tlsf_block *block )
+{
+  return (uint8_t *) block + tlsf->header;
+}
+
+static struct tlsf_block *block_from_payload(
+  const struct tlsf *tlsf,
+  const void        *ptr
+)
+{
+  return (struct tlsf_block *) ( (uint8_t *) ptr - tlsf->header );
+}
+
+static struct tlsf_links *block_links(
+  const struct tlsf *tlsf,
+  struct tlsf_block *block
+)
+{
+  return block_payload( tlsf, block );
+}
+
+static struct tlsf_block *block_next(
+  const struct tlsf *tlsf,
+  struct tlsf_block *block
+)
+{
+  return (struct tlsf_block *)
+    ( (uint8_t *) block_payload( tlsf, block ) + block_size( block ) );
+}
+
+static void mapping_insert(
+  const struct tlsf *tlsf,
+  size_t             size,
+  unsigned int      *fl,
+  unsigned int      *sl
+)
+{
+  if ( size < ( (size_t) 1 << tlsf->fl_shift ) ) {
+    *fl = 0;
+    *sl = (unsigned int) ( size >> ( tlsf->fl_shift - TLSF_SL_LOG2 ) );
+  } else {
+    unsigned int bit = fls_size( size );
+
+    *fl = bit - tlsf->fl_shift + 1;
+    *sl = (unsigned int) ( size >> ( bit - TLSF_SL_LOG2 ) ) ^ TLSF_SL_COUNT;
+  }
+}
+
+/* Rounds up to the next list so that any block found is large enough */
+static void mapping_search(
+  const struct tlsf *tlsf,
+  size_t             size,
+  unsigned int      *fl,
+  unsigned int      *sl
+)
+{
+  if ( size >= ( (size_t) 1 << tlsf->fl_shift ) ) {
+    size += ( (size_t) 1 << ( fls_size( size ) - TLSF_SL_LOG2 ) ) - 1;
+  }
+  mapping_insert( tlsf, size, fl, sl );
+}
+
+static void insert_free( struct tlsf *tlsf, struct tlsf_block *block )
+{
+  struct tlsf_links *links = block_links( tlsf, block );
+  struct tlsf_block *head;
+  unsigned int fl;
+  unsigned int sl;
+
+  mapping_insert( tlsf, block_size( block ), &fl, &sl );
+  head = tlsf->free[ fl ][ sl ];
+  links->next = head;
+  links->prev = NULL;
+  if ( head != NULL ) {
+    block_links( tlsf, head )->prev = block;
+  }
+  tlsf->free[ fl ][ sl ] = block;
+  tlsf->fl_bitmap |= 1U << fl;
+  tlsf->sl_bitmap[ fl ] |= 1U << sl;
+  block->size |= TLSF_BLOCK_FREE;
+}
+
+static void remove_free( struct tlsf *tlsf, struct tlsf_block *block )
+{
+  struct tlsf_links *links = block_links( tlsf, block );
+  unsigned int fl;
+  unsigned int sl;
+
+  mapping_insert( tlsf, block_size( block ), &fl, &sl );
+  if ( links->next != NULL ) {
+    block_links( tlsf, links->next )->prev = links->prev;
+  }
+  if ( links->prev != NULL ) {
+    block_links( tlsf, links->prev )->next = links->next;
+  } else {
+    tlsf->free[ fl ][ sl ] = links->next;
+    if ( links->next == NULL ) {
+      tlsf->sl_bitmap[ fl ] &= ~( 1U << sl );
+      if ( tlsf->sl_bitmap[ fl ] == 0 ) {
+        tlsf->fl_bitmap &= ~( 1U << fl );
+      }
+    }
+  }
+  block->size &= ~TLSF_BLOCK_FREE;
+}
+
+static struct tlsf_block *find_free(
+  struct tlsf  *tlsf,
+  unsigned int  fl,
+  unsigned int  sl
+)
+{
+  uint32_t sl_map;
+
+  if ( fl >= TLSF_FL_COUNT ) {
+    return NULL;
+  }
+
+  sl_map = tlsf->sl_bitmap[ fl ] & ( ~0U << sl );
+  if ( sl_map == 0 ) {
+    uint32_t fl_map = fl + 1 < TLSF_FL_COUNT ?
+      tlsf->fl_bitmap & ( ~0U << ( fl + 1 ) ) : 0;
+
+    if ( fl_map == 0 ) {
+      return NULL;
+    }
+    fl = (unsigned int) __builtin_ctz( fl_map );
+    sl_map = tlsf->sl_bitmap[ fl ];
+  }
+  sl = (unsigned int) __builtin_ctz( sl_map );
+  return tlsf->free[ fl ][ sl ];
+}
+
+/* Splits off everything beyond size as a new block, which is returned */
+static struct tlsf_block *split(
+  struct tlsf       *tlsf,
+  struct tlsf_block *block,
+  size_t             size
+)
+{
+  struct tlsf_block *rest;
+  struct tlsf_block *next;
+  size_t total = block_size( block );
+
+  if ( total < size + tlsf->header + tlsf->min_size ) {
+    return NULL;
+  }
+
+  next = block_next( tlsf, block );
+  block->size = size | ( block->size & TLSF_BLOCK_FREE );
+  rest = block_next( tlsf, block );
+  rest->prev_phys = block;
+  rest->size = total - size - tlsf->header;
+  next->prev_phys = rest;
+  return rest;
+}
+
+/* Merges a block that is not on a free list with its free neighbours */
+static struct tlsf_block *merge( struct tlsf *tlsf, struct tlsf_block *block )
+{
+  struct tlsf_block *prev = block->prev_phys;
+  struct tlsf_block *next = block_next( tlsf, block );
+
+  if ( block_is_free( next ) ) {
+    remove_free( tlsf, next );
+    block->size += tlsf->header + block_size( next );
+    block_next( tlsf, block )->prev_phys = block;
+  }
+
+  if ( prev != NULL && block_is_free( prev ) ) {
+    remove_free( tlsf, prev );
+    prev->size += tlsf->header + block_size( block );
+    block_next( tlsf, prev )->prev_phys = prev;
+    block = prev;
+  }
+
+  return block;
+}
+
+void tlsf_init( struct tlsf *tlsf, void *mem, size_t size, size_t align )
+{
+  struct tlsf_block *block;
+  struct tlsf_block *sentinel;
+  unsigned int i;
+  unsigned int j;
+
+  if ( align < sizeof( void * ) ) {
+    align = sizeof( void * );
+  }
+
+  tlsf->align = align;
+  tlsf->header = align_up( sizeof( struct tlsf_block ), align );
+  tlsf->min_size = align_up( sizeof( struct tlsf_links ), align );
+  tlsf->fl_shift = TLSF_SL_LOG2 + fls_size( align );
+  tlsf->fl_bitmap = 0;
+  for ( i = 0; i < TLSF_FL_COUNT; i++ ) {
+    tlsf->sl_bitmap[ i ] = 0;
+    for ( j = 0; j < TLSF_SL_COUNT; j++ ) {
+      tlsf->free[ i ][ j ] = NULL;
+    }
+  }
+
+  size &= ~( align - 1 );
+  tlsf->start = mem;
+  tlsf->end = (uint8_t *) mem + size;
+
+  block = mem;
+  block->prev_phys = NULL;
+  block->size = size - 2 * tlsf->header;
+  sentinel = block_next( tlsf, block );
+  sentinel->prev_phys = block;
+  sentinel->size = 0;
+  insert_free( tlsf, block );
+}
+
+void *tlsf_malloc( struct tlsf *tlsf, size_t size )
+{
+  struct tlsf_block *block;
+  struct tlsf_block *rest;
+  unsigned int fl;
+  unsigned int sl;
+
+  if ( size == 0 || size > (size_t) ( tlsf->end - tlsf->start ) ) {
+    return NULL;
+  }
+
+  size = align_up( size, tlsf->align );
+  if ( size < tlsf->min_size ) {
+    size = tlsf->min_size;
+  }
+
+  mapping_search( tlsf, size, &fl, &sl );
+  block = find_free( tlsf, fl, sl );
+  if ( block == NULL ) {
+    /*
+     * The head of the list the size belongs to may still be large enough.
+     * Checking it keeps the step count constant and lets the largest
+     * requests use the whole heap.
+     */
+    mapping_insert( tlsf, size, &fl, &sl );
+    block = tlsf->free[ fl ][ sl ];
+    if ( block == NULL || block_size( block ) < size ) {
+      return NULL;
+    }
+  }
+
+  remove_free( tlsf, block );
+  rest = split( tlsf, block, size );
+  if ( rest != NULL ) {
+    insert_free( tlsf, rest );
+  }
+  return block_payload( tlsf, block );
+}
+
+void tlsf_free( struct tlsf *tlsf, void *ptr )
+{
+  struct tlsf_block *block;
+
+  if ( ptr == NULL ) {
+    return;
+  }
+
+  block = merge( tlsf, block_from_payload( tlsf, ptr ) );
+  insert_free( tlsf, block );
+}
+
+void tlsf_shrink( struct tlsf *tlsf, void *ptr, size_t size )
+{
+  struct tlsf_block *rest;
+
+  size = align_up( size, tlsf->align );
+  if ( size < tlsf->min_size ) {
+    size = tlsf->min_size;
+  }
+
+  rest = split( tlsf, block_from_payload( tlsf, ptr ), size );
+  if ( rest != NULL ) {
+    insert_free( tlsf, merge( tlsf, rest ) );
+  }
+}
+
+size_t tlsf_block_size( const struct tlsf *tlsf, const void *ptr )
+{
+  return block_size( block_from_payload( tlsf, ptr ) );
+}
+
+bool tlsf_contains( const struct tlsf *tlsf, const void *ptr )
+{
+  const uint8_t *p = ptr;
+
+  return p >= tlsf->start + tlsf->header && p < tlsf->end - tlsf->header;
+}
+
+void tlsf_walk_used(
+  struct tlsf *tlsf,
+  void       ( *visitor )( void *ptr, size_t size, void *arg ),
+  void        *arg
+)
+{
+  struct tlsf_block *block = (struct tlsf_block *) tlsf->start;
+
+  while ( block_size( block ) != 0 ) {
+    if ( !block_is_free( block ) ) {
+      ( *visitor )( block_payload( tlsf, block ), block_size( block ), arg );
+    }
+    block = block_next( tlsf, block );
+  }
+}
@@ -0,0 +1,414 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <lwip/etharp.h>
+#include <lwip/ethip6.h>
+#include <lwip/pbuf.h>
+#include <lwip/tcpip.h>
+#include <netif/ethernet.h>
+
+#include <stdbool.h>
+#include <string.h>
+
+#ifdef __rtems__
+#include <rtems.h>
+#else
+#include <errno.h>
+#include <time.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+#endif
+
+#include <netif_burst.h>
+#if LWIP_HWTSTAMP
+#include <netif_hwtstamp.h>
+#endif
+#include <vnetif.h>
+
+#if LWIP_VNETIF
+
+static u8_t vnetif_count;
+
+u64_t vnetif_now_us(void)
+{
+#ifdef __rtems__
+  return rtems_clock_get_uptime_nanoseconds() / 1000;
+#else
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+#if LWIP_HWTSTAMP
+/* Stamps frames with vnetif_now_us() as a MAC with a timestamp unit would */
+static void vnetif_tstamp(u32_t *sec, u32_t *nsec)
+{
+  u64_t now = vnetif_now_us();
+
+  *sec = (u32_t) (now / 1000000);
+  *nsec = (u32_t) (now % 1000000) * 1000;
+}
+#endif
+
+static bool vnetif_chance(u32_t ppm)
+{
+  return ppm != 0 && (LWIP_RAND() % 1000000) < ppm;
+}
+
+/*
+ * Waits until the receive queue is kicked or until due_us, or for a kick only
+ * when due_us is 0. RTEMS waits in clock ticks, the host with the microsecond
+ * deadline itself so that delays below a millisecond are emulated.
+ */
+static void vnetif_rx_wait(struct vnetif *vif, u64_t due_us)
+{
+#ifdef __rtems__
+  u32_t timeout = 0;
+  u64_t now;
+
+  if ( due_us != 0 ) {
+    now = vnetif_now_us();
+    timeout = due_us > now ? (u32_t) ((due_us - now + 999) / 1000) : 1;
+  }
+  sys_arch_sem_wait(&vif->rx_ready, timeout);
+#else
+  struct timespec deadline;
+
+  deadline.tv_sec = (time_t) (due_us / 1000000);
+  deadline.tv_nsec = (long) (due_us % 1000000) * 1000;
+
+  pthread_mutex_lock(&vif->rx_wait_lock);
+  while ( !vif->rx_kicked ) {
+    if ( due_us == 0 ) {
+      pthread_cond_wait(&vif->rx_wait, &vif->rx_wait_lock);
+    } else if ( pthread_cond_timedwait(&vif->rx_wait, &vif->rx_wait_lock,
+                  &deadline) == ETIMEDOUT ) {
+      break;
+    }
+  }
+  vif->rx_kicked = false;
+  pthread_mutex_unlock(&vif->rx_wait_lock);
+#endif
+}
+
+static void vnetif_rx_kick(struct vnetif *vif)
+{
+#ifdef __rtems__
+  sys_sem_signal(&vif->rx_ready);
+#else
+  pthread_mutex_lock(&vif->rx_wait_lock);
+  vif->rx_kicked = true;
+  pthread_cond_signal(&vif->rx_wait);
+  pthread_mutex_unlock(&vif->rx_wait_lock);
+#endif
+}
+
+static err_t vnetif_rx_wait_init(struct vnetif *vif)
+{
+#ifdef __rtems__
+  return sys_sem_new(&vif->rx_ready, 0);
+#else
+  pthread_condattr_t attr;
+  int eno;
+
+  /* Deadlines are taken from vnetif_now_us() and so from CLOCK_MONOTONIC */
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  eno = pthread_cond_init(&vif->rx_wait, &attr);
+  pthread_condattr_destroy(&attr);
+  if ( eno != 0 || pthread_mutex_init(&vif->rx_wait_lock, NULL) != 0 ) {
+    return ERR_MEM;
+  }
+  vif->rx_kicked = false;
+  return ERR_OK;
+#endif
+}
+
+u32_t vnetif_resolution_us(void)
+{
+#ifdef __rtems__
+  u32_t tick_us = rtems_configuration_get_microseconds_per_tick();
+
+  /* sys_arch_sem_wait() takes milliseconds and rounds them up to ticks */
+  return tick_us > 1000 ? tick_us : 1000;
+#else
+  return 1;
+#endif
+}
+
+static void vnetif_rx_thread(void *arg)
+{
+  struct vnetif *vif = arg;
+  struct netif_burst burst;
+  u64_t due_us = 0;
+
+  netif_burst_init(&burst);
+#ifdef __linux__
+  /* The default slack of 50us would dominate short emulated delays */
+  prctl(PR_SET_TIMERSLACK, 1UL);
+#endif
+  while ( true ) {
+    vnetif_rx_wait(vif, due_us);
+    due_us = 0;
+
+    /* Deliver everything that is due under one lock acquisition */
+    LOCK_TCPIP_CORE();
+    while ( true ) {
+      struct vnetif_frame *frame;
+      struct pbuf *p;
+
+      sys_mutex_lock(&vif->lock);
+      if ( vif->rx_count == 0 ) {
+        sys_mutex_unlock(&vif->lock);
+        break;
+      }
+      frame = &vif->rx_queue[vif->rx_head];
+      if ( frame->due_us > vnetif_now_us() ) {
+        due_us = frame->due_us;
+        sys_mutex_unlock(&vif->lock);
+        break;
+      }
+      p = frame->p;
+      vif->rx_head = (vif->rx_head + 1) % VNETIF_QUEUE_LEN;
+      vif->rx_count--;
+      sys_mutex_unlock(&vif->lock);
+
+      vif->stats.rx_packets++;
+#if LWIP_HWTSTAMP
+      vnetif_tstamp(&p->tstamp_sec, &p->tstamp_nsec);
+#endif
+      if ( netif_burst_add(&burst, p) >= LWIP_NETIF_BURST ) {
+        netif_burst_flush(&burst, &vif->netif);
+      }
+    }
+    netif_burst_flush(&burst, &vif->netif);
+    UNLOCK_TCPIP_CORE();
+  }
+}
+
+/* Inserts a frame into the peer queue keeping it sorted by due time */
+static bool vnetif_enqueue(struct vnetif *peer, struct pbuf *p, u64_t due_us)
+{
+  unsigned int pos;
+
+  if ( peer->rx_count == VNETIF_QUEUE_LEN ) {
+    return false;
+  }
+
+  pos = peer->rx_count;
+  while ( pos > 0 ) {
+    unsigned int prev = (peer->rx_head + pos - 1) % VNETIF_QUEUE_LEN;
+
+    if ( peer->rx_queue[prev].due_us <= due_us ) {
+      break;
+    }
+    peer->rx_queue[(peer->rx_head + pos) % VNETIF_QUEUE_LEN] =
+      peer->rx_queue[prev];
+    pos--;
+  }
+
+  pos = (peer->rx_head + pos) % VNETIF_QUEUE_LEN;
+  peer->rx_queue[pos].p = p;
+  peer->rx_queue[pos].due_us = due_us;
+  peer->rx_count++;
+  return true;
+}
+
+static err_t vnetif_linkoutput(struct netif *netif, struct pbuf *p)
+{
+  struct vnetif *vif = netif->state;
+  struct vnetif *peer = vif->peer;
+  struct vnetif_impairment imp;
+  struct pbuf *q;
+  u64_t now;
+  u64_t due;
+  bool queued;
+
+  sys_mutex_lock(&vif->lock);
+  imp = vif->impairment;
+  sys_mutex_unlock(&vif->lock);
+
+#if LWIP_HWTSTAMP
+  /* The frame has left the interface even if the link loses it */
+  if ( p->tstamp_id != 0 ) {
+    u32_t sec;
+    u32_t nsec;
+
+    vnetif_tstamp(&sec, &nsec);
+    netif_hwtstamp_tx_done(p->tstamp_id, sec, nsec);
+  }
+#endif
+
+  if ( vnetif_chance(imp.loss_ppm) ) {
+    vif->stats.tx_lost++;
+    return ERR_OK;
+  }
+
+  q = pbuf_alloc(PBUF_RAW, p->tot_len, PBUF_POOL);
+  if ( q == NULL ) {
+    vif->stats.tx_drops++;
+    return ERR_MEM;
+  }
+  pbuf_copy(q, p);
+
+  now = vnetif_now_us();
+  due = now;
+  if ( imp.rate_kbps != 0 ) {
+    /* The wire is busy until the previous frame has been serialized */
+    if ( vif->link_free_us < now ) {
+      vif->link_free_us = now;
+    }
+    vif->link_free_us += (u64_t) p->tot_len * 8 * 1000 / imp.rate_kbps;
+    due = vif->link_free_us;
+  }
+
+  if ( vnetif_chance(imp.reorder_ppm) ) {
+    vif->stats.tx_reordered++;
+  } else {
+    due += imp.delay_us;
+    if ( imp.jitter_us != 0 ) {
+      due += LWIP_RAND() % (imp.jitter_us + 1);
+    }
+    /* Jitter alone must not reorder frames */
+    if ( due < vif->last_due_us ) {
+      due = vif->last_due_us;
+    }
+    vif->last_due_us = due;
+  }
+
+  sys_mutex_lock(&peer->lock);
+  queued = vnetif_enqueue(peer, q, due);
+  sys_mutex_unlock(&peer->lock);
+
+  if ( !queued ) {
+    pbuf_free(q);
+    vif->stats.tx_drops++;
+    return ERR_OK;
+  }
+
+  vif->stats.tx_packets++;
+  vif->stats.tx_bytes += p->tot_len;
+  vnetif_rx_kick(peer);
+  return ERR_OK;
+}
+
+static err_t vnetif_init(struct netif *netif)
+{
+  netif->name[0] = 'v';
+  netif->name[1] = 'e';
+  netif->mtu = 1500;
+  netif->hwaddr_len = ETH_HWADDR_LEN;
+  netif->hwaddr[0] = 0x02;
+  netif->hwaddr[5] = ++vnetif_count;
+  netif->flags = NETIF_FLAG_BROADCAST | NETIF_FLAG_ETHARP |
+    NETIF_FLAG_ETHERNET | NETIF_FLAG_LINK_UP;
+#if LWIP_IPV4
+  netif->output = etharp_output;
+#endif
+#if LWIP_IPV6
+  netif->output_ip6 = ethip6_output;
+#endif
+  netif->linkoutput = vnetif_linkoutput;
+  return ERR_OK;
+}
+
+struct netif *vnetif_route_src(const ip4_addr_t *src, const ip4_addr_t *dest)
+{
+  struct netif *netif;
+
+  (void) dest;
+
+  if ( vnetif_count == 0 || src == NULL || ip4_addr_isany(src) ) {
+    return NULL;
+  }
+
+  NETIF_FOREACH(netif) {
+    if ( netif->linkoutput == vnetif_linkoutput &&
+         netif_is_up(netif) &&
+         ip4_addr_cmp(src, netif_ip4_addr(netif)) ) {
+      return netif;
+    }
+  }
+  return NULL;
+}
+
+err_t vnetif_pair_add(
+  struct vnetif     *a,
+  struct vnetif     *b,
+  const ip4_addr_t  *addr_a,
+  const ip4_addr_t  *addr_b,
+  const ip4_addr_t  *netmask
+)
+{
+  struct vnetif *vifs[] = { a, b };
+  const ip4_addr_t *addrs[] = { addr_a, addr_b };
+  int i;
+
+  memset(a, 0, sizeof(*a));
+  memset(b, 0, sizeof(*b));
+  a->peer = b;
+  b->peer = a;
+
+  for ( i = 0; i < 2; i++ ) {
+    struct vnetif *vif = vifs[i];
+
+    if ( sys_mutex_new(&vif->lock) != ERR_OK ||
+         vnetif_rx_wait_init(vif) != ERR_OK ) {
+      return ERR_MEM;
+    }
+    if ( netif_add(&vif->netif, addrs[i], netmask, NULL, vif, vnetif_init,
+           ethernet_input) == NULL ) {
+      return ERR_IF;
+    }
+    sys_thread_new("vnetif_rx", vnetif_rx_thread, vif,
+      VNETIF_THREAD_STACKSIZE, DEFAULT_THREAD_PRIO);
+  }
+
+  netif_set_up(&a->netif);
+  netif_set_up(&b->netif);
+  return ERR_OK;
+}
+
+void vnetif_set_impairment(
+  struct vnetif                  *vif,
+  const struct vnetif_impairment *impairment
+)
+{
+  sys_mutex_lock(&vif->lock);
+  vif->impairment = *impairment;
+  sys_mutex_unlock(&vif->lock);
+}
+
+void vnetif_get_stats(struct vnetif *vif, struct vnetif_stats *stats)
+{
+  sys_mutex_lock(&vif->lock);
+  *stats = vif->stats;
+  sys_mutex_unlock(&vif->lock);
+}
+
+#endif /* LWIP_VNETIF */
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_IRQ_MODERATION_H
+#define _RTEMSLWIP_IRQ_MODERATION_H
+#include <lwip/arch.h>
+
+/*
+ * Adaptive receive interrupt moderation shared by the drivers. The receive
+ * path reports how many packets each interrupt brought in and the driver
+ * programs its moderation hardware with the delay chosen from the packet
+ * rate measured over a sample period. Above high_pps the delay starts at
+ * min_usecs and doubles every sample up to max_usecs, below low_pps it drops
+ * back to an interrupt per packet. Rates in between keep the delay, so the
+ * two thresholds give hysteresis.
+ */
+struct irq_moderation_policy {
+  u32_t sample_ms;
+  u32_t low_pps;
+  u32_t high_pps;
+  u16_t min_usecs;
+  u16_t max_usecs;
+};
+
+struct irq_moderation_stats {
+  u32_t interrupts;
+  u32_t packets;
+  u32_t raised;  /* Delay increases */
+  u32_t lowered; /* Returns to an interrupt per packet */
+  u32_t pps;     /* Rate of the last sample */
+  u16_t usecs;   /* Delay in effect, 0 for an interrupt per packet */
+};
+
+struct irq_moderation {
+  struct irq_moderation_policy policy;
+  struct irq_moderation_stats  stats;
+  u32_t                        sample_start;
+  u32_t                        sample_packets;
+};
+
+/* Starts with an interrupt per packet and the policy of the LWIP_IRQ_MODERATION_* options */
+void irq_moderation_init(struct irq_moderation *mod);
+
+/*
+ * Replaces the policy. The delay in effect is kept until the next sample
+ * decides otherwise.
+ */
+void irq_moderation_set_policy(
+  struct irq_moderation              *mod,
+  const struct irq_moderation_policy *policy
+);
+
+static inline void irq_moderation_interrupt(struct irq_moderation *mod)
+{
+  mod->stats.interrupts++;
+}
+
+/*
+ * Accounts packets received and returns 1 when a sample ended with a new
+ * delay in stats.usecs for the driver to program, 0 otherwise.
+ */
+int irq_moderation_update(struct irq_moderation *mod, u32_t packets);
+
+/* Prints the policy and counters with LWIP_PLATFORM_DIAG() */
+void irq_moderation_stats_display(
+  const char                  *name,
+  const struct irq_moderation *mod
+);
+
+#endif
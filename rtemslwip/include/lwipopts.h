@@ -160,6 +160,30 @@
 #define LWIP_DNS 1
 #endif
 
+#ifndef LWIP_GRO
+#define LWIP_GRO 0 /* Coalesce in-order TCP segments of received bursts */
+#endif
+
+#ifndef LWIP_GRO_MAX_SIZE
+#define LWIP_GRO_MAX_SIZE 65535 /* Frame bytes per coalesced TCP segment */
+#endif
+
+#ifndef LWIP_GSO
+#define LWIP_GSO 0 /* TCP passes runs of segments through IP at once */
+#endif
+
+#ifndef LWIP_GSO_MAX_SIZE
+#define LWIP_GSO_MAX_SIZE 65535 /* TCP payload bytes per GSO packet */
+#endif
+
+#ifndef LWIP_HWTSTAMP
+#define LWIP_HWTSTAMP 0 /* Hardware packet timestamps and SO_TIMESTAMPING */
+#endif
+
+#ifndef LWIP_HWTSTAMP_TX_SLOTS
+#define LWIP_HWTSTAMP_TX_SLOTS 16 /* Transmit timestamps awaited at once */
+#endif
+
 #ifndef LWIP_IPV4
 #define LWIP_IPV4 1
 #endif
@@ -168,6 +192,46 @@
 #define LWIP_IPV6 1
 #endif
 
+#ifndef LWIP_IRQ_MODERATION
+#define LWIP_IRQ_MODERATION 0 /* Adaptive receive interrupt moderation */
+#endif
+
+#ifndef LWIP_IRQ_MODERATION_HIGH_PPS
+#define LWIP_IRQ_MODERATION_HIGH_PPS 20000 /* Raise the delay from this rate */
+#endif
+
+#ifndef LWIP_IRQ_MODERATION_LOW_PPS
+#define LWIP_IRQ_MODERATION_LOW_PPS 5000 /* Interrupt per packet below */
+#endif
+
+#ifndef LWIP_IRQ_MODERATION_MAX_USECS
+#define LWIP_IRQ_MODERATION_MAX_USECS 200
+#endif
+
+#ifndef LWIP_IRQ_MODERATION_MIN_USECS
+#define LWIP_IRQ_MODERATION_MIN_USECS 20
+#endif
+
+#ifndef LWIP_IRQ_MODERATION_SAMPLE_MS
+#define LWIP_IRQ_MODERATION_SAMPLE_MS 10
+#endif
+
+#ifndef LWIP_NETIF_BURST
+#define LWIP_NETIF_BURST 32 /* Received packets passed to the stack at once */
+#endif
+
+#ifndef LWIP_NETIF_EXT_STATUS_CALLBACK
+#define LWIP_NETIF_EXT_STATUS_CALLBACK 1 /* Invalidates getifaddrs() cache */
+#endif
+
+#ifndef LWIP_RX_POOL
+#define LWIP_RX_POOL 0 /* Drivers receive into their own recycled buffers */
+#endif
+
+#ifndef LWIP_RX_POOL_EXTRA
+#define LWIP_RX_POOL_EXTRA 64 /* Buffers beyond one per RX descriptor */
+#endif
+
 #ifndef LWIP_TCP
 #define LWIP_TCP 1
 #endif
@@ -176,10 +240,55 @@
 #define LWIP_UDP 1
 #endif
 
+#ifndef LWIP_VNETIF
+#define LWIP_VNETIF 0 /* In-process virtual Ethernet pairs for testing */
+#endif
+
+#if LWIP_VNETIF
+#define LWIP_HOOK_FILENAME "vnetif.h"
+#define LWIP_HOOK_IP4_ROUTE_SRC(src, dest) vnetif_route_src(src, dest)
+#endif
+
+#ifndef MEMP_ELASTIC
+#define MEMP_ELASTIC 0 /* Pools start small and grow from a shared region */
+#endif
+
+#ifndef MEMP_ELASTIC_GROW_NUM
+#define MEMP_ELASTIC_GROW_NUM 16
+#endif
+
+#ifndef MEMP_ELASTIC_MIN_PERCENT
+#define MEMP_ELASTIC_MIN_PERCENT 25
+#endif
+
+#ifndef MEMP_ELASTIC_REGION_SIZE
+#define MEMP_ELASTIC_REGION_SIZE 512 * 1024
+#endif
+
+#ifndef MEMP_MAGAZINES
+#define MEMP_MAGAZINES 0 /* Per-processor caches in front of the memp pools */
+#endif
+
+#ifndef MEMP_MAGAZINE_ALIGN
+#define MEMP_MAGAZINE_ALIGN 64
+#endif
+
+#ifndef MEMP_MAGAZINE_MAX_CPUS
+#define MEMP_MAGAZINE_MAX_CPUS 4
+#endif
+
+#ifndef MEMP_MAGAZINE_SIZE
+#define MEMP_MAGAZINE_SIZE 8
+#endif
+
 #ifndef MEMP_NUM_FRAG_PBUF
 #define MEMP_NUM_FRAG_PBUF 256
 #endif
 
+#ifndef MEMP_NUM_NETBUF
+#define MEMP_NUM_NETBUF 64 /* Datagrams queued on UDP and raw sockets */
+#endif
+
 #ifndef MEMP_NUM_NETCONN
 #define MEMP_NUM_NETCONN 16
 #endif
@@ -212,6 +321,14 @@
 #define MEM_SIZE 2 * 1024 * 1024
 #endif
 
+#ifndef MEM_TLSF
+#define MEM_TLSF 0 /* Constant time mem_malloc() backend */
+#endif
+
+#ifndef MIB2_STATS
+#define MIB2_STATS 1 /* Per-interface counters for getifaddrs() */
+#endif
+
 #ifndef PBUF_LINK_HLEN
 #define PBUF_LINK_HLEN 16
 #endif
@@ -220,10 +337,30 @@
 #define PBUF_POOL_BUFSIZE 1600
 #endif
 
+#ifndef PBUF_POOL_CACHE_LINE_SIZE
+#define PBUF_POOL_CACHE_LINE_SIZE 0 /* Give pool payloads their own lines */
+#endif
+
 #ifndef PBUF_POOL_SIZE
 #define PBUF_POOL_SIZE 512
 #endif
 
+#ifndef REMOTE_SYSLOG_BATCH_SIZE
+#define REMOTE_SYSLOG_BATCH_SIZE 1400
+#endif
+
+#ifndef REMOTE_SYSLOG_MSG_SIZE
+#define REMOTE_SYSLOG_MSG_SIZE 256
+#endif
+
+#ifndef REMOTE_SYSLOG_RING_SIZE
+#define REMOTE_SYSLOG_RING_SIZE 64
+#endif
+
+#ifndef REMOTE_SYSLOG_TASK_PRIORITY
+#define REMOTE_SYSLOG_TASK_PRIORITY 240
+#endif
+
 #ifndef TCP_FAST_INTERVAL
 #define TCP_FAST_INTERVAL 250
 #endif
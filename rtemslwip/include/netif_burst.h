@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_NETIF_BURST_H
+#define _RTEMSLWIP_NETIF_BURST_H
+#include <lwip/netif.h>
+#include <lwip/pbuf.h>
+
+/*
+ * A burst of received packets that is passed to the stack at once. The
+ * packets are linked the way the loopback queue of lwIP links them: the next
+ * pointer of the last pbuf of a packet, the one whose len equals its tot_len,
+ * leads to the first pbuf of the following packet. netif_burst_add() frees
+ * any empty pbufs at the end of a packet to keep that unambiguous. Handing
+ * over a burst through tcpip_input() costs one tcpip message and one wakeup
+ * of the tcpip_thread, or one acquisition of the core lock with
+ * LWIP_TCPIP_CORE_LOCKING_INPUT, instead of one per packet.
+ */
+struct netif_burst {
+  struct pbuf *head;
+  struct pbuf *tail; /* Last pbuf of the last packet */
+  u16_t        count;
+};
+
+static inline void netif_burst_init(struct netif_burst *burst)
+{
+  burst->head = NULL;
+  burst->tail = NULL;
+  burst->count = 0;
+}
+
+/* Appends a packet and returns the number of packets in the burst */
+u16_t netif_burst_add(struct netif_burst *burst, struct pbuf *p);
+
+/*
+ * Passes a list of packets to netif->input. Bursts for tcpip_input() are
+ * processed in one go by the tcpip_thread, other input functions are called
+ * once per packet. On error none of the packets were taken and the caller
+ * still owns the list, which pbuf_free() releases as a whole.
+ */
+err_t netif_input_burst(struct pbuf *p, struct netif *netif);
+
+/*
+ * Passes the burst to netif and empties it. A burst that the stack does not
+ * take is freed and counted as dropped in the link statistics.
+ */
+err_t netif_burst_flush(struct netif_burst *burst, struct netif *netif);
+
+#endif
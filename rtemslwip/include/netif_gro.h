@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_NETIF_GRO_H
+#define _RTEMSLWIP_NETIF_GRO_H
+#include <lwip/netif.h>
+#include <lwip/pbuf.h>
+
+/*
+ * Generic receive offload. With LWIP_GRO, netif_input_burst() runs the
+ * packets of a burst from an Ethernet interface through netif_gro() before
+ * they reach ethernet_input(). Consecutive in-order segments of one IPv4 TCP
+ * flow are merged into one packet of up to LWIP_GRO_MAX_SIZE bytes: the
+ * payload of each following segment is appended to the pbuf chain of the
+ * first, whose IP total length and checksum are updated. tcp_input() then
+ * demultiplexes, checks and acknowledges the run once.
+ *
+ * Segments are only merged when they carry nothing but ACK and PSH, agree in
+ * their headers apart from the sequence number and the stack does not have
+ * to verify their TCP checksums because the netif already did, as the GEM
+ * does with ZYNQMP_CHECKSUM_OFFLOAD. Everything else passes unchanged and in
+ * order.
+ */
+
+struct netif_gro_stats {
+  u32_t packets;  /* Packets that left netif_gro() */
+  u32_t merged;   /* Segments appended to the one before */
+};
+
+/* Coalesces the burst p and returns it as a burst again */
+struct pbuf *netif_gro(struct pbuf *p, struct netif *netif);
+
+void netif_gro_get_stats(struct netif_gro_stats *stats);
+
+#endif
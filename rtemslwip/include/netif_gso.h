@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_NETIF_GSO_H
+#define _RTEMSLWIP_NETIF_GSO_H
+#include <lwip/netif.h>
+#include <lwip/pbuf.h>
+
+/*
+ * Generic segmentation offload. With LWIP_GSO, tcp_output() passes a run of
+ * up to netif->gso_max_size bytes of segments through IP and ARP as one GSO
+ * packet rather than one segment at a time. TCP keeps its segments of one MSS
+ * each for retransmission, so a GSO packet is a list of complete segments,
+ * each with its own TCP header and checksum and flagged with PBUF_FLAG_GSO.
+ * They are linked the way struct netif_burst links packets: the next pointer
+ * of the last pbuf of a segment, the one whose len equals its tot_len, leads
+ * to the first pbuf of the following segment. Only the first segment gets an
+ * IP and an Ethernet header on the way down.
+ *
+ * ethernet_output() passes GSO packets to netif_gso_output(), which copies
+ * those headers in front of each of the other segments, patches the IP total
+ * length, identification and checksum and hands the frames to
+ * netif->linkoutput() one by one. A driver that sets netif->gso_offload gets
+ * the list as it is instead, to have it segmented by the hardware.
+ *
+ * Whoever takes a segment for transmission clears PBUF_FLAG_GSO on it. When
+ * an error is returned, the segments still carrying the flag were not sent.
+ */
+
+struct netif_gso_stats {
+  u32_t packets;  /* GSO packets split up by netif_gso_output() */
+  u32_t segments; /* Frames passed to the drivers for them */
+};
+
+/* Returns the last pbuf of the segment starting with p */
+static inline struct pbuf *netif_gso_segment_end(struct pbuf *p)
+{
+  while (p->len != p->tot_len) {
+    p = p->next;
+  }
+  return p;
+}
+
+/*
+ * Returns 0 if p ends in empty pbufs, which netif_gso_segment_end() would not
+ * find once p is linked to the next segment. Such segments are sent alone.
+ */
+static inline int netif_gso_segment_linkable(struct pbuf *p)
+{
+  while (p->next != NULL) {
+    if (p->len == p->tot_len) {
+      return 0;
+    }
+    p = p->next;
+  }
+  return 1;
+}
+
+/* Returns the number of segments in the GSO packet p */
+u16_t netif_gso_count(struct pbuf *p);
+
+/* Detaches all but the first segment from the GSO packet p */
+void netif_gso_truncate(struct pbuf *p);
+
+/*
+ * Sends the GSO packet p, whose first segment has its link header in front,
+ * as one frame per segment. Stops at the first frame the driver refuses and
+ * returns its error.
+ */
+err_t netif_gso_output(struct netif *netif, struct pbuf *p);
+
+void netif_gso_get_stats(struct netif_gso_stats *stats);
+
+#endif
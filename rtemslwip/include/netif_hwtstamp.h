@@ -0,0 +1,79 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_NETIF_HWTSTAMP_H
+#define _RTEMSLWIP_NETIF_HWTSTAMP_H
+#include <lwip/netif.h>
+#include <lwip/err.h>
+
+#include <time.h>
+
+/*
+ * Hardware packet timestamps. With LWIP_HWTSTAMP, a netif whose MAC stamps
+ * packets against a PTP hardware clock (PHC) points its phc field at the
+ * operations of that clock and records the time of reception of each
+ * received frame in the tstamp_sec and tstamp_nsec fields of its pbuf.
+ *
+ * UDP and raw sockets with SOF_TIMESTAMPING_TX_HARDWARE set through
+ * SO_TIMESTAMPING tag each datagram they send with a request from
+ * netif_hwtstamp_tx_request() in the tstamp_id field of its pbuf. The driver
+ * reports the time the frame went out with netif_hwtstamp_tx_done() and the
+ * application reads it with recvmsg(MSG_ERRQUEUE), which returns no data and
+ * an SCM_TIMESTAMPING control message. Frames the stack copies on the way,
+ * such as datagrams that are fragmented or wait for ARP, are not stamped.
+ */
+
+struct netif_phc {
+  err_t (*gettime)(struct netif *netif, struct timespec *ts);
+  err_t (*settime)(struct netif *netif, const struct timespec *ts);
+  /* Steps the clock by delta_ns nanoseconds */
+  err_t (*adjtime)(struct netif *netif, s64_t delta_ns);
+  /* Runs the clock ppb parts per billion faster than nominal */
+  err_t (*adjfreq)(struct netif *netif, s32_t ppb);
+};
+
+/* These return ERR_IF if the netif has no hardware clock */
+err_t netif_phc_gettime(struct netif *netif, struct timespec *ts);
+err_t netif_phc_settime(struct netif *netif, const struct timespec *ts);
+err_t netif_phc_adjtime(struct netif *netif, s64_t delta_ns);
+err_t netif_phc_adjfreq(struct netif *netif, s32_t ppb);
+
+/*
+ * Returns a transmit timestamp request for socket s. At most
+ * LWIP_HWTSTAMP_TX_SLOTS requests are outstanding, a new one replaces the
+ * oldest.
+ */
+u16_t netif_hwtstamp_tx_request(int s);
+
+/* Called by drivers once the frame of request id has been sent */
+void netif_hwtstamp_tx_done(u16_t id, u32_t sec, u32_t nsec);
+
+/* Takes the oldest completed transmit timestamp of socket s, 0 if none */
+int netif_hwtstamp_tx_take(int s, struct timespec *ts);
+
+/* Drops the requests of socket s when it is closed */
+void netif_hwtstamp_tx_release(int s);
+
+#endif
@@ -26,9 +26,11 @@
 
 #ifndef _RTEMSLWIP_NETSTART_H
 #define _RTEMSLWIP_NETSTART_H
+#include <stddef.h>
 #include <lwip/init.h>
 #include <lwip/sockets.h>
 #include <lwip/ip_addr.h>
+#include <lwip/netif.h>
 
 int start_networking(
   struct netif  *net_interface,
@@ -38,6 +40,29 @@ int start_networking(
   unsigned char *mac_ethernet_address
 );
 
+/*
+ * One interface brought up by start_networking_ports(). port selects the MAC
+ * on BSPs with several of them, for instance GEM 0 to 3 on the ZynqMP.
+ */
+struct netstart_port {
+  struct netif  net_interface;
+  unsigned int  port;
+  ip_addr_t     ipaddr;
+  ip_addr_t     netmask;
+  ip_addr_t     gateway;
+  unsigned char mac_ethernet_address[6];
+};
+
+/*
+ * Brings up each of the count ports as an interface of its own with its own
+ * MAC address. The first one becomes the default interface. Returns 0 on
+ * success. It is provided by the ZynqMP BSPs.
+ */
+int start_networking_ports(
+  struct netstart_port *ports,
+  size_t                count
+);
+
 rtems_status_code start_networking_shared(void);
 
 #endif
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_REMOTE_SYSLOG_H
+#define _RTEMSLWIP_REMOTE_SYSLOG_H
+#include <rtems.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Once started, syslog() only copies the message into a lock-free ring and
+ * a low priority task sends it to the collector as RFC 5424 over UDP
+ * (RFC 5426) or TCP with octet counting framing (RFC 6587).
+ */
+struct remote_syslog_config {
+  const char          *server;   /* IPv4 or IPv6 address of the collector */
+  uint16_t             port;     /* 0 selects 514 */
+  bool                 use_tcp;
+  const char          *hostname; /* NULL selects the NILVALUE "-" */
+  rtems_task_priority  priority; /* 0 selects REMOTE_SYSLOG_TASK_PRIORITY */
+};
+
+struct remote_syslog_stats {
+  uint32_t queued;           /* messages accepted into the ring */
+  uint32_t sent;             /* messages handed to the socket */
+  uint32_t dropped_overflow; /* messages lost because the ring was full */
+  uint32_t dropped_send;     /* messages lost because the send failed */
+  uint32_t truncated;        /* messages longer than REMOTE_SYSLOG_MSG_SIZE */
+  uint32_t high_water;       /* largest number of queued messages seen */
+};
+
+rtems_status_code remote_syslog_start(
+  const struct remote_syslog_config *config
+);
+
+void remote_syslog_get_stats(struct remote_syslog_stats *stats);
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_RXPOOL_H
+#define _RTEMSLWIP_RXPOOL_H
+#include <lwip/pbuf.h>
+
+/*
+ * A fixed set of receive buffers owned by a network driver. Each buffer is
+ * handed to the stack as a custom pbuf whose payload starts and ends on a
+ * data cache line, so that it may be invalidated without a clean. When the
+ * stack frees it, it goes straight back to the pool for the next descriptor
+ * refill instead of to the PBUF_POOL. Once the pool is set up the receive
+ * path makes no allocator calls as long as the stack returns buffers as fast
+ * as the driver takes them.
+ */
+
+struct rxpool;
+
+/*
+ * Called when a buffer is returned to an empty pool, the point at which a
+ * driver that could not refill its ring may do so again. It is called from
+ * the context freeing the pbuf and must not touch the ring directly unless
+ * the driver serializes that against its receive path.
+ */
+typedef void (*rxpool_recycle_fn)(void *arg);
+
+struct rxpool_buf {
+  struct pbuf_custom custom;
+  struct rxpool     *pool;
+  struct rxpool_buf *next;
+  void              *payload;
+};
+
+struct rxpool_stats {
+  u16_t size;
+  u16_t free;
+  u16_t low_water;
+  u32_t takes;
+  u32_t empty;      /* takes that found the pool empty */
+};
+
+struct rxpool {
+  struct rxpool_buf  *free_list;
+  rxpool_recycle_fn   recycle;
+  void               *recycle_arg;
+  u16_t               buf_size;
+  struct rxpool_stats stats;
+};
+
+/*
+ * Allocates count buffers of buf_size bytes once. Returns ERR_MEM if they
+ * cannot be allocated, in which case the pool stays empty.
+ */
+err_t rxpool_init(
+  struct rxpool    *pool,
+  u16_t             count,
+  u16_t             buf_size,
+  rxpool_recycle_fn recycle,
+  void             *recycle_arg
+);
+
+/* Bytes of cache line aligned memory needed by rxpool_init_mem() */
+size_t rxpool_mem_size(u16_t count, u16_t buf_size);
+
+/*
+ * Sets the pool up in memory provided by the driver, for example memory that
+ * is mapped for the DMA path instead of ordinary cached memory.
+ */
+void rxpool_init_mem(
+  struct rxpool    *pool,
+  void             *mem,
+  u16_t             count,
+  u16_t             buf_size,
+  rxpool_recycle_fn recycle,
+  void             *recycle_arg
+);
+
+/*
+ * Takes a buffer as a single pbuf of buf_size bytes or returns NULL if the
+ * pool is empty. May be called from any thread.
+ */
+struct pbuf *rxpool_take(struct rxpool *pool);
+
+void rxpool_get_stats(struct rxpool *pool, struct rxpool_stats *stats);
+
+#endif
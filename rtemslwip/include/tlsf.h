@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_TLSF_H
+#define _RTEMSLWIP_TLSF_H
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Two-level segregated fit allocator (Masmano et al., "TLSF: a New Dynamic
+ * Memory Allocator for Real-Time Systems"). Free blocks are kept in lists
+ * indexed by the position of the most significant bit of their size and by
+ * the next TLSF_SL_LOG2 bits, with a bitmap per level, so allocation and free
+ * take a constant number of steps regardless of the heap state. A request is
+ * rounded up to the next list boundary before the search, which bounds the
+ * internal fragmentation by 1 / 2^TLSF_SL_LOG2 of the request.
+ *
+ * The allocator does no locking of its own.
+ */
+
+#define TLSF_SL_LOG2 5
+#define TLSF_SL_COUNT ( 1U << TLSF_SL_LOG2 )
+#define TLSF_FL_COUNT 32
+
+struct tlsf_block;
+
+struct tlsf {
+  size_t             align;
+  size_t             header;     /* block header rounded up to align */
+  size_t             min_size;   /* smallest payload of a block */
+  unsigned int       fl_shift;
+  uint8_t           *start;
+  uint8_t           *end;
+  uint32_t           fl_bitmap;
+  uint32_t           sl_bitmap[ TLSF_FL_COUNT ];
+  struct tlsf_block *free[ TLSF_FL_COUNT ][ TLSF_SL_COUNT ];
+};
+
+/* Bytes of a pool that are not available to allocations */
+#define TLSF_POOL_OVERHEAD( align ) \
+  ( 2 * ( ( 2 * sizeof( void * ) + ( align ) - 1 ) & ~( (size_t) ( align ) - 1 ) ) )
+
+/*
+ * Sets up a heap in the memory area of the given size, which must be aligned
+ * to align. align must be a power of two and all returned blocks are aligned
+ * to it.
+ */
+void tlsf_init( struct tlsf *tlsf, void *mem, size_t size, size_t align );
+
+void *tlsf_malloc( struct tlsf *tlsf, size_t size );
+
+void tlsf_free( struct tlsf *tlsf, void *ptr );
+
+/* Shrinks a block in place, the excess is returned to the heap */
+void tlsf_shrink( struct tlsf *tlsf, void *ptr, size_t size );
+
+/* Usable size of an allocated block, at least the requested size */
+size_t tlsf_block_size( const struct tlsf *tlsf, const void *ptr );
+
+bool tlsf_contains( const struct tlsf *tlsf, const void *ptr );
+
+/* Calls visitor for every allocated block in address order */
+void tlsf_walk_used(
+  struct tlsf *tlsf,
+  void       ( *visitor )( void *ptr, size_t size, void *arg ),
+  void        *arg
+);
+
+#endif
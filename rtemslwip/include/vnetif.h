@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _RTEMSLWIP_VNETIF_H
+#define _RTEMSLWIP_VNETIF_H
+#include <lwip/netif.h>
+#include <lwip/sys.h>
+
+#ifndef __rtems__
+#include <pthread.h>
+#include <stdbool.h>
+#endif
+
+#ifndef VNETIF_QUEUE_LEN
+#define VNETIF_QUEUE_LEN 1024
+#endif
+
+#ifndef VNETIF_THREAD_STACKSIZE
+#define VNETIF_THREAD_STACKSIZE 8192
+#endif
+
+/*
+ * Impairments applied to frames leaving an interface, modelled on netem.
+ * Frames are serialized at rate_kbps, then held for delay_us plus a uniformly
+ * distributed extra of up to jitter_us. Frames keep their order unless they
+ * are picked for reordering, in which case they skip the delay. Probabilities
+ * are in parts per million. Delays are honoured to the microsecond on the host
+ * and with the resolution of the sys_arch timeouts on RTEMS, which is one
+ * millisecond or one clock tick, see vnetif_resolution_us().
+ */
+struct vnetif_impairment {
+  u32_t rate_kbps;   /* 0 for unlimited */
+  u32_t delay_us;
+  u32_t jitter_us;
+  u32_t loss_ppm;
+  u32_t reorder_ppm;
+};
+
+struct vnetif_stats {
+  u32_t tx_packets;
+  u32_t tx_bytes;
+  u32_t tx_drops;      /* no pbuf or the peer queue was full */
+  u32_t tx_lost;       /* dropped by the loss impairment */
+  u32_t tx_reordered;
+  u32_t rx_packets;
+};
+
+struct vnetif_frame {
+  struct pbuf *p;
+  u64_t        due_us;
+};
+
+/*
+ * A pair of Ethernet interfaces wired back to back inside one process. Every
+ * frame sent on one side is copied into a fresh pool pbuf and queued, ordered
+ * by delivery time, to the receive thread of the other side. That thread feeds
+ * it to ethernet_input() with the core locked, as a driver with a dedicated
+ * input thread would. With LWIP_HWTSTAMP, frames are stamped on transmission
+ * and on delivery with vnetif_now_us().
+ */
+struct vnetif {
+  struct netif             netif;
+  struct vnetif           *peer;
+  struct vnetif_impairment impairment;
+  struct vnetif_stats      stats;
+  sys_mutex_t              lock;
+#ifdef __rtems__
+  sys_sem_t                rx_ready;
+#else
+  pthread_mutex_t          rx_wait_lock;
+  pthread_cond_t           rx_wait;
+  bool                     rx_kicked;
+#endif
+  struct vnetif_frame      rx_queue[VNETIF_QUEUE_LEN];
+  unsigned int             rx_head;
+  unsigned int             rx_count;
+  u64_t                    link_free_us;
+  u64_t                    last_due_us;
+};
+
+/*
+ * Both interfaces sit on the same subnet, so routing by destination alone
+ * would send everything out of whichever was added first and short-circuit
+ * the replies through the loopback path. With LWIP_VNETIF this is installed
+ * as LWIP_HOOK_IP4_ROUTE_SRC so that traffic leaves through the interface
+ * that owns the source address.
+ */
+struct netif *vnetif_route_src(const ip4_addr_t *src, const ip4_addr_t *dest);
+
+/* Must be called with the core locked or from the tcpip thread */
+err_t vnetif_pair_add(
+  struct vnetif     *a,
+  struct vnetif     *b,
+  const ip4_addr_t  *addr_a,
+  const ip4_addr_t  *addr_b,
+  const ip4_addr_t  *netmask
+);
+
+/* Changes the impairment of frames sent by vif, may be called at any time */
+void vnetif_set_impairment(
+  struct vnetif                  *vif,
+  const struct vnetif_impairment *impairment
+);
+
+void vnetif_get_stats(struct vnetif *vif, struct vnetif_stats *stats);
+
+u64_t vnetif_now_us(void);
+
+/* Returns the granularity in microseconds with which delays are applied */
+u32_t vnetif_resolution_us(void);
+
+#endif
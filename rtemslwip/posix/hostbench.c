@@ -0,0 +1,437 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host microbenchmarks for the stack hot paths. The output uses the same
+ * "BENCH" line format as benchmark01.exe so that host and target numbers can
+ * be collected by the same scripts. Run under perf or valgrind as needed.
+ */
+
+#include <lwip/inet_chksum.h>
+#include <lwip/mem.h>
+#include <lwip/pbuf.h>
+#include <lwip/prot/ip.h>
+#include <lwip/sockets.h>
+#include <lwip/tcpip.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <tlsf.h>
+#include <vnetif.h>
+#if LWIP_GSO
+#include <netif_gso.h>
+#endif
+
+#ifndef LWIP_BUILD_PROFILE
+#define LWIP_BUILD_PROFILE "unknown"
+#endif
+
+#define BENCH_ITERATIONS 1000000
+#define BENCH_MEM_OPERATIONS 1000000
+#define BENCH_MEM_SLOTS 1024
+#define BENCH_TCP_BYTES ( 256 * 1024 * 1024 )
+#define BENCH_TCP_PORT 5001
+#define BENCH_TCP_CHUNK 16384
+
+#if LWIP_GSO
+#define BENCH_GSO_TAG "gso"
+#else
+#define BENCH_GSO_TAG "nogso"
+#endif
+
+static struct vnetif vnet_a;
+static struct vnetif vnet_b;
+static u8_t data[ 1500 ];
+static u8_t tcp_buffer[ BENCH_TCP_CHUNK ];
+static sys_sem_t ready;
+static sys_sem_t done;
+static u64_t tcp_received;
+static volatile u32_t result_sink;
+static u32_t mem_samples[ BENCH_MEM_OPERATIONS ];
+static void *mem_slots[ BENCH_MEM_SLOTS ];
+static struct tlsf tlsf_heap;
+LWIP_DECLARE_MEMORY_ALIGNED(
+  tlsf_pool,
+  MEM_SIZE + TLSF_POOL_OVERHEAD( MEM_ALIGNMENT )
+);
+
+static u64_t now_ns( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return (u64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* CPU time of all threads, the sender, tcpip and vnetif ones included */
+static u64_t cpu_ns( void )
+{
+  struct timespec ts;
+
+  clock_gettime( CLOCK_PROCESS_CPUTIME_ID, &ts );
+  return (u64_t) ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void report( const char *test, u64_t ns, double value, const char *unit )
+{
+  printf(
+    "BENCH profile=%s test=%s ns=%llu value=%.2f unit=%s\n",
+    LWIP_BUILD_PROFILE,
+    test,
+    (unsigned long long) ns,
+    value,
+    unit
+  );
+}
+
+static void bench_chksum_pseudo( void )
+{
+  ip_addr_t src = IPADDR4_INIT_BYTES( 10, 0, 0, 1 );
+  ip_addr_t dst = IPADDR4_INIT_BYTES( 10, 0, 0, 2 );
+  struct pbuf *p;
+  u64_t start;
+  u64_t ns;
+  u32_t sum = 0;
+  int i;
+
+  p = pbuf_alloc( PBUF_RAW, sizeof( data ), PBUF_POOL );
+  LWIP_ASSERT( "pbuf", p != NULL );
+  pbuf_take( p, data, sizeof( data ) );
+
+  start = now_ns();
+  for ( i = 0; i < BENCH_ITERATIONS; i++ ) {
+    sum += ip_chksum_pseudo( p, IP_PROTO_TCP, p->tot_len, &src, &dst );
+  }
+  ns = now_ns() - start;
+  pbuf_free( p );
+  result_sink = sum;
+
+  report(
+    "inet_chksum_pseudo",
+    ns,
+    (double) BENCH_ITERATIONS * sizeof( data ) * 1000.0 / ns,
+    "MB/s"
+  );
+}
+
+static void bench_pbuf_copy_partial( void )
+{
+  static u8_t out[ sizeof( data ) ];
+  struct pbuf *p;
+  struct pbuf *q;
+  u64_t start;
+  u64_t ns;
+  int i;
+
+  /* A chain of small segments is the expensive case for the copy loop */
+  p = pbuf_alloc( PBUF_RAW, 256, PBUF_RAM );
+  while ( p->tot_len < sizeof( data ) ) {
+    q = pbuf_alloc( PBUF_RAW, 256, PBUF_RAM );
+    LWIP_ASSERT( "pbuf", q != NULL );
+    pbuf_cat( p, q );
+  }
+
+  start = now_ns();
+  for ( i = 0; i < BENCH_ITERATIONS; i++ ) {
+    pbuf_copy_partial( p, out, sizeof( out ), i & 63 );
+  }
+  ns = now_ns() - start;
+  pbuf_free( p );
+
+  report(
+    "pbuf_copy_partial",
+    ns,
+    (double) BENCH_ITERATIONS * sizeof( out ) * 1000.0 / ns,
+    "MB/s"
+  );
+}
+
+static void bench_mem_malloc( void )
+{
+  static const mem_size_t sizes[] = { 64, 200, 512, 1536 };
+  void *ptrs[ 4 ];
+  u64_t start;
+  u64_t ns;
+  int i;
+  int j;
+
+  start = now_ns();
+  for ( i = 0; i < BENCH_ITERATIONS; i++ ) {
+    for ( j = 0; j < 4; j++ ) {
+      ptrs[ j ] = mem_malloc( sizes[ ( i + j ) & 3 ] );
+    }
+    for ( j = 0; j < 4; j++ ) {
+      mem_free( ptrs[ j ] );
+    }
+  }
+  ns = now_ns() - start;
+
+  report(
+    "mem_malloc",
+    ns,
+    (double) BENCH_ITERATIONS * 4 * 1000000000.0 / ns,
+    "ops/s"
+  );
+}
+
+static void *tlsf_heap_malloc( mem_size_t size )
+{
+  return tlsf_malloc( &tlsf_heap, size );
+}
+
+static void tlsf_heap_free( void *ptr )
+{
+  tlsf_free( &tlsf_heap, ptr );
+}
+
+/* Mostly small control blocks and packet sized buffers, some jumbo frames */
+static mem_size_t mem_random_size( u32_t r )
+{
+  u32_t kind = r % 100;
+
+  r /= 100;
+  if ( kind < 70 ) {
+    return 64 + r % 192;
+  }
+  if ( kind < 95 ) {
+    return 256 + r % 1344;
+  }
+  return 1600 + r % 7400;
+}
+
+static int compare_u32( const void *a, const void *b )
+{
+  u32_t x = *(const u32_t *) a;
+  u32_t y = *(const u32_t *) b;
+
+  return ( x > y ) - ( x < y );
+}
+
+/*
+ * The same fragmenting workload as benchmark01.exe, run against the lwIP
+ * heap and against a TLSF heap of the same size, which the host build can
+ * link side by side.
+ */
+static void bench_mem_latency(
+  const char *backend,
+  void     *( *alloc )( mem_size_t ),
+  void      ( *release )( void * )
+)
+{
+  char test[ 64 ];
+  u32_t seed = 1;
+  u32_t count = 0;
+  u64_t total = 0;
+  int i;
+
+  for ( i = 0; i < BENCH_MEM_OPERATIONS; i++ ) {
+    u32_t slot;
+    u64_t start;
+    u64_t ns;
+
+    seed = seed * 1103515245 + 12345;
+    slot = ( seed >> 8 ) % BENCH_MEM_SLOTS;
+    if ( mem_slots[ slot ] != NULL ) {
+      ( *release )( mem_slots[ slot ] );
+      mem_slots[ slot ] = NULL;
+      continue;
+    }
+
+    seed = seed * 1103515245 + 12345;
+    start = now_ns();
+    mem_slots[ slot ] = ( *alloc )( mem_random_size( seed >> 8 ) );
+    ns = now_ns() - start;
+    mem_samples[ count++ ] = (u32_t) ns;
+    total += ns;
+  }
+
+  for ( i = 0; i < BENCH_MEM_SLOTS; i++ ) {
+    if ( mem_slots[ i ] != NULL ) {
+      ( *release )( mem_slots[ i ] );
+      mem_slots[ i ] = NULL;
+    }
+  }
+
+  qsort( mem_samples, count, sizeof( mem_samples[ 0 ] ), compare_u32 );
+  snprintf( test, sizeof( test ), "mem_malloc_%s_mean", backend );
+  report( test, total, (double) total / count, "ns" );
+  snprintf( test, sizeof( test ), "mem_malloc_%s_p99", backend );
+  report( test, total, mem_samples[ (u64_t) ( count - 1 ) * 99 / 100 ], "ns" );
+  snprintf( test, sizeof( test ), "mem_malloc_%s_max", backend );
+  report( test, total, mem_samples[ count - 1 ], "ns" );
+}
+
+static void tcp_sink( void *arg )
+{
+  static u8_t sink[ BENCH_TCP_CHUNK ];
+  struct sockaddr_in addr;
+  int listener;
+  int fd;
+  ssize_t n;
+
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sin_len = sizeof( addr );
+  addr.sin_family = AF_INET;
+  addr.sin_port = lwip_htons( BENCH_TCP_PORT );
+  addr.sin_addr.s_addr = ip4_addr_get_u32( netif_ip4_addr( &vnet_b.netif ) );
+
+  listener = lwip_socket( AF_INET, SOCK_STREAM, 0 );
+  lwip_bind( listener, (struct sockaddr *) &addr, sizeof( addr ) );
+  lwip_listen( listener, 1 );
+  sys_sem_signal( &ready );
+
+  fd = lwip_accept( listener, NULL, NULL );
+  while ( ( n = lwip_recv( fd, sink, sizeof( sink ), 0 ) ) > 0 ) {
+    tcp_received += n;
+  }
+  lwip_close( fd );
+  lwip_close( listener );
+  sys_sem_signal( &done );
+}
+
+/*
+ * Exercises tcp_output/tcp_input through the Ethernet and IP layers. Besides
+ * the rate, the CPU time spent per data frame sent is reported, tagged with
+ * whether LWIP_GSO is enabled, so builds with and without it can be compared.
+ */
+static void bench_tcp_vnetif( void )
+{
+  struct sockaddr_in local;
+  struct sockaddr_in remote;
+  struct vnetif_stats before;
+  struct vnetif_stats stats;
+#if LWIP_GSO
+  struct netif_gso_stats gso;
+#endif
+  u32_t frames;
+  u64_t sent = 0;
+  u64_t start;
+  u64_t cpu;
+  u64_t ns;
+  int fd;
+
+  sys_sem_new( &ready, 0 );
+  sys_sem_new( &done, 0 );
+  sys_thread_new( "sink", tcp_sink, NULL, 0, 0 );
+  sys_arch_sem_wait( &ready, 0 );
+
+  memset( &local, 0, sizeof( local ) );
+  local.sin_len = sizeof( local );
+  local.sin_family = AF_INET;
+  local.sin_addr.s_addr = ip4_addr_get_u32( netif_ip4_addr( &vnet_a.netif ) );
+  remote = local;
+  remote.sin_port = lwip_htons( BENCH_TCP_PORT );
+  remote.sin_addr.s_addr = ip4_addr_get_u32( netif_ip4_addr( &vnet_b.netif ) );
+
+  fd = lwip_socket( AF_INET, SOCK_STREAM, 0 );
+  lwip_bind( fd, (struct sockaddr *) &local, sizeof( local ) );
+  if ( lwip_connect( fd, (struct sockaddr *) &remote, sizeof( remote ) ) != 0 ) {
+    printf( "hostbench: connect failed\n" );
+    exit( 1 );
+  }
+
+  vnetif_get_stats( &vnet_a, &before );
+  cpu = cpu_ns();
+  start = now_ns();
+  while ( sent < BENCH_TCP_BYTES ) {
+    ssize_t n = lwip_send( fd, tcp_buffer, sizeof( tcp_buffer ), 0 );
+
+    if ( n <= 0 ) {
+      break;
+    }
+    sent += n;
+  }
+  lwip_close( fd );
+  sys_arch_sem_wait( &done, 0 );
+  ns = now_ns() - start;
+  cpu = cpu_ns() - cpu;
+
+  report( "tcp_vnetif", ns, (double) tcp_received * 8000.0 / ns, "Mbit/s" );
+  vnetif_get_stats( &vnet_a, &stats );
+  frames = stats.tx_packets - before.tx_packets;
+  report(
+    "tcp_vnetif_cpu_per_frame_" BENCH_GSO_TAG,
+    cpu,
+    frames != 0 ? (double) cpu / frames : 0.0,
+    "ns"
+  );
+#if LWIP_GSO
+  netif_gso_get_stats( &gso );
+  printf(
+    "gso: packets=%u segments=%u\n",
+    (unsigned) gso.packets,
+    (unsigned) gso.segments
+  );
+#endif
+  printf(
+    "vnetif a: tx_packets=%u tx_bytes=%u tx_drops=%u rx_packets=%u\n",
+    stats.tx_packets,
+    stats.tx_bytes,
+    stats.tx_drops,
+    stats.rx_packets
+  );
+}
+
+int main( int argc, char **argv )
+{
+  ip4_addr_t addr_a;
+  ip4_addr_t addr_b;
+  ip4_addr_t netmask;
+  int i;
+
+  (void) argc;
+  (void) argv;
+
+  for ( i = 0; i < sizeof( data ); i++ ) {
+    data[ i ] = (u8_t) i;
+  }
+
+  setvbuf( stdout, NULL, _IOLBF, 0 );
+  tcpip_init( NULL, NULL );
+
+  IP4_ADDR( &addr_a, 192, 168, 100, 1 );
+  IP4_ADDR( &addr_b, 192, 168, 100, 2 );
+  IP4_ADDR( &netmask, 255, 255, 255, 0 );
+  LOCK_TCPIP_CORE();
+  vnetif_pair_add( &vnet_a, &vnet_b, &addr_a, &addr_b, &netmask );
+  UNLOCK_TCPIP_CORE();
+
+  bench_chksum_pseudo();
+  bench_pbuf_copy_partial();
+  bench_mem_malloc();
+  bench_mem_latency( "heap", mem_malloc, mem_free );
+  tlsf_init(
+    &tlsf_heap,
+    LWIP_MEM_ALIGN( tlsf_pool ),
+    MEM_SIZE + TLSF_POOL_OVERHEAD( MEM_ALIGNMENT ),
+    MEM_ALIGNMENT
+  );
+  bench_mem_latency( "tlsf", tlsf_heap_malloc, tlsf_heap_free );
+  bench_tcp_vnetif();
+
+  return 0;
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Host entry point of the hardware timestamp checks in
+ * rtemslwip/test/hwtstamp01, the virtual interfaces stand in for a MAC with a
+ * timestamp unit.
+ */
+
+#include <lwip/tcpip.h>
+
+#include <stdio.h>
+
+#include "hwtstamp_suite.h"
+
+static struct vnetif vnet_a;
+static struct vnetif vnet_b;
+
+int main( void )
+{
+  ip4_addr_t addr_a;
+  ip4_addr_t addr_b;
+  ip4_addr_t netmask;
+  err_t err;
+
+  setvbuf( stdout, NULL, _IOLBF, 0 );
+  tcpip_init( NULL, NULL );
+
+  IP4_ADDR( &addr_a, 192, 168, 100, 1 );
+  IP4_ADDR( &addr_b, 192, 168, 100, 2 );
+  IP4_ADDR( &netmask, 255, 255, 255, 0 );
+  LOCK_TCPIP_CORE();
+  err = vnetif_pair_add( &vnet_a, &vnet_b, &addr_a, &addr_b, &netmask );
+  UNLOCK_TCPIP_CORE();
+  if ( err != ERR_OK ) {
+    printf( "hwtstamp01: vnetif_pair_add failed: %d\n", err );
+    return 1;
+  }
+
+  return hwtstamp_suite_run( &vnet_a, &vnet_b ) == 0 ? 0 : 1;
+}
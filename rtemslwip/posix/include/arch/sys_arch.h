@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Mapping of the lwIP system abstraction onto POSIX threads for the host
+ * build. Semaphores and mailboxes are embedded in the lwIP objects so that
+ * creating them does not allocate.
+ */
+#ifndef __ARCH_SYS_ARCH_H__
+#define __ARCH_SYS_ARCH_H__
+
+#include <pthread.h>
+
+#if defined(NO_SYS) && NO_SYS
+  #error "POSIX SYS_ARCH cannot be compiled in NO_SYS variant"
+#endif
+
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t  cond;
+  unsigned int    count;
+  int             valid;
+} sys_sem_t;
+
+typedef struct {
+  pthread_mutex_t mutex;
+} sys_mutex_t;
+
+typedef struct {
+  pthread_mutex_t mutex;
+  pthread_cond_t  not_empty;
+  pthread_cond_t  not_full;
+  void          **msgs;
+  unsigned int    size;
+  unsigned int    head;
+  unsigned int    count;
+  int             valid;
+} sys_mbox_t;
+
+typedef pthread_t sys_thread_t;
+typedef int sys_prot_t;
+
+void sys_arch_delay(unsigned int x);
+
+#endif /* __ARCH_SYS_ARCH_H__ */
@@ -0,0 +1,385 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * POSIX implementation of the lwIP system abstraction used by the host build.
+ * It mirrors the semantics of rtemslwip/common/sys_arch.c closely enough that
+ * the core behaves the same, but makes no attempt at real-time behaviour.
+ */
+
+#include <lwip/sys.h>
+#include <lwip/opt.h>
+#include <arch/sys_arch.h>
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static pthread_mutex_t protect_mutex;
+
+static void deadline_after(struct timespec *ts, u32_t timeout)
+{
+  clock_gettime(CLOCK_MONOTONIC, ts);
+  ts->tv_sec += timeout / 1000;
+  ts->tv_nsec += (long) (timeout % 1000) * 1000000;
+  if ( ts->tv_nsec >= 1000000000 ) {
+    ts->tv_sec++;
+    ts->tv_nsec -= 1000000000;
+  }
+}
+
+static void cond_init(pthread_cond_t *cond)
+{
+  pthread_condattr_t attr;
+
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(cond, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+/* Returns 0 when the condition was signalled and -1 on timeout */
+static int cond_wait(
+  pthread_cond_t *cond,
+  pthread_mutex_t *mutex,
+  const struct timespec *deadline
+)
+{
+  if ( deadline == NULL ) {
+    pthread_cond_wait(cond, mutex);
+    return 0;
+  }
+  return pthread_cond_timedwait(cond, mutex, deadline) == ETIMEDOUT ? -1 : 0;
+}
+
+u32_t
+sys_now(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (u32_t) (ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void
+sys_init(void)
+{
+  pthread_mutexattr_t attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&protect_mutex, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+err_t
+sys_sem_new(sys_sem_t *sem, u8_t count)
+{
+  pthread_mutex_init(&sem->mutex, NULL);
+  cond_init(&sem->cond);
+  sem->count = count;
+  sem->valid = 1;
+  return ERR_OK;
+}
+
+void
+sys_sem_free(sys_sem_t *sem)
+{
+  pthread_cond_destroy(&sem->cond);
+  pthread_mutex_destroy(&sem->mutex);
+  sem->valid = 0;
+}
+
+void
+sys_sem_signal(sys_sem_t *sem)
+{
+  pthread_mutex_lock(&sem->mutex);
+  sem->count++;
+  pthread_cond_signal(&sem->cond);
+  pthread_mutex_unlock(&sem->mutex);
+}
+
+u32_t
+sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
+{
+  struct timespec deadline;
+  u32_t start = sys_now();
+
+  if ( timeout != 0 ) {
+    deadline_after(&deadline, timeout);
+  }
+
+  pthread_mutex_lock(&sem->mutex);
+  while ( sem->count == 0 ) {
+    if ( cond_wait(&sem->cond, &sem->mutex,
+           timeout != 0 ? &deadline : NULL) != 0 ) {
+      pthread_mutex_unlock(&sem->mutex);
+      return SYS_ARCH_TIMEOUT;
+    }
+  }
+  sem->count--;
+  pthread_mutex_unlock(&sem->mutex);
+
+  return sys_now() - start;
+}
+
+int
+sys_sem_valid(sys_sem_t *sem)
+{
+  return sem->valid;
+}
+
+void
+sys_sem_set_invalid(sys_sem_t *sem)
+{
+  sem->valid = 0;
+}
+
+err_t
+sys_mbox_new(sys_mbox_t *mbox, int size)
+{
+  if ( size <= 0 ) {
+    size = 1;
+  }
+
+  mbox->msgs = calloc(size, sizeof(*mbox->msgs));
+  if ( mbox->msgs == NULL ) {
+    return ERR_MEM;
+  }
+
+  pthread_mutex_init(&mbox->mutex, NULL);
+  cond_init(&mbox->not_empty);
+  cond_init(&mbox->not_full);
+  mbox->size = size;
+  mbox->head = 0;
+  mbox->count = 0;
+  mbox->valid = 1;
+  return ERR_OK;
+}
+
+void
+sys_mbox_free(sys_mbox_t *mbox)
+{
+  pthread_cond_destroy(&mbox->not_full);
+  pthread_cond_destroy(&mbox->not_empty);
+  pthread_mutex_destroy(&mbox->mutex);
+  free(mbox->msgs);
+  mbox->msgs = NULL;
+  mbox->valid = 0;
+}
+
+static void
+mbox_put_locked(sys_mbox_t *mbox, void *msg)
+{
+  mbox->msgs[(mbox->head + mbox->count) % mbox->size] = msg;
+  mbox->count++;
+  pthread_cond_signal(&mbox->not_empty);
+}
+
+void
+sys_mbox_post(sys_mbox_t *mbox, void *msg)
+{
+  pthread_mutex_lock(&mbox->mutex);
+  while ( mbox->count == mbox->size ) {
+    pthread_cond_wait(&mbox->not_full, &mbox->mutex);
+  }
+  mbox_put_locked(mbox, msg);
+  pthread_mutex_unlock(&mbox->mutex);
+}
+
+err_t
+sys_mbox_trypost(sys_mbox_t *mbox, void *msg)
+{
+  err_t err = ERR_MEM;
+
+  pthread_mutex_lock(&mbox->mutex);
+  if ( mbox->count < mbox->size ) {
+    mbox_put_locked(mbox, msg);
+    err = ERR_OK;
+  }
+  pthread_mutex_unlock(&mbox->mutex);
+  return err;
+}
+
+err_t
+sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg)
+{
+  return sys_mbox_trypost(mbox, msg);
+}
+
+static void *
+mbox_get_locked(sys_mbox_t *mbox)
+{
+  void *msg = mbox->msgs[mbox->head];
+
+  mbox->head = (mbox->head + 1) % mbox->size;
+  mbox->count--;
+  pthread_cond_signal(&mbox->not_full);
+  return msg;
+}
+
+u32_t
+sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout)
+{
+  struct timespec deadline;
+  u32_t start = sys_now();
+  void *tmp;
+
+  if ( timeout != 0 ) {
+    deadline_after(&deadline, timeout);
+  }
+
+  pthread_mutex_lock(&mbox->mutex);
+  while ( mbox->count == 0 ) {
+    if ( cond_wait(&mbox->not_empty, &mbox->mutex,
+           timeout != 0 ? &deadline : NULL) != 0 ) {
+      pthread_mutex_unlock(&mbox->mutex);
+      return SYS_ARCH_TIMEOUT;
+    }
+  }
+  tmp = mbox_get_locked(mbox);
+  pthread_mutex_unlock(&mbox->mutex);
+
+  if ( msg != NULL ) {
+    *msg = tmp;
+  }
+  return sys_now() - start;
+}
+
+u32_t
+sys_arch_mbox_tryfetch(sys_mbox_t *mbox, void **msg)
+{
+  void *tmp;
+
+  pthread_mutex_lock(&mbox->mutex);
+  if ( mbox->count == 0 ) {
+    pthread_mutex_unlock(&mbox->mutex);
+    return SYS_MBOX_EMPTY;
+  }
+  tmp = mbox_get_locked(mbox);
+  pthread_mutex_unlock(&mbox->mutex);
+
+  if ( msg != NULL ) {
+    *msg = tmp;
+  }
+  return 0;
+}
+
+int
+sys_mbox_valid(sys_mbox_t *mbox)
+{
+  return mbox->valid;
+}
+
+void
+sys_mbox_set_invalid(sys_mbox_t *mbox)
+{
+  mbox->valid = 0;
+}
+
+struct thread_start {
+  lwip_thread_fn function;
+  void *arg;
+};
+
+static void *
+thread_trampoline(void *arg)
+{
+  struct thread_start start = *(struct thread_start *) arg;
+
+  free(arg);
+  start.function(start.arg);
+  return NULL;
+}
+
+sys_thread_t
+sys_thread_new(const char *name, lwip_thread_fn function, void *arg, int stack_size, int prio)
+{
+  struct thread_start *start;
+  pthread_t thread;
+
+  (void) name;
+  (void) stack_size;
+  (void) prio;
+
+  start = malloc(sizeof(*start));
+  if ( start == NULL ) {
+    return 0;
+  }
+  start->function = function;
+  start->arg = arg;
+
+  if ( pthread_create(&thread, NULL, thread_trampoline, start) != 0 ) {
+    free(start);
+    return 0;
+  }
+  pthread_detach(thread);
+  return thread;
+}
+
+err_t
+sys_mutex_new(sys_mutex_t *mutex)
+{
+  return pthread_mutex_init(&mutex->mutex, NULL) == 0 ? ERR_OK : ERR_MEM;
+}
+
+void
+sys_mutex_lock(sys_mutex_t *mutex)
+{
+  pthread_mutex_lock(&mutex->mutex);
+}
+
+void
+sys_mutex_unlock(sys_mutex_t *mutex)
+{
+  pthread_mutex_unlock(&mutex->mutex);
+}
+
+void
+sys_mutex_free(sys_mutex_t *mutex)
+{
+  pthread_mutex_destroy(&mutex->mutex);
+}
+
+void
+sys_arch_delay(unsigned int timeout)
+{
+  usleep(timeout * 1000);
+}
+
+sys_prot_t
+sys_arch_protect(void)
+{
+  pthread_mutex_lock(&protect_mutex);
+  return 0;
+}
+
+void
+sys_arch_unprotect(sys_prot_t pval)
+{
+  (void) pval;
+  pthread_mutex_unlock(&protect_mutex);
+}
@@ -0,0 +1,324 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Measures the stack in isolation from any network hardware so that the
+ * numbers of the different build profiles can be compared on any BSP. Each
+ * result is printed as a single "BENCH" line that can be collected from the
+ * console log.
+ */
+
+#include <lwip/inet_chksum.h>
+#include <lwip/mem.h>
+#include <lwip/pbuf.h>
+#include <lwip/sockets.h>
+#include <lwip/tcpip.h>
+#include <arch/sys_arch.h>
+
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tmacros.h>
+
+#include <netstart.h>
+
+#ifndef LWIP_BUILD_PROFILE
+#define LWIP_BUILD_PROFILE "unknown"
+#endif
+
+#if MEM_TLSF
+#define BENCH_MEM_BACKEND "tlsf"
+#else
+#define BENCH_MEM_BACKEND "heap"
+#endif
+
+#define BENCH_CHKSUM_ITERATIONS 100000
+#define BENCH_MEM_OPERATIONS 200000
+#define BENCH_MEM_SLOTS 1024
+#define BENCH_PBUF_ITERATIONS 100000
+#define BENCH_TCP_BYTES ( 32 * 1024 * 1024 )
+#define BENCH_TCP_PORT 5001
+#define BENCH_TCP_CHUNK 8192
+
+const char rtems_test_name[] = "BENCHMARK 1";
+
+static uint8_t chksum_buffer[ 1500 ];
+static uint8_t tcp_buffer[ BENCH_TCP_CHUNK ];
+static uint32_t mem_samples[ BENCH_MEM_OPERATIONS ];
+static void *mem_slots[ BENCH_MEM_SLOTS ];
+static sys_sem_t tcp_done;
+static uint64_t tcp_received;
+
+static void report( const char *test, uint64_t ns, double value, const char *unit )
+{
+  printf(
+    "BENCH profile=%s test=%s ns=%" PRIu64 " value=%.2f unit=%s\n",
+    LWIP_BUILD_PROFILE,
+    test,
+    ns,
+    value,
+    unit
+  );
+}
+
+static void bench_chksum( void )
+{
+  uint64_t start;
+  uint64_t ns;
+  uint32_t sum = 0;
+  int i;
+
+  for ( i = 0; i < sizeof( chksum_buffer ); i++ ) {
+    chksum_buffer[ i ] = (uint8_t) i;
+  }
+
+  start = rtems_clock_get_uptime_nanoseconds();
+  for ( i = 0; i < BENCH_CHKSUM_ITERATIONS; i++ ) {
+    sum += inet_chksum( chksum_buffer, sizeof( chksum_buffer ) );
+  }
+  ns = rtems_clock_get_uptime_nanoseconds() - start;
+  rtems_test_assert( sum != 0 );
+
+  report(
+    "inet_chksum",
+    ns,
+    (double) BENCH_CHKSUM_ITERATIONS * sizeof( chksum_buffer ) * 1000.0 / ns,
+    "MB/s"
+  );
+}
+
+static void bench_pbuf( void )
+{
+  uint64_t start;
+  uint64_t ns;
+  int i;
+
+  start = rtems_clock_get_uptime_nanoseconds();
+  for ( i = 0; i < BENCH_PBUF_ITERATIONS; i++ ) {
+    struct pbuf *p = pbuf_alloc( PBUF_RAW, PBUF_POOL_BUFSIZE, PBUF_POOL );
+
+    rtems_test_assert( p != NULL );
+    pbuf_free( p );
+  }
+  ns = rtems_clock_get_uptime_nanoseconds() - start;
+
+  report(
+    "pbuf_pool",
+    ns,
+    (double) BENCH_PBUF_ITERATIONS * 1000000000.0 / ns,
+    "ops/s"
+  );
+}
+
+/* Mostly small control blocks and packet sized buffers, some jumbo frames */
+static mem_size_t mem_random_size( uint32_t r )
+{
+  uint32_t kind = r % 100;
+
+  r /= 100;
+  if ( kind < 70 ) {
+    return 64 + r % 192;
+  }
+  if ( kind < 95 ) {
+    return 256 + r % 1344;
+  }
+  return 1600 + r % 7400;
+}
+
+static int compare_u32( const void *a, const void *b )
+{
+  uint32_t x = *(const uint32_t *) a;
+  uint32_t y = *(const uint32_t *) b;
+
+  return ( x > y ) - ( x < y );
+}
+
+/*
+ * Random frees and allocations over a set of slots fragment the heap the way
+ * long running traffic does. Only the allocations are timed and the mean,
+ * 99th percentile and worst case are reported for the configured mem_malloc
+ * backend so that builds with and without MEM_TLSF can be compared.
+ */
+static void bench_mem_malloc( void )
+{
+  uint32_t seed = 1;
+  uint32_t count = 0;
+  uint64_t total = 0;
+  uint64_t ns;
+  int i;
+
+  for ( i = 0; i < BENCH_MEM_OPERATIONS; i++ ) {
+    uint32_t slot;
+    uint64_t start;
+
+    seed = seed * 1103515245 + 12345;
+    slot = ( seed >> 8 ) % BENCH_MEM_SLOTS;
+    if ( mem_slots[ slot ] != NULL ) {
+      mem_free( mem_slots[ slot ] );
+      mem_slots[ slot ] = NULL;
+      continue;
+    }
+
+    seed = seed * 1103515245 + 12345;
+    start = rtems_clock_get_uptime_nanoseconds();
+    mem_slots[ slot ] = mem_malloc( mem_random_size( seed >> 8 ) );
+    ns = rtems_clock_get_uptime_nanoseconds() - start;
+    mem_samples[ count++ ] = (uint32_t) ns;
+    total += ns;
+  }
+
+  for ( i = 0; i < BENCH_MEM_SLOTS; i++ ) {
+    mem_free( mem_slots[ i ] );
+    mem_slots[ i ] = NULL;
+  }
+
+  qsort( mem_samples, count, sizeof( mem_samples[ 0 ] ), compare_u32 );
+  report( "mem_malloc_" BENCH_MEM_BACKEND "_mean", total,
+    (double) total / count, "ns" );
+  report( "mem_malloc_" BENCH_MEM_BACKEND "_p99", total,
+    mem_samples[ (uint64_t) ( count - 1 ) * 99 / 100 ], "ns" );
+  report( "mem_malloc_" BENCH_MEM_BACKEND "_max", total,
+    mem_samples[ count - 1 ], "ns" );
+}
+
+static void tcp_sink( void *arg )
+{
+  static uint8_t sink[ BENCH_TCP_CHUNK ];
+  int listener = *(int *) arg;
+  int fd;
+  ssize_t n;
+
+  fd = accept( listener, NULL, NULL );
+  rtems_test_assert( fd >= 0 );
+
+  while ( ( n = recv( fd, sink, sizeof( sink ), 0 ) ) > 0 ) {
+    tcp_received += n;
+  }
+
+  close( fd );
+  sys_sem_signal( &tcp_done );
+  rtems_task_exit();
+}
+
+static void bench_tcp_loopback( void )
+{
+  struct sockaddr_in addr;
+  uint64_t start;
+  uint64_t ns;
+  uint64_t sent = 0;
+  int listener;
+  int fd;
+  int rv;
+
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sin_len = sizeof( addr );
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons( BENCH_TCP_PORT );
+  addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+
+  listener = socket( AF_INET, SOCK_STREAM, 0 );
+  rtems_test_assert( listener >= 0 );
+  rv = bind( listener, (struct sockaddr *) &addr, sizeof( addr ) );
+  rtems_test_assert( rv == 0 );
+  rv = listen( listener, 1 );
+  rtems_test_assert( rv == 0 );
+
+  rv = sys_sem_new( &tcp_done, 0 );
+  rtems_test_assert( rv == ERR_OK );
+  sys_thread_new(
+    "tcp_sink",
+    tcp_sink,
+    &listener,
+    RTEMS_MINIMUM_STACK_SIZE * 4,
+    DEFAULT_THREAD_PRIO
+  );
+
+  fd = socket( AF_INET, SOCK_STREAM, 0 );
+  rtems_test_assert( fd >= 0 );
+  rv = connect( fd, (struct sockaddr *) &addr, sizeof( addr ) );
+  rtems_test_assert( rv == 0 );
+
+  start = rtems_clock_get_uptime_nanoseconds();
+  while ( sent < BENCH_TCP_BYTES ) {
+    ssize_t n = send( fd, tcp_buffer, sizeof( tcp_buffer ), 0 );
+
+    rtems_test_assert( n > 0 );
+    sent += n;
+  }
+  close( fd );
+  sys_arch_sem_wait( &tcp_done, 0 );
+  ns = rtems_clock_get_uptime_nanoseconds() - start;
+  rtems_test_assert( tcp_received == sent );
+
+  close( listener );
+  sys_sem_free( &tcp_done );
+
+  report( "tcp_loopback", ns, (double) sent * 8000.0 / ns, "Mbit/s" );
+}
+
+static rtems_task Init( rtems_task_argument argument )
+{
+  rtems_status_code sc;
+
+  TEST_BEGIN();
+
+  sc = start_networking_shared();
+  rtems_test_assert( sc == RTEMS_SUCCESSFUL );
+
+  bench_chksum();
+  bench_pbuf();
+  bench_mem_malloc();
+  bench_tcp_loopback();
+
+  TEST_END();
+  rtems_test_exit( 0 );
+}
+
+#define CONFIGURE_INIT
+
+#define CONFIGURE_MICROSECONDS_PER_TICK 1000
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_FILE_DESCRIPTORS 32
+
+#define CONFIGURE_MAXIMUM_TASKS 12
+
+#define CONFIGURE_MAXIMUM_POSIX_KEYS 1
+#define CONFIGURE_MAXIMUM_SEMAPHORES 20
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 10
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#include <rtems/confdefs.h>
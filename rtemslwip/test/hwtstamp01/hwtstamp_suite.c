@@ -0,0 +1,491 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * The request slots are checked through netif_hwtstamp.h with socket numbers
+ * no real socket has, the socket options and control messages through the
+ * socket API with datagrams sent from the a side to the b side.
+ */
+
+#include <lwip/sockets.h>
+#include <lwip/sys.h>
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <netif_hwtstamp.h>
+
+#include "hwtstamp_suite.h"
+
+#if LWIP_HWTSTAMP
+
+#define HWTSTAMP_PORT 5301
+#define HWTSTAMP_FAKE_SOCKET 1000
+#define HWTSTAMP_WAIT_MS 1000
+#define HWTSTAMP_FLAGS ( SOF_TIMESTAMPING_TX_HARDWARE | \
+  SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE )
+
+#define HWTSTAMP_CHECK( cond ) hwtstamp_check( ( cond ), #cond, __LINE__ )
+
+static struct vnetif *hwtstamp_a;
+static struct vnetif *hwtstamp_b;
+static int hwtstamp_failures;
+
+static bool hwtstamp_check( bool ok, const char *what, int line )
+{
+  if ( !ok ) {
+    printf( "hwtstamp01: line %d: %s failed\n", line, what );
+    hwtstamp_failures++;
+  }
+  return ok;
+}
+
+static void hwtstamp_addr(
+  struct sockaddr_in *addr,
+  const struct vnetif *vif,
+  u16_t               port
+)
+{
+  memset( addr, 0, sizeof( *addr ) );
+  addr->sin_len = sizeof( *addr );
+  addr->sin_family = AF_INET;
+  addr->sin_port = lwip_htons( port );
+  addr->sin_addr.s_addr = ip4_addr_get_u32( netif_ip4_addr( &vif->netif ) );
+}
+
+/* Binds to vif so that the route hook picks the emulated link */
+static int hwtstamp_socket( int type, const struct vnetif *vif, u16_t port )
+{
+  struct sockaddr_in addr;
+  int fd;
+
+  fd = socket( AF_INET, type, 0 );
+  if ( fd < 0 ) {
+    return -1;
+  }
+  hwtstamp_addr( &addr, vif, port );
+  if ( bind( fd, (struct sockaddr *) &addr, sizeof( addr ) ) != 0 ) {
+    close( fd );
+    return -1;
+  }
+  return fd;
+}
+
+static bool hwtstamp_send( int fd, char c )
+{
+  struct sockaddr_in to;
+
+  hwtstamp_addr( &to, hwtstamp_b, HWTSTAMP_PORT );
+  return sendto( fd, &c, 1, 0, (struct sockaddr *) &to, sizeof( to ) ) == 1;
+}
+
+/* Frames reach the receiver from the vnetif thread, so poll for a while */
+static ssize_t hwtstamp_recvmsg( int fd, struct msghdr *msg )
+{
+  ssize_t n;
+  int i;
+
+  for ( i = 0; i < HWTSTAMP_WAIT_MS; i++ ) {
+    n = recvmsg( fd, msg, MSG_DONTWAIT );
+    if ( n >= 0 || errno != EAGAIN ) {
+      return n;
+    }
+    sys_msleep( 1 );
+  }
+  return -1;
+}
+
+/* Receives count datagrams of one byte without control messages */
+static void hwtstamp_drain( int rx, int count )
+{
+  struct msghdr msg;
+  struct iovec iov;
+  char c;
+
+  iov.iov_base = &c;
+  iov.iov_len = sizeof( c );
+  while ( count-- > 0 ) {
+    memset( &msg, 0, sizeof( msg ) );
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    HWTSTAMP_CHECK( hwtstamp_recvmsg( rx, &msg ) == 1 );
+  }
+}
+
+static bool hwtstamp_ts_within(
+  const struct timespec *ts,
+  u64_t                  before_us,
+  u64_t                  after_us
+)
+{
+  u64_t us = (u64_t) ts->tv_sec * 1000000 + (u64_t) ts->tv_nsec / 1000;
+
+  return ts->tv_nsec >= 0 && ts->tv_nsec < 1000000000 &&
+    us >= before_us && us <= after_us;
+}
+
+/* Request ids are 16 bits wide and skip 0, which marks a free slot */
+static void hwtstamp_slot_wrap( void )
+{
+  struct timespec ts;
+  u16_t prev = 0;
+  u16_t id;
+  bool wrapped = false;
+  bool zero = false;
+  long i;
+
+  for ( i = 0; i <= 0x10000; i++ ) {
+    id = netif_hwtstamp_tx_request( HWTSTAMP_FAKE_SOCKET );
+    zero |= id == 0;
+    wrapped |= id < prev;
+    prev = id;
+  }
+  HWTSTAMP_CHECK( !zero );
+  HWTSTAMP_CHECK( wrapped );
+
+  netif_hwtstamp_tx_done( 0, 1, 1 );
+  HWTSTAMP_CHECK( !netif_hwtstamp_tx_take( HWTSTAMP_FAKE_SOCKET, &ts ) );
+
+  netif_hwtstamp_tx_done( id, 7, 8 );
+  if ( HWTSTAMP_CHECK( netif_hwtstamp_tx_take( HWTSTAMP_FAKE_SOCKET, &ts ) ) ) {
+    HWTSTAMP_CHECK( ts.tv_sec == 7 && ts.tv_nsec == 8 );
+  }
+  HWTSTAMP_CHECK( !netif_hwtstamp_tx_take( HWTSTAMP_FAKE_SOCKET, &ts ) );
+  netif_hwtstamp_tx_release( HWTSTAMP_FAKE_SOCKET );
+}
+
+/*
+ * One request more than there are slots replaces the oldest, whose completion
+ * is then ignored. The others are taken oldest first.
+ */
+static void hwtstamp_slot_replacement( void )
+{
+  u16_t ids[ LWIP_HWTSTAMP_TX_SLOTS + 1 ];
+  struct timespec ts;
+  int i;
+
+  for ( i = 0; i <= LWIP_HWTSTAMP_TX_SLOTS; i++ ) {
+    ids[ i ] = netif_hwtstamp_tx_request( HWTSTAMP_FAKE_SOCKET );
+  }
+  for ( i = 0; i <= LWIP_HWTSTAMP_TX_SLOTS; i++ ) {
+    netif_hwtstamp_tx_done( ids[ i ], (u32_t) i, 0 );
+  }
+  for ( i = 1; i <= LWIP_HWTSTAMP_TX_SLOTS; i++ ) {
+    if ( !HWTSTAMP_CHECK( netif_hwtstamp_tx_take( HWTSTAMP_FAKE_SOCKET,
+           &ts ) ) ) {
+      break;
+    }
+    HWTSTAMP_CHECK( ts.tv_sec == i );
+  }
+  HWTSTAMP_CHECK( !netif_hwtstamp_tx_take( HWTSTAMP_FAKE_SOCKET, &ts ) );
+
+  /* Completed stamps of another socket are not handed out */
+  ids[ 0 ] = netif_hwtstamp_tx_request( HWTSTAMP_FAKE_SOCKET + 1 );
+  netif_hwtstamp_tx_done( ids[ 0 ], 1, 0 );
+  HWTSTAMP_CHECK( !netif_hwtstamp_tx_take( HWTSTAMP_FAKE_SOCKET, &ts ) );
+  netif_hwtstamp_tx_release( HWTSTAMP_FAKE_SOCKET + 1 );
+  HWTSTAMP_CHECK( !netif_hwtstamp_tx_take( HWTSTAMP_FAKE_SOCKET + 1, &ts ) );
+}
+
+static void hwtstamp_sockopt( void )
+{
+  socklen_t len;
+  int flags;
+  int fd;
+
+  fd = socket( AF_INET, SOCK_DGRAM, 0 );
+  if ( !HWTSTAMP_CHECK( fd >= 0 ) ) {
+    return;
+  }
+
+  len = sizeof( flags );
+  HWTSTAMP_CHECK( getsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    &len ) == 0 && flags == 0 );
+
+  /* SOF_TIMESTAMPING_TX_SOFTWARE of Linux is not supported */
+  flags = 0x2;
+  HWTSTAMP_CHECK( setsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( flags ) ) == -1 && errno == EINVAL );
+  flags = HWTSTAMP_FLAGS;
+  HWTSTAMP_CHECK( setsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( char ) ) == -1 && errno == EINVAL );
+  HWTSTAMP_CHECK( setsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( flags ) ) == 0 );
+
+  flags = 0;
+  len = sizeof( flags );
+  HWTSTAMP_CHECK( getsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    &len ) == 0 && flags == HWTSTAMP_FLAGS );
+  close( fd );
+
+  /* Segments of a TCP stream are not stamped */
+  fd = socket( AF_INET, SOCK_STREAM, 0 );
+  if ( !HWTSTAMP_CHECK( fd >= 0 ) ) {
+    return;
+  }
+  flags = HWTSTAMP_FLAGS;
+  HWTSTAMP_CHECK( setsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( flags ) ) == -1 && errno == ENOPROTOOPT );
+  len = sizeof( flags );
+  HWTSTAMP_CHECK( getsockopt( fd, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    &len ) == -1 && errno == ENOPROTOOPT );
+  close( fd );
+}
+
+static ssize_t hwtstamp_errqueue(
+  int            fd,
+  void          *control,
+  size_t         controllen,
+  struct msghdr *msg
+)
+{
+  static char data;
+  static struct iovec iov = { &data, sizeof( data ) };
+
+  memset( msg, 0, sizeof( *msg ) );
+  msg->msg_iov = &iov;
+  msg->msg_iovlen = 1;
+  msg->msg_control = control;
+  msg->msg_controllen = controllen;
+  return recvmsg( fd, msg, MSG_ERRQUEUE | MSG_DONTWAIT );
+}
+
+/* The stamp of a sent datagram is the only control message and has no data */
+static void hwtstamp_tx( int tx, int rx )
+{
+  union {
+    struct cmsghdr hdr;
+    char           buf[ CMSG_SPACE( sizeof( struct scm_timestamping ) ) ];
+  } control;
+  const struct scm_timestamping *tss;
+  struct cmsghdr *chdr;
+  struct msghdr msg;
+  u64_t before;
+  u64_t after;
+
+  HWTSTAMP_CHECK( hwtstamp_errqueue( tx, &control, sizeof( control ),
+    &msg ) == -1 && errno == EAGAIN );
+
+  before = vnetif_now_us();
+  HWTSTAMP_CHECK( hwtstamp_send( tx, 't' ) );
+  after = vnetif_now_us();
+
+  if ( HWTSTAMP_CHECK( hwtstamp_errqueue( tx, &control, sizeof( control ),
+         &msg ) == 0 ) ) {
+    HWTSTAMP_CHECK( msg.msg_flags == 0 );
+    HWTSTAMP_CHECK( msg.msg_controllen ==
+      CMSG_SPACE( sizeof( struct scm_timestamping ) ) );
+    chdr = CMSG_FIRSTHDR( &msg );
+    if ( HWTSTAMP_CHECK( chdr != NULL ) ) {
+      HWTSTAMP_CHECK( chdr->cmsg_level == SOL_SOCKET );
+      HWTSTAMP_CHECK( chdr->cmsg_type == SCM_TIMESTAMPING );
+      HWTSTAMP_CHECK( chdr->cmsg_len ==
+        CMSG_LEN( sizeof( struct scm_timestamping ) ) );
+      tss = (const struct scm_timestamping *) CMSG_DATA( chdr );
+      HWTSTAMP_CHECK( tss->ts[ 0 ].tv_sec == 0 && tss->ts[ 0 ].tv_nsec == 0 );
+      HWTSTAMP_CHECK( tss->ts[ 1 ].tv_sec == 0 && tss->ts[ 1 ].tv_nsec == 0 );
+      HWTSTAMP_CHECK( hwtstamp_ts_within( &tss->ts[ 2 ], before, after ) );
+    }
+  }
+  HWTSTAMP_CHECK( hwtstamp_errqueue( tx, &control, sizeof( control ),
+    &msg ) == -1 && errno == EAGAIN );
+
+  /* A stamp that does not fit is consumed and reported as truncated */
+  HWTSTAMP_CHECK( hwtstamp_send( tx, 't' ) );
+  HWTSTAMP_CHECK( hwtstamp_errqueue( tx, &control, sizeof( struct cmsghdr ),
+    &msg ) == 0 );
+  HWTSTAMP_CHECK( msg.msg_flags == MSG_CTRUNC && msg.msg_controllen == 0 );
+  HWTSTAMP_CHECK( hwtstamp_errqueue( tx, &control, sizeof( control ),
+    &msg ) == -1 && errno == EAGAIN );
+
+  hwtstamp_drain( rx, 2 );
+}
+
+/* Requests still pending when a socket is closed go with it */
+static void hwtstamp_release_on_close( int rx )
+{
+  struct msghdr msg;
+  struct cmsghdr control;
+  int flags = SOF_TIMESTAMPING_TX_HARDWARE;
+  int tx;
+  int reused;
+
+  tx = hwtstamp_socket( SOCK_DGRAM, hwtstamp_a, 0 );
+  if ( !HWTSTAMP_CHECK( tx >= 0 ) ) {
+    return;
+  }
+  HWTSTAMP_CHECK( setsockopt( tx, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( flags ) ) == 0 );
+  HWTSTAMP_CHECK( hwtstamp_send( tx, 'c' ) );
+  close( tx );
+
+  /* Sockets are allocated lowest first, so this one takes the same number */
+  reused = hwtstamp_socket( SOCK_DGRAM, hwtstamp_a, 0 );
+  if ( !HWTSTAMP_CHECK( reused == tx ) ) {
+    if ( reused >= 0 ) {
+      close( reused );
+    }
+    return;
+  }
+  HWTSTAMP_CHECK( setsockopt( reused, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( flags ) ) == 0 );
+  HWTSTAMP_CHECK( hwtstamp_errqueue( reused, &control, sizeof( control ),
+    &msg ) == -1 && errno == EAGAIN );
+  close( reused );
+
+  hwtstamp_drain( rx, 1 );
+}
+
+/*
+ * The receive stamp follows the packet info, and when only the packet info
+ * fits the message is flagged as truncated.
+ */
+static void hwtstamp_rx( int tx, int rx )
+{
+  union {
+    struct cmsghdr hdr;
+    char           buf[ CMSG_SPACE( sizeof( struct scm_timestamping ) ) +
+                        CMSG_SPACE( sizeof( struct in_pktinfo ) ) ];
+  } control;
+  const struct scm_timestamping *tss;
+  struct cmsghdr *chdr;
+  struct msghdr msg;
+  struct iovec iov;
+  u64_t before;
+  u64_t after;
+  int flags = SOF_TIMESTAMPING_RX_HARDWARE;
+  char c;
+
+  HWTSTAMP_CHECK( setsockopt( rx, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( flags ) ) == 0 );
+#if LWIP_NETBUF_RECVINFO
+  flags = 1;
+  HWTSTAMP_CHECK( setsockopt( rx, IPPROTO_IP, IP_PKTINFO, &flags,
+    sizeof( flags ) ) == 0 );
+#endif
+
+  iov.iov_base = &c;
+  iov.iov_len = sizeof( c );
+  memset( &msg, 0, sizeof( msg ) );
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = &control;
+  msg.msg_controllen = sizeof( control );
+
+  before = vnetif_now_us();
+  HWTSTAMP_CHECK( hwtstamp_send( tx, 'r' ) );
+  if ( !HWTSTAMP_CHECK( hwtstamp_recvmsg( rx, &msg ) == 1 ) ) {
+    return;
+  }
+  after = vnetif_now_us();
+  HWTSTAMP_CHECK( c == 'r' && msg.msg_flags == 0 );
+
+  chdr = CMSG_FIRSTHDR( &msg );
+#if LWIP_NETBUF_RECVINFO
+  if ( HWTSTAMP_CHECK( chdr != NULL ) ) {
+    HWTSTAMP_CHECK( chdr->cmsg_level == IPPROTO_IP );
+    HWTSTAMP_CHECK( chdr->cmsg_type == IP_PKTINFO );
+    chdr = CMSG_NXTHDR( &msg, chdr );
+  }
+#endif
+  if ( HWTSTAMP_CHECK( chdr != NULL ) ) {
+    HWTSTAMP_CHECK( chdr->cmsg_level == SOL_SOCKET );
+    HWTSTAMP_CHECK( chdr->cmsg_type == SCM_TIMESTAMPING );
+    tss = (const struct scm_timestamping *) CMSG_DATA( chdr );
+    HWTSTAMP_CHECK( hwtstamp_ts_within( &tss->ts[ 2 ], before, after ) );
+    HWTSTAMP_CHECK( CMSG_NXTHDR( &msg, chdr ) == NULL );
+  }
+
+#if LWIP_NETBUF_RECVINFO
+  HWTSTAMP_CHECK( hwtstamp_send( tx, 'r' ) );
+  msg.msg_control = &control;
+  msg.msg_controllen = CMSG_SPACE( sizeof( struct in_pktinfo ) );
+  if ( HWTSTAMP_CHECK( hwtstamp_recvmsg( rx, &msg ) == 1 ) ) {
+    HWTSTAMP_CHECK( msg.msg_flags == MSG_CTRUNC );
+    HWTSTAMP_CHECK( msg.msg_controllen ==
+      CMSG_SPACE( sizeof( struct in_pktinfo ) ) );
+    chdr = CMSG_FIRSTHDR( &msg );
+    HWTSTAMP_CHECK( chdr != NULL && chdr->cmsg_type == IP_PKTINFO );
+  }
+  flags = 0;
+  setsockopt( rx, IPPROTO_IP, IP_PKTINFO, &flags, sizeof( flags ) );
+#endif
+
+  /* Without the flag no stamp is delivered */
+  flags = 0;
+  HWTSTAMP_CHECK( setsockopt( rx, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+    sizeof( flags ) ) == 0 );
+  HWTSTAMP_CHECK( hwtstamp_send( tx, 'r' ) );
+  msg.msg_control = &control;
+  msg.msg_controllen = sizeof( control );
+  if ( HWTSTAMP_CHECK( hwtstamp_recvmsg( rx, &msg ) == 1 ) ) {
+    HWTSTAMP_CHECK( msg.msg_flags == 0 && msg.msg_controllen == 0 );
+  }
+}
+
+int hwtstamp_suite_run( struct vnetif *a, struct vnetif *b )
+{
+  int flags = SOF_TIMESTAMPING_TX_HARDWARE;
+  int tx;
+  int rx;
+
+  hwtstamp_a = a;
+  hwtstamp_b = b;
+  hwtstamp_failures = 0;
+
+  hwtstamp_slot_wrap();
+  hwtstamp_slot_replacement();
+  hwtstamp_sockopt();
+
+  rx = hwtstamp_socket( SOCK_DGRAM, b, HWTSTAMP_PORT );
+  tx = hwtstamp_socket( SOCK_DGRAM, a, 0 );
+  if ( HWTSTAMP_CHECK( rx >= 0 && tx >= 0 ) ) {
+    /* The first datagram waits for ARP in a copy, which is not stamped */
+    HWTSTAMP_CHECK( hwtstamp_send( tx, 'w' ) );
+    hwtstamp_drain( rx, 1 );
+
+    HWTSTAMP_CHECK( setsockopt( tx, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+      sizeof( flags ) ) == 0 );
+    hwtstamp_tx( tx, rx );
+    hwtstamp_release_on_close( rx );
+
+    flags = 0;
+    HWTSTAMP_CHECK( setsockopt( tx, SOL_SOCKET, SO_TIMESTAMPING, &flags,
+      sizeof( flags ) ) == 0 );
+    hwtstamp_rx( tx, rx );
+  }
+  if ( tx >= 0 ) {
+    close( tx );
+  }
+  if ( rx >= 0 ) {
+    close( rx );
+  }
+
+  printf( "hwtstamp01: %d failed\n", hwtstamp_failures );
+  return hwtstamp_failures;
+}
+
+#endif /* LWIP_HWTSTAMP */
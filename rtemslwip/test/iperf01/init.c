@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * iperf2 compatible throughput test. TCP and UDP servers listen on the
+ * standard port so that "iperf -c <target>" and "iperf -c <target> -u" can
+ * be run from a host. When IPERF01_CLIENT_ADDR is defined the target also
+ * runs the TCP and UDP client tests against an "iperf -s" and "iperf -s -u"
+ * on that host.
+ *
+ * lwiperf.c from lwip/src/apps is not part of the imported sources and only
+ * implements TCP on the raw API, so the protocol is implemented here on the
+ * socket API which also exercises the path applications use.
+ */
+
+#include <lwip/dhcp.h>
+#include <lwip/sockets.h>
+#include <lwip/apps/lwiperf.h>
+#include <arch/sys_arch.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <tmacros.h>
+
+#include <netstart.h>
+
+#ifndef IPERF01_DURATION_S
+#define IPERF01_DURATION_S 10
+#endif
+
+#ifndef IPERF01_UDP_RATE_BPS
+#define IPERF01_UDP_RATE_BPS ( 100 * 1000 * 1000 )
+#endif
+
+#ifndef IPERF01_SERVER_TIME_S
+#define IPERF01_SERVER_TIME_S 300
+#endif
+
+#define IPERF_PORT LWIPERF_TCP_PORT_DEFAULT
+#define IPERF_TCP_BUFFER 8192
+#define IPERF_UDP_BUFFER 1470
+#define IPERF_HEADER_VERSION1 0x80000000
+
+const char rtems_test_name[] = "IPERF 1";
+
+struct netif net_interface;
+
+/* Wire format shared with iperf 2.0.x, all fields in network byte order */
+struct iperf_udp_datagram {
+  int32_t id;
+  uint32_t tv_sec;
+  uint32_t tv_usec;
+};
+
+struct iperf_client_hdr {
+  int32_t flags;
+  int32_t num_threads;
+  int32_t port;
+  int32_t buffer_len;
+  int32_t win_band;
+  int32_t amount;
+};
+
+struct iperf_server_hdr {
+  int32_t flags;
+  int32_t total_len1;
+  int32_t total_len2;
+  int32_t stop_sec;
+  int32_t stop_usec;
+  int32_t error_cnt;
+  int32_t outorder_cnt;
+  int32_t datagrams;
+  int32_t jitter1;
+  int32_t jitter2;
+};
+
+static uint8_t tcp_server_buffer[ IPERF_TCP_BUFFER ];
+static uint8_t udp_server_buffer[ IPERF_UDP_BUFFER ];
+
+static uint64_t now_us( void )
+{
+  return rtems_clock_get_uptime_nanoseconds() / 1000;
+}
+
+static void report(
+  const char *proto,
+  const char *role,
+  uint64_t bytes,
+  uint64_t us,
+  uint32_t datagrams,
+  uint32_t lost,
+  uint32_t out_of_order,
+  uint32_t jitter_us
+)
+{
+  printf(
+    "IPERF proto=%s role=%s bytes=%" PRIu64 " us=%" PRIu64
+    " kbps=%" PRIu64 " datagrams=%" PRIu32 " lost=%" PRIu32
+    " ooo=%" PRIu32 " jitter_us=%" PRIu32 "\n",
+    proto,
+    role,
+    bytes,
+    us,
+    us != 0 ? bytes * 8 * 1000 / us : 0,
+    datagrams,
+    lost,
+    out_of_order,
+    jitter_us
+  );
+}
+
+static void fill_addr( struct sockaddr_in *addr, uint32_t ip, uint16_t port )
+{
+  memset( addr, 0, sizeof( *addr ) );
+  addr->sin_len = sizeof( *addr );
+  addr->sin_family = AF_INET;
+  addr->sin_port = htons( port );
+  addr->sin_addr.s_addr = ip;
+}
+
+static void tcp_server_thread( void *arg )
+{
+  struct sockaddr_in addr;
+  int listener;
+  int rv;
+
+  fill_addr( &addr, htonl( INADDR_ANY ), IPERF_PORT );
+  listener = socket( AF_INET, SOCK_STREAM, 0 );
+  rtems_test_assert( listener >= 0 );
+  rv = bind( listener, (struct sockaddr *) &addr, sizeof( addr ) );
+  rtems_test_assert( rv == 0 );
+  rv = listen( listener, 1 );
+  rtems_test_assert( rv == 0 );
+
+  while ( true ) {
+    uint64_t bytes = 0;
+    uint64_t start;
+    ssize_t n;
+    int fd;
+
+    fd = accept( listener, NULL, NULL );
+    if ( fd < 0 ) {
+      continue;
+    }
+
+    start = now_us();
+    while ( ( n = recv( fd, tcp_server_buffer, sizeof( tcp_server_buffer ), 0 ) ) > 0 ) {
+      bytes += n;
+    }
+    report( "tcp", "server", bytes, now_us() - start, 0, 0, 0, 0 );
+    close( fd );
+  }
+}
+
+static void udp_server_thread( void *arg )
+{
+  struct sockaddr_in addr;
+  int fd;
+  int rv;
+
+  fill_addr( &addr, htonl( INADDR_ANY ), IPERF_PORT );
+  fd = socket( AF_INET, SOCK_DGRAM, 0 );
+  rtems_test_assert( fd >= 0 );
+  rv = bind( fd, (struct sockaddr *) &addr, sizeof( addr ) );
+  rtems_test_assert( rv == 0 );
+
+  while ( true ) {
+    struct iperf_udp_datagram *dgram =
+      (struct iperf_udp_datagram *) udp_server_buffer;
+    struct iperf_server_hdr *hdr =
+      (struct iperf_server_hdr *) ( udp_server_buffer + sizeof( *dgram ) );
+    struct sockaddr_in peer;
+    socklen_t peer_len = sizeof( peer );
+    uint64_t bytes = 0;
+    uint64_t start = 0;
+    uint64_t stop;
+    uint32_t datagrams = 0;
+    uint32_t lost = 0;
+    uint32_t out_of_order = 0;
+    int32_t last_id = -1;
+    int64_t last_transit = 0;
+    double jitter = 0;
+    ssize_t n;
+
+    while ( true ) {
+      int64_t transit;
+      int64_t sent_us;
+      int64_t delta;
+      int32_t id;
+
+      n = recvfrom(
+        fd,
+        udp_server_buffer,
+        sizeof( udp_server_buffer ),
+        0,
+        (struct sockaddr *) &peer,
+        &peer_len
+      );
+      if ( n < (ssize_t) sizeof( *dgram ) ) {
+        continue;
+      }
+
+      id = (int32_t) ntohl( dgram->id );
+      if ( datagrams == 0 ) {
+        if ( id < 0 ) {
+          /* Retransmitted FIN of a session that was already reported */
+          continue;
+        }
+        start = now_us();
+      }
+      stop = now_us();
+      if ( id < 0 ) {
+        break;
+      }
+
+      datagrams++;
+      bytes += n;
+
+      /* RFC 1889 interarrival jitter, as computed by iperf */
+      sent_us = (int64_t) ntohl( dgram->tv_sec ) * 1000000 +
+        ntohl( dgram->tv_usec );
+      transit = (int64_t) stop - sent_us;
+      if ( datagrams > 1 ) {
+        delta = transit - last_transit;
+        if ( delta < 0 ) {
+          delta = -delta;
+        }
+        jitter += ( delta - jitter ) / 16.0;
+      }
+      last_transit = transit;
+
+      if ( id > last_id + 1 ) {
+        lost += id - last_id - 1;
+      } else if ( id < last_id + 1 ) {
+        out_of_order++;
+      }
+      if ( id > last_id ) {
+        last_id = id;
+      }
+    }
+
+    /* Acknowledge the client FIN with the server report */
+    memset( hdr, 0, sizeof( *hdr ) );
+    hdr->flags = htonl( IPERF_HEADER_VERSION1 );
+    hdr->total_len1 = htonl( (uint32_t) ( bytes >> 32 ) );
+    hdr->total_len2 = htonl( (uint32_t) bytes );
+    hdr->stop_sec = htonl( (uint32_t) ( ( stop - start ) / 1000000 ) );
+    hdr->stop_usec = htonl( (uint32_t) ( ( stop - start ) % 1000000 ) );
+    hdr->error_cnt = htonl( lost );
+    hdr->outorder_cnt = htonl( out_of_order );
+    hdr->datagrams = htonl( last_id + 1 );
+    hdr->jitter1 = htonl( (uint32_t) ( jitter / 1000000 ) );
+    hdr->jitter2 = htonl( (uint32_t) jitter % 1000000 );
+    sendto(
+      fd,
+      udp_server_buffer,
+      sizeof( *dgram ) + sizeof( *hdr ),
+      0,
+      (struct sockaddr *) &peer,
+      peer_len
+    );
+
+    report(
+      "udp",
+      "server",
+      bytes,
+      stop - start,
+      datagrams,
+      lost,
+      out_of_order,
+      (uint32_t) jitter
+    );
+  }
+}
+
+#ifdef IPERF01_CLIENT_ADDR
+static uint8_t tcp_client_buffer[ IPERF_TCP_BUFFER ];
+static uint8_t udp_client_buffer[ IPERF_UDP_BUFFER ];
+
+static void tcp_client( uint32_t server )
+{
+  struct iperf_client_hdr *hdr = (struct iperf_client_hdr *) tcp_client_buffer;
+  struct sockaddr_in addr;
+  uint64_t bytes = 0;
+  uint64_t start;
+  uint64_t end;
+  int fd;
+  int rv;
+
+  memset( tcp_client_buffer, 0, sizeof( tcp_client_buffer ) );
+  hdr->num_threads = htonl( 1 );
+  hdr->port = htonl( IPERF_PORT );
+  hdr->buffer_len = htonl( sizeof( tcp_client_buffer ) );
+  hdr->amount = htonl( -( IPERF01_DURATION_S * 100 ) );
+
+  fill_addr( &addr, server, IPERF_PORT );
+  fd = socket( AF_INET, SOCK_STREAM, 0 );
+  rtems_test_assert( fd >= 0 );
+  rv = connect( fd, (struct sockaddr *) &addr, sizeof( addr ) );
+  if ( rv != 0 ) {
+    printf( "iperf01: TCP connect failed: %d\n", errno );
+    close( fd );
+    return;
+  }
+
+  start = now_us();
+  end = start + (uint64_t) IPERF01_DURATION_S * 1000000;
+  while ( now_us() < end ) {
+    ssize_t n = send( fd, tcp_client_buffer, sizeof( tcp_client_buffer ), 0 );
+
+    if ( n <= 0 ) {
+      break;
+    }
+    bytes += n;
+  }
+  close( fd );
+
+  report( "tcp", "client", bytes, now_us() - start, 0, 0, 0, 0 );
+}
+
+static void udp_client( uint32_t server )
+{
+  struct iperf_udp_datagram *dgram =
+    (struct iperf_udp_datagram *) udp_client_buffer;
+  const uint64_t interval_us = (uint64_t) sizeof( udp_client_buffer ) * 8 *
+    1000000 / IPERF01_UDP_RATE_BPS;
+  struct sockaddr_in addr;
+  struct timeval timeout = { 0, 250000 };
+  uint64_t bytes = 0;
+  uint64_t start;
+  uint64_t next;
+  uint64_t end;
+  int32_t id = 0;
+  int tries;
+  int fd;
+
+  memset( udp_client_buffer, 0, sizeof( udp_client_buffer ) );
+  fill_addr( &addr, server, IPERF_PORT );
+  fd = socket( AF_INET, SOCK_DGRAM, 0 );
+  rtems_test_assert( fd >= 0 );
+  setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof( timeout ) );
+
+  start = now_us();
+  next = start;
+  end = start + (uint64_t) IPERF01_DURATION_S * 1000000;
+  while ( true ) {
+    uint64_t t = now_us();
+
+    if ( t >= end ) {
+      break;
+    }
+    if ( t < next ) {
+      /*
+       * Sleep rather than spin so lower priority tasks keep running. The
+       * sleep lasts at least a clock tick, so datagrams due within a tick
+       * are then sent back to back to keep up the average rate.
+       */
+      rtems_interval ticks =
+        RTEMS_MICROSECONDS_TO_TICKS( (uint32_t) ( next - t ) );
+
+      rtems_task_wake_after( ticks > 0 ? ticks : 1 );
+      continue;
+    }
+
+    dgram->id = htonl( id++ );
+    dgram->tv_sec = htonl( (uint32_t) ( t / 1000000 ) );
+    dgram->tv_usec = htonl( (uint32_t) ( t % 1000000 ) );
+    if (
+      sendto(
+        fd,
+        udp_client_buffer,
+        sizeof( udp_client_buffer ),
+        0,
+        (struct sockaddr *) &addr,
+        sizeof( addr )
+      ) > 0
+    ) {
+      bytes += sizeof( udp_client_buffer );
+    }
+    next += interval_us;
+  }
+  report( "udp", "client", bytes, now_us() - start, id, 0, 0, 0 );
+
+  /* Send the FIN until the server answers with its report */
+  dgram->id = htonl( -id );
+  for ( tries = 0; tries < 10; tries++ ) {
+    struct iperf_server_hdr *hdr;
+    ssize_t n;
+
+    sendto(
+      fd,
+      udp_client_buffer,
+      sizeof( udp_client_buffer ),
+      0,
+      (struct sockaddr *) &addr,
+      sizeof( addr )
+    );
+    n = recv( fd, udp_client_buffer, sizeof( udp_client_buffer ), 0 );
+    if ( n < (ssize_t) ( sizeof( *dgram ) + sizeof( *hdr ) ) ) {
+      continue;
+    }
+
+    hdr = (struct iperf_server_hdr *) ( udp_client_buffer + sizeof( *dgram ) );
+    report(
+      "udp",
+      "remote",
+      ( (uint64_t) ntohl( hdr->total_len1 ) << 32 ) | ntohl( hdr->total_len2 ),
+      (uint64_t) ntohl( hdr->stop_sec ) * 1000000 + ntohl( hdr->stop_usec ),
+      ntohl( hdr->datagrams ),
+      ntohl( hdr->error_cnt ),
+      ntohl( hdr->outorder_cnt ),
+      ntohl( hdr->jitter1 ) * 1000000 + ntohl( hdr->jitter2 )
+    );
+    break;
+  }
+  close( fd );
+}
+#endif
+
+static rtems_task Init( rtems_task_argument argument )
+{
+  int ret;
+
+  TEST_BEGIN();
+
+  ip_addr_t ipaddr, netmask, gw;
+
+  IP_ADDR4( &ipaddr, 10, 0, 2, 14 );
+  IP_ADDR4( &netmask, 255, 255, 255, 0 );
+  IP_ADDR4( &gw, 10, 0, 2, 3 );
+  unsigned char mac_ethernet_address[] = { 0x00, 0x0a, 0x35, 0x00, 0x22, 0x01 };
+
+  ret = start_networking(
+    &net_interface,
+    &ipaddr,
+    &netmask,
+    &gw,
+    mac_ethernet_address
+  );
+
+  if ( ret != 0 ) {
+    return;
+  }
+
+  dhcp_start( &net_interface );
+
+  sys_thread_new(
+    "iperf_tcp",
+    tcp_server_thread,
+    NULL,
+    RTEMS_MINIMUM_STACK_SIZE * 4,
+    DEFAULT_THREAD_PRIO
+  );
+  sys_thread_new(
+    "iperf_udp",
+    udp_server_thread,
+    NULL,
+    RTEMS_MINIMUM_STACK_SIZE * 4,
+    DEFAULT_THREAD_PRIO
+  );
+
+#ifdef IPERF01_CLIENT_ADDR
+  tcp_client( inet_addr( IPERF01_CLIENT_ADDR ) );
+  udp_client( inet_addr( IPERF01_CLIENT_ADDR ) );
+#endif
+
+  sys_arch_delay( IPERF01_SERVER_TIME_S * 1000 );
+
+  TEST_END();
+  rtems_test_exit( 0 );
+}
+
+#define CONFIGURE_INIT
+
+#define CONFIGURE_MICROSECONDS_PER_TICK 1000
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_FILE_DESCRIPTORS 32
+
+#define CONFIGURE_MAXIMUM_TASKS 12
+
+#define CONFIGURE_MAXIMUM_POSIX_KEYS 1
+#define CONFIGURE_MAXIMUM_SEMAPHORES 20
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 10
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Brings up each GEM set in MULTIGEM01_GEMS with start_networking_ports() as
+ * an interface of its own, with its own MAC address and a 10.0.<2 + GEM>.14/24
+ * address, then checks each interface sends a UDP broadcast through its own
+ * GEM. The counters of every GEM are printed at the end.
+ */
+
+#include <lwip/netif.h>
+#include <lwip/tcpip.h>
+#include <lwip/udp.h>
+
+#include <string.h>
+
+#include <tmacros.h>
+
+#include <netstart.h>
+
+#ifdef LWIP_BSP_XILINX_ZYNQMP
+#include <netif/xadapter.h>
+#include <netif/xemacpsif.h>
+#endif
+
+#ifndef MULTIGEM01_GEMS
+#define MULTIGEM01_GEMS 0xf
+#endif
+
+#define MULTIGEM01_PORT 5003
+
+const char rtems_test_name[] = "MULTIGEM 1";
+
+#ifdef LWIP_BSP_XILINX_ZYNQMP
+static struct netstart_port ports[ 4 ];
+
+static u32_t gem_tx_frames( struct netif *netif )
+{
+  struct xemac_s *xemac = (struct xemac_s *) netif->state;
+  xemacpsif_s *xemacpsif = (xemacpsif_s *) xemac->state;
+
+  return xemacpsif->stats.tx_frames;
+}
+
+static void send_broadcast( struct netif *netif )
+{
+  struct udp_pcb *pcb;
+  struct pbuf *p;
+  err_t err;
+
+  LOCK_TCPIP_CORE();
+  pcb = udp_new();
+  rtems_test_assert( pcb != NULL );
+  ip_set_option( pcb, SOF_BROADCAST );
+  p = pbuf_alloc( PBUF_TRANSPORT, 32, PBUF_RAM );
+  rtems_test_assert( p != NULL );
+  memset( p->payload, netif->num, p->len );
+  err = udp_sendto_if(
+    pcb,
+    p,
+    IP_ADDR_BROADCAST,
+    MULTIGEM01_PORT,
+    netif
+  );
+  pbuf_free( p );
+  udp_remove( pcb );
+  UNLOCK_TCPIP_CORE();
+
+  rtems_test_assert( err == ERR_OK );
+}
+
+static void test_ports( void )
+{
+  size_t count = 0;
+  size_t i;
+  size_t j;
+  unsigned int gem;
+  int ret;
+
+  for ( gem = 0; gem < RTEMS_ARRAY_SIZE( ports ); gem++ ) {
+    struct netstart_port *port;
+
+    if ( ( MULTIGEM01_GEMS & ( 1U << gem ) ) == 0 ) {
+      continue;
+    }
+
+    port = &ports[ count++ ];
+    port->port = gem;
+    IP_ADDR4( &port->ipaddr, 10, 0, 2 + gem, 14 );
+    IP_ADDR4( &port->netmask, 255, 255, 255, 0 );
+    IP_ADDR4( &port->gateway, 10, 0, 2 + gem, 3 );
+    port->mac_ethernet_address[ 0 ] = 0x00;
+    port->mac_ethernet_address[ 1 ] = 0x0a;
+    port->mac_ethernet_address[ 2 ] = 0x35;
+    port->mac_ethernet_address[ 3 ] = 0x00;
+    port->mac_ethernet_address[ 4 ] = 0x22;
+    port->mac_ethernet_address[ 5 ] = 0x01 + gem;
+  }
+
+  rtems_test_assert( count > 0 );
+
+  ret = start_networking_ports( ports, count );
+  rtems_test_assert( ret == 0 );
+  rtems_test_assert( netif_default == &ports[ 0 ].net_interface );
+
+  for ( i = 0; i < count; i++ ) {
+    struct netif *netif = &ports[ i ].net_interface;
+    u32_t tx_frames;
+    int tries;
+
+    rtems_test_assert( netif_is_up( netif ) );
+    rtems_test_assert( netif->hwaddr_len == ETH_HWADDR_LEN );
+    rtems_test_assert(
+      memcmp(
+        netif->hwaddr,
+        ports[ i ].mac_ethernet_address,
+        ETH_HWADDR_LEN
+      ) == 0
+    );
+    rtems_test_assert(
+      ip4_addr_cmp( netif_ip4_addr( netif ), ip_2_ip4( &ports[ i ].ipaddr ) )
+    );
+
+    for ( j = 0; j < i; j++ ) {
+      rtems_test_assert( netif->num != ports[ j ].net_interface.num );
+    }
+
+    /* The broadcast has to leave through this GEM and no other */
+    tx_frames = gem_tx_frames( netif );
+    send_broadcast( netif );
+    for ( tries = 0; tries < 100; tries++ ) {
+      if ( gem_tx_frames( netif ) != tx_frames ) {
+        break;
+      }
+      rtems_task_wake_after( RTEMS_MILLISECONDS_TO_TICKS( 10 ) );
+    }
+    rtems_test_assert( gem_tx_frames( netif ) != tx_frames );
+
+    printf(
+      "multigem01: GEM %u is %c%c%u\n",
+      ports[ i ].port,
+      netif->name[ 0 ],
+      netif->name[ 1 ],
+      (unsigned) netif->num
+    );
+  }
+
+  for ( i = 0; i < count; i++ ) {
+    xemacpsif_stats_display( &ports[ i ].net_interface );
+  }
+}
+#endif
+
+static rtems_task Init( rtems_task_argument argument )
+{
+  TEST_BEGIN();
+
+#ifdef LWIP_BSP_XILINX_ZYNQMP
+  test_ports();
+#else
+  printf( "multigem01: not a ZynqMP BSP, nothing to run\n" );
+#endif
+
+  TEST_END();
+  rtems_test_exit( 0 );
+}
+
+#define CONFIGURE_INIT
+
+#define CONFIGURE_MICROSECONDS_PER_TICK 1000
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_FILE_DESCRIPTORS 32
+
+#define CONFIGURE_MAXIMUM_TASKS 20
+
+#define CONFIGURE_MAXIMUM_POSIX_KEYS 1
+#define CONFIGURE_MAXIMUM_SEMAPHORES 40
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 20
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#include <rtems/confdefs.h>
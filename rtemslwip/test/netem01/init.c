@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Runs the network emulation suite over a pair of virtual interfaces, which
+ * needs no network hardware so that it also runs on the QEMU BSPs. The
+ * library must be configured with LWIP_VNETIF=1 in config.ini for the
+ * interfaces to be available.
+ */
+
+#include <lwip/tcpip.h>
+
+#include <tmacros.h>
+
+#include <netstart.h>
+
+#include "netem_suite.h"
+
+const char rtems_test_name[] = "NETEM 1";
+
+#if LWIP_VNETIF
+static struct vnetif vnet_a;
+static struct vnetif vnet_b;
+#endif
+
+static rtems_task Init( rtems_task_argument argument )
+{
+  rtems_status_code sc;
+
+  TEST_BEGIN();
+
+  sc = start_networking_shared();
+  rtems_test_assert( sc == RTEMS_SUCCESSFUL );
+
+#if LWIP_VNETIF
+  {
+    ip4_addr_t addr_a;
+    ip4_addr_t addr_b;
+    ip4_addr_t netmask;
+    err_t err;
+    int run;
+
+    IP4_ADDR( &addr_a, 192, 168, 100, 1 );
+    IP4_ADDR( &addr_b, 192, 168, 100, 2 );
+    IP4_ADDR( &netmask, 255, 255, 255, 0 );
+    LOCK_TCPIP_CORE();
+    err = vnetif_pair_add( &vnet_a, &vnet_b, &addr_a, &addr_b, &netmask );
+    UNLOCK_TCPIP_CORE();
+    rtems_test_assert( err == ERR_OK );
+
+    run = netem_suite_run( &vnet_a, &vnet_b, NULL );
+    rtems_test_assert( run > 0 );
+  }
+#else
+  printf( "netem01: LWIP_VNETIF is disabled, nothing to run\n" );
+#endif
+
+  TEST_END();
+  rtems_test_exit( 0 );
+}
+
+#define CONFIGURE_INIT
+
+#define CONFIGURE_MICROSECONDS_PER_TICK 1000
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_FILE_DESCRIPTORS 64
+
+#define CONFIGURE_MAXIMUM_TASKS 16
+
+#define CONFIGURE_MAXIMUM_POSIX_KEYS 1
+#define CONFIGURE_MAXIMUM_SEMAPHORES 40
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 10
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#include <rtems/confdefs.h>
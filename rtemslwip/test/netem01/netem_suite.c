@@ -0,0 +1,635 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Each workload uses its own server thread bound to the address of the b side
+ * while the calling thread drives the client from the a side, so all traffic
+ * crosses the emulated link in both directions. The impairment is applied
+ * symmetrically.
+ */
+
+#include <lwip/sockets.h>
+#include <lwip/sys.h>
+#include <lwip/tcpip.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __rtems__
+#include <rtems.h>
+#endif
+
+#if LWIP_GRO
+#include <netif_gro.h>
+#endif
+
+#include "netem_suite.h"
+
+#define NETEM_PORT 5201
+#define NETEM_BULK_CHUNK 8192
+#define NETEM_RR_SIZE 64
+#define NETEM_RR_SAMPLES 4096
+#define NETEM_UDP_SIZE 1024
+/* Bursts fit the receive mailbox so the link, not the receiver, drops */
+#define NETEM_UDP_BURST 16
+#define NETEM_UDP_GAP_MS 10
+#define NETEM_UDP_END_MARKERS 10
+#define NETEM_CHURN_QUIT 'q'
+
+struct netem_scenario {
+  const char              *name;
+  struct vnetif_impairment impairment;
+};
+
+/* rate_kbps, delay_us, jitter_us, loss_ppm, reorder_ppm */
+static const struct netem_scenario netem_scenarios[] = {
+  { "clean", { 0, 0, 0, 0, 0 } },
+  { "lan", { 1000000, 100, 20, 0, 0 } },
+  { "wan", { 100000, 20000, 2000, 0, 0 } },
+  { "lossy", { 100000, 5000, 500, 10000, 0 } },
+  { "reorder", { 100000, 5000, 500, 0, 20000 } }
+};
+
+struct netem_server {
+  int       listener;
+  sys_sem_t done;
+  u64_t     bytes;
+  u32_t     count;
+};
+
+static struct vnetif *netem_a;
+static struct vnetif *netem_b;
+static const char *netem_scenario;
+static u8_t netem_buffer[ NETEM_BULK_CHUNK ];
+static u8_t netem_server_buffer[ NETEM_BULK_CHUNK ];
+static u32_t netem_samples[ NETEM_RR_SAMPLES ];
+
+static void netem_addr(
+  struct sockaddr_in *addr,
+  struct vnetif      *vif,
+  u16_t               port
+)
+{
+  memset( addr, 0, sizeof( *addr ) );
+  addr->sin_len = sizeof( *addr );
+  addr->sin_family = AF_INET;
+  addr->sin_port = lwip_htons( port );
+  addr->sin_addr.s_addr = ip4_addr_get_u32( netif_ip4_addr( &vif->netif ) );
+}
+
+/* Binds to the a side so that the route hook picks the emulated link */
+static int netem_socket( int type )
+{
+  struct sockaddr_in addr;
+  int fd;
+
+  fd = socket( AF_INET, type, 0 );
+  if ( fd < 0 ) {
+    return -1;
+  }
+  netem_addr( &addr, netem_a, 0 );
+  if ( bind( fd, (struct sockaddr *) &addr, sizeof( addr ) ) != 0 ) {
+    close( fd );
+    return -1;
+  }
+  return fd;
+}
+
+static bool netem_server_open( struct netem_server *server, int type )
+{
+  struct sockaddr_in addr;
+  int one = 1;
+
+  memset( server, 0, sizeof( *server ) );
+  server->listener = socket( AF_INET, type, 0 );
+  if ( server->listener < 0 ) {
+    return false;
+  }
+  /* Connections of the previous workload may still be in TIME_WAIT */
+  setsockopt( server->listener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof( one ) );
+  netem_addr( &addr, netem_b, NETEM_PORT );
+  if ( bind( server->listener, (struct sockaddr *) &addr, sizeof( addr ) ) != 0 ||
+       ( type == SOCK_STREAM && listen( server->listener, 8 ) != 0 ) ||
+       sys_sem_new( &server->done, 0 ) != ERR_OK ) {
+    close( server->listener );
+    return false;
+  }
+  return true;
+}
+
+static void netem_server_close( struct netem_server *server )
+{
+  sys_arch_sem_wait( &server->done, 0 );
+  sys_sem_free( &server->done );
+  close( server->listener );
+}
+
+/* RTEMS tasks must not return from their entry point */
+static void netem_server_exit( struct netem_server *server )
+{
+  sys_sem_signal( &server->done );
+#ifdef __rtems__
+  rtems_task_exit();
+#endif
+}
+
+static bool netem_send_all( int fd, const void *buf, size_t len )
+{
+  const u8_t *p = buf;
+
+  while ( len > 0 ) {
+    ssize_t n = send( fd, p, len, 0 );
+
+    if ( n <= 0 ) {
+      return false;
+    }
+    p += n;
+    len -= (size_t) n;
+  }
+  return true;
+}
+
+static bool netem_recv_all( int fd, void *buf, size_t len )
+{
+  u8_t *p = buf;
+
+  while ( len > 0 ) {
+    ssize_t n = recv( fd, p, len, 0 );
+
+    if ( n <= 0 ) {
+      return false;
+    }
+    p += n;
+    len -= (size_t) n;
+  }
+  return true;
+}
+
+static void netem_bulk_server( void *arg )
+{
+  struct netem_server *server = arg;
+  ssize_t n;
+  int fd;
+
+  fd = accept( server->listener, NULL, NULL );
+  if ( fd >= 0 ) {
+    while ( ( n = recv( fd, netem_server_buffer,
+                        sizeof( netem_server_buffer ), 0 ) ) > 0 ) {
+      server->bytes += (u64_t) n;
+    }
+    close( fd );
+  }
+  netem_server_exit( server );
+}
+
+static void netem_tcp_bulk( void )
+{
+  struct netem_server server;
+  struct sockaddr_in addr;
+  u64_t start;
+  u64_t end;
+  u64_t elapsed;
+  int fd;
+
+  if ( !netem_server_open( &server, SOCK_STREAM ) ) {
+    printf( "netem01: tcp_bulk server setup failed\n" );
+    return;
+  }
+  sys_thread_new( "netem_bulk", netem_bulk_server, &server,
+    NETEM_STACK_SIZE, DEFAULT_THREAD_PRIO );
+
+  fd = netem_socket( SOCK_STREAM );
+  netem_addr( &addr, netem_b, NETEM_PORT );
+  start = vnetif_now_us();
+  end = start + (u64_t) NETEM_DURATION_MS * 1000;
+  if ( fd >= 0 &&
+       connect( fd, (struct sockaddr *) &addr, sizeof( addr ) ) == 0 ) {
+    while ( vnetif_now_us() < end ) {
+      if ( !netem_send_all( fd, netem_buffer, sizeof( netem_buffer ) ) ) {
+        break;
+      }
+    }
+  }
+  if ( fd >= 0 ) {
+    close( fd );
+  }
+  netem_server_close( &server );
+  elapsed = vnetif_now_us() - start;
+
+  printf(
+    "{\"suite\":\"netem01\",\"scenario\":\"%s\",\"test\":\"tcp_bulk\","
+    "\"duration_us\":%" PRIu64 ",\"bytes\":%" PRIu64 ",\"mbit_s\":%.2f}\n",
+    netem_scenario,
+    elapsed,
+    server.bytes,
+    elapsed != 0 ? (double) server.bytes * 8 / elapsed : 0.0
+  );
+}
+
+static void netem_rr_server( void *arg )
+{
+  struct netem_server *server = arg;
+  int one = 1;
+  int fd;
+
+  fd = accept( server->listener, NULL, NULL );
+  if ( fd >= 0 ) {
+    setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+    while ( netem_recv_all( fd, netem_server_buffer, NETEM_RR_SIZE ) &&
+            netem_send_all( fd, netem_server_buffer, NETEM_RR_SIZE ) ) {
+      server->count++;
+    }
+    close( fd );
+  }
+  netem_server_exit( server );
+}
+
+static int netem_compare_u32( const void *a, const void *b )
+{
+  u32_t x = *(const u32_t *) a;
+  u32_t y = *(const u32_t *) b;
+
+  return ( x > y ) - ( x < y );
+}
+
+static u32_t netem_percentile( u32_t count, u32_t per_mille )
+{
+  if ( count == 0 ) {
+    return 0;
+  }
+  return netem_samples[ (u64_t) ( count - 1 ) * per_mille / 1000 ];
+}
+
+static void netem_tcp_rr( void )
+{
+  struct netem_server server;
+  struct sockaddr_in addr;
+  u32_t count = 0;
+  u64_t end;
+  int one = 1;
+  int fd;
+
+  if ( !netem_server_open( &server, SOCK_STREAM ) ) {
+    printf( "netem01: tcp_rr server setup failed\n" );
+    return;
+  }
+  sys_thread_new( "netem_rr", netem_rr_server, &server,
+    NETEM_STACK_SIZE, DEFAULT_THREAD_PRIO );
+
+  fd = netem_socket( SOCK_STREAM );
+  netem_addr( &addr, netem_b, NETEM_PORT );
+  end = vnetif_now_us() + (u64_t) NETEM_DURATION_MS * 1000;
+  if ( fd >= 0 &&
+       connect( fd, (struct sockaddr *) &addr, sizeof( addr ) ) == 0 ) {
+    setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+    while ( count < NETEM_RR_SAMPLES && vnetif_now_us() < end ) {
+      u64_t t = vnetif_now_us();
+
+      if ( !netem_send_all( fd, netem_buffer, NETEM_RR_SIZE ) ||
+           !netem_recv_all( fd, netem_buffer, NETEM_RR_SIZE ) ) {
+        break;
+      }
+      netem_samples[ count++ ] = (u32_t) ( vnetif_now_us() - t );
+    }
+  }
+  if ( fd >= 0 ) {
+    close( fd );
+  }
+  netem_server_close( &server );
+
+  qsort( netem_samples, count, sizeof( netem_samples[ 0 ] ),
+    netem_compare_u32 );
+  printf(
+    "{\"suite\":\"netem01\",\"scenario\":\"%s\",\"test\":\"tcp_rr\","
+    "\"transactions\":%" PRIu32 ",\"p50_us\":%" PRIu32 ",\"p99_us\":%" PRIu32
+    ",\"p999_us\":%" PRIu32 ",\"max_us\":%" PRIu32 "}\n",
+    netem_scenario,
+    count,
+    netem_percentile( count, 500 ),
+    netem_percentile( count, 990 ),
+    netem_percentile( count, 999 ),
+    count != 0 ? netem_samples[ count - 1 ] : 0
+  );
+}
+
+static void netem_udp_server( void *arg )
+{
+  struct netem_server *server = arg;
+  ssize_t n;
+
+  while ( ( n = recv( server->listener, netem_server_buffer,
+                      sizeof( netem_server_buffer ), 0 ) ) > 0 ) {
+    if ( n == 1 ) {
+      break;
+    }
+    server->count++;
+    server->bytes += (u64_t) n;
+  }
+  netem_server_exit( server );
+}
+
+/*
+ * Back to back bursts expose queueing in the stack and at the emulated
+ * bottleneck. There is no receive timeout, so the end of the test is marked
+ * by a few one byte datagrams that are unlikely to all be lost. Datagrams
+ * lost or dropped by the link are told apart from those that reached the
+ * receiving interface and were dropped by the stack, for instance because the
+ * receive mailbox of the socket was full.
+ */
+static void netem_udp_burst( void )
+{
+  struct netem_server server;
+  struct sockaddr_in addr;
+  struct vnetif_stats before;
+  struct vnetif_stats after;
+  u32_t sent = 0;
+  u32_t link_lost;
+  u32_t rx_drops;
+  u64_t end;
+  int fd;
+  int i;
+
+  if ( !netem_server_open( &server, SOCK_DGRAM ) ) {
+    printf( "netem01: udp_burst server setup failed\n" );
+    return;
+  }
+  sys_thread_new( "netem_udp", netem_udp_server, &server,
+    NETEM_STACK_SIZE, DEFAULT_THREAD_PRIO );
+
+  fd = netem_socket( SOCK_DGRAM );
+  netem_addr( &addr, netem_b, NETEM_PORT );
+  vnetif_get_stats( netem_a, &before );
+  end = vnetif_now_us() + (u64_t) NETEM_DURATION_MS * 1000;
+  while ( fd >= 0 && vnetif_now_us() < end ) {
+    for ( i = 0; i < NETEM_UDP_BURST; i++ ) {
+      if ( sendto( fd, netem_buffer, NETEM_UDP_SIZE, 0,
+                   (struct sockaddr *) &addr, sizeof( addr ) ) > 0 ) {
+        sent++;
+      }
+    }
+    sys_msleep( NETEM_UDP_GAP_MS );
+  }
+  /* The link decides the fate of a frame when it is sent */
+  vnetif_get_stats( netem_a, &after );
+  for ( i = 0; fd >= 0 && i < NETEM_UDP_END_MARKERS; i++ ) {
+    sendto( fd, netem_buffer, 1, 0, (struct sockaddr *) &addr,
+      sizeof( addr ) );
+    sys_msleep( NETEM_UDP_GAP_MS );
+  }
+  if ( fd >= 0 ) {
+    close( fd );
+  }
+  netem_server_close( &server );
+
+  link_lost = ( after.tx_lost - before.tx_lost ) +
+    ( after.tx_drops - before.tx_drops );
+  if ( link_lost > sent ) {
+    link_lost = sent;
+  }
+  rx_drops = sent - link_lost > server.count ?
+    sent - link_lost - server.count : 0;
+
+  printf(
+    "{\"suite\":\"netem01\",\"scenario\":\"%s\",\"test\":\"udp_burst\","
+    "\"burst\":%d,\"sent\":%" PRIu32 ",\"received\":%" PRIu32
+    ",\"link_lost\":%" PRIu32 ",\"rx_drops\":%" PRIu32
+    ",\"loss_pct\":%.2f,\"rx_drop_pct\":%.2f}\n",
+    netem_scenario,
+    NETEM_UDP_BURST,
+    sent,
+    server.count,
+    link_lost,
+    rx_drops,
+    sent != 0 ? 100.0 * link_lost / sent : 0.0,
+    sent != 0 ? 100.0 * rx_drops / sent : 0.0
+  );
+}
+
+static void netem_churn_server( void *arg )
+{
+  struct netem_server *server = arg;
+  bool quit = false;
+  u8_t c;
+
+  while ( !quit ) {
+    int fd = accept( server->listener, NULL, NULL );
+
+    if ( fd < 0 ) {
+      break;
+    }
+    if ( recv( fd, &c, 1, 0 ) == 1 && c == NETEM_CHURN_QUIT ) {
+      quit = true;
+    } else {
+      server->count++;
+    }
+    close( fd );
+  }
+  netem_server_exit( server );
+}
+
+/* Full connect and close cycles exercise PCB allocation and TIME_WAIT reuse */
+static void netem_tcp_churn( void )
+{
+  struct netem_server server;
+  struct sockaddr_in addr;
+  u32_t connections = 0;
+  u32_t failures = 0;
+  u64_t start;
+  u64_t end;
+  u64_t elapsed;
+  u8_t c = NETEM_CHURN_QUIT;
+  int fd;
+
+  if ( !netem_server_open( &server, SOCK_STREAM ) ) {
+    printf( "netem01: tcp_churn server setup failed\n" );
+    return;
+  }
+  sys_thread_new( "netem_churn", netem_churn_server, &server,
+    NETEM_STACK_SIZE, DEFAULT_THREAD_PRIO );
+
+  netem_addr( &addr, netem_b, NETEM_PORT );
+  start = vnetif_now_us();
+  end = start + (u64_t) NETEM_DURATION_MS * 1000;
+  while ( vnetif_now_us() < end ) {
+    fd = netem_socket( SOCK_STREAM );
+    if ( fd >= 0 &&
+         connect( fd, (struct sockaddr *) &addr, sizeof( addr ) ) == 0 ) {
+      connections++;
+    } else {
+      failures++;
+    }
+    if ( fd >= 0 ) {
+      close( fd );
+    }
+  }
+  elapsed = vnetif_now_us() - start;
+
+  /* Retry the quit message until one connection gets through */
+  do {
+    fd = netem_socket( SOCK_STREAM );
+    if ( fd < 0 ) {
+      sys_msleep( NETEM_UDP_GAP_MS );
+      continue;
+    }
+    if ( connect( fd, (struct sockaddr *) &addr, sizeof( addr ) ) == 0 &&
+         send( fd, &c, 1, 0 ) == 1 ) {
+      close( fd );
+      break;
+    }
+    close( fd );
+  } while ( true );
+  netem_server_close( &server );
+
+  printf(
+    "{\"suite\":\"netem01\",\"scenario\":\"%s\",\"test\":\"tcp_churn\","
+    "\"duration_us\":%" PRIu64 ",\"connections\":%" PRIu32
+    ",\"failures\":%" PRIu32 ",\"accepted\":%" PRIu32 ",\"conn_s\":%.2f}\n",
+    netem_scenario,
+    elapsed,
+    connections,
+    failures,
+    server.count,
+    elapsed != 0 ? connections * 1000000.0 / elapsed : 0.0
+  );
+}
+
+/* The counters are cumulative, so report the change since base */
+static void netem_report_vnetif(
+  const char                *side,
+  struct vnetif             *vif,
+  const struct vnetif_stats *base
+)
+{
+  struct vnetif_stats stats;
+
+  vnetif_get_stats( vif, &stats );
+  stats.tx_packets -= base->tx_packets;
+  stats.tx_bytes -= base->tx_bytes;
+  stats.tx_drops -= base->tx_drops;
+  stats.tx_lost -= base->tx_lost;
+  stats.tx_reordered -= base->tx_reordered;
+  stats.rx_packets -= base->rx_packets;
+  printf(
+    "{\"suite\":\"netem01\",\"scenario\":\"%s\",\"test\":\"vnetif\","
+    "\"side\":\"%s\",\"tx_packets\":%" PRIu32 ",\"tx_bytes\":%" PRIu32
+    ",\"tx_drops\":%" PRIu32 ",\"tx_lost\":%" PRIu32
+    ",\"tx_reordered\":%" PRIu32 ",\"rx_packets\":%" PRIu32 "}\n",
+    netem_scenario,
+    side,
+    stats.tx_packets,
+    stats.tx_bytes,
+    stats.tx_drops,
+    stats.tx_lost,
+    stats.tx_reordered,
+    stats.rx_packets
+  );
+}
+
+#if LWIP_GRO
+/* Shows whether received bursts were actually coalesced */
+static void netem_report_gro( const struct netif_gro_stats *base )
+{
+  struct netif_gro_stats stats;
+
+  netif_gro_get_stats( &stats );
+  printf(
+    "{\"suite\":\"netem01\",\"scenario\":\"%s\",\"test\":\"gro\","
+    "\"packets\":%" PRIu32 ",\"merged\":%" PRIu32 "}\n",
+    netem_scenario,
+    stats.packets - base->packets,
+    stats.merged - base->merged
+  );
+}
+#endif
+
+/* Delays the link cannot honour would only measure the timer */
+static bool netem_too_fine( const struct vnetif_impairment *impairment )
+{
+  u32_t resolution = vnetif_resolution_us();
+
+  return ( impairment->delay_us != 0 && impairment->delay_us < resolution ) ||
+    ( impairment->jitter_us != 0 && impairment->jitter_us < resolution );
+}
+
+int netem_suite_run( struct vnetif *a, struct vnetif *b, const char *filter )
+{
+  size_t i;
+  int run = 0;
+
+  netem_a = a;
+  netem_b = b;
+  for ( i = 0; i < sizeof( netem_buffer ); i++ ) {
+    netem_buffer[ i ] = (u8_t) i;
+  }
+
+  for ( i = 0; i < sizeof( netem_scenarios ) / sizeof( netem_scenarios[ 0 ] );
+        i++ ) {
+    const struct netem_scenario *scenario = &netem_scenarios[ i ];
+    struct vnetif_stats base_a;
+    struct vnetif_stats base_b;
+#if LWIP_GRO
+    struct netif_gro_stats base_gro;
+#endif
+
+    if ( filter != NULL && strcmp( filter, scenario->name ) != 0 ) {
+      continue;
+    }
+    if ( netem_too_fine( &scenario->impairment ) ) {
+      printf(
+        "{\"suite\":\"netem01\",\"scenario\":\"%s\",\"skipped\":"
+        "\"delays below the %" PRIu32 "us timer resolution\"}\n",
+        scenario->name,
+        vnetif_resolution_us()
+      );
+      continue;
+    }
+
+    netem_scenario = scenario->name;
+    vnetif_set_impairment( a, &scenario->impairment );
+    vnetif_set_impairment( b, &scenario->impairment );
+    vnetif_get_stats( a, &base_a );
+    vnetif_get_stats( b, &base_b );
+#if LWIP_GRO
+    netif_gro_get_stats( &base_gro );
+#endif
+
+    netem_tcp_bulk();
+    netem_tcp_rr();
+    netem_udp_burst();
+    netem_tcp_churn();
+
+    netem_report_vnetif( "a", a, &base_a );
+    netem_report_vnetif( "b", b, &base_b );
+#if LWIP_GRO
+    netem_report_gro( &base_gro );
+#endif
+    run++;
+  }
+
+  return run;
+}
@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Scripted workloads run across a vnetif pair under a set of emulated link
+ * conditions. Results are printed as one JSON object per line so that runs on
+ * the host and on a target can be collected and compared by the same tools.
+ */
+
+#ifndef _NETEM_SUITE_H
+#define _NETEM_SUITE_H
+
+#include <vnetif.h>
+
+#ifndef NETEM_DURATION_MS
+#define NETEM_DURATION_MS 2000
+#endif
+
+#ifndef NETEM_STACK_SIZE
+#define NETEM_STACK_SIZE ( 16 * 1024 )
+#endif
+
+/*
+ * Runs every workload under every scenario whose name matches filter, or all
+ * scenarios when filter is NULL. Scenarios with delays finer than
+ * vnetif_resolution_us() are reported as skipped. Returns the number of
+ * scenarios run.
+ */
+int netem_suite_run( struct vnetif *a, struct vnetif *b, const char *filter );
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Receive rate on real hardware. A host sends a stream of UDP datagrams to
+ * RXBENCH01_PORT, for example with "iperf -c <target> -u -p 5002 -l 64 -b 1G",
+ * and the frames accepted by the driver and the datagrams delivered to the
+ * socket are counted over RXBENCH01_DURATION_S seconds after the first one
+ * arrives. Each result is printed as a "BENCH" line tagged with the pbuf pool
+ * layout, the source of the receive buffers and the DMA memory mode so builds
+ * with and without PBUF_POOL_CACHE_LINE_SIZE, LWIP_RX_POOL and each
+ * ZYNQMP_DMA_MEMORY setting can be compared.
+ */
+
+#include <lwip/dhcp.h>
+#include <lwip/sockets.h>
+#include <lwip/stats.h>
+#include <arch/sys_arch.h>
+
+#include <inttypes.h>
+#include <string.h>
+
+#include <tmacros.h>
+
+#include <netstart.h>
+
+#ifndef LWIP_BUILD_PROFILE
+#define LWIP_BUILD_PROFILE "unknown"
+#endif
+
+#if PBUF_POOL_CACHE_LINE_SIZE
+#define BENCH_PBUF_LAYOUT "cacheline"
+#else
+#define BENCH_PBUF_LAYOUT "packed"
+#endif
+
+#if LWIP_RX_POOL
+#define BENCH_RX_BUFFERS "rxpool"
+#else
+#define BENCH_RX_BUFFERS "pbufpool"
+#endif
+
+#if !defined(ZYNQMP_DMA_MEMORY) || ZYNQMP_DMA_MEMORY == ZYNQMP_DMA_MEMORY_CACHED
+#define BENCH_DMA_MEMORY "cached"
+#else
+#define BENCH_DMA_MEMORY "noncached"
+#endif
+
+#if defined(ZYNQMP_RX_POLL_BUDGET) && ZYNQMP_RX_POLL_BUDGET
+#define BENCH_RX_MODE "poll"
+#else
+#define BENCH_RX_MODE "irq"
+#endif
+
+#define BENCH_RX_TAG \
+  BENCH_PBUF_LAYOUT "_" BENCH_RX_BUFFERS "_" BENCH_DMA_MEMORY "_" BENCH_RX_MODE
+
+#ifndef RXBENCH01_DURATION_S
+#define RXBENCH01_DURATION_S 10
+#endif
+
+#ifndef RXBENCH01_RUNS
+#define RXBENCH01_RUNS 3
+#endif
+
+#define RXBENCH01_PORT 5002
+
+const char rtems_test_name[] = "RXBENCH 1";
+
+struct netif net_interface;
+
+static uint8_t rx_buffer[ 2048 ];
+
+static void report( const char *test, uint64_t ns, double value, const char *unit )
+{
+  printf(
+    "BENCH profile=%s test=%s ns=%" PRIu64 " value=%.2f unit=%s\n",
+    LWIP_BUILD_PROFILE,
+    test,
+    ns,
+    value,
+    unit
+  );
+}
+
+static uint32_t link_recv( void )
+{
+#if LINK_STATS
+  return lwip_stats.link.recv;
+#else
+  return 0;
+#endif
+}
+
+static uint32_t link_drop( void )
+{
+#if LINK_STATS
+  return lwip_stats.link.drop;
+#else
+  return 0;
+#endif
+}
+
+static void bench_rx( int fd )
+{
+  struct timeval tv = { .tv_sec = 0, .tv_usec = 100000 };
+  uint64_t start;
+  uint64_t ns;
+  uint32_t datagrams = 0;
+  uint32_t frames;
+  uint32_t drops;
+  int rv;
+
+  rv = setsockopt( fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof( tv ) );
+  rtems_test_assert( rv == 0 );
+
+  /* Wait for the stream to start */
+  while ( recv( fd, rx_buffer, sizeof( rx_buffer ), 0 ) < 0 ) {
+  }
+
+  frames = link_recv();
+  drops = link_drop();
+  start = rtems_clock_get_uptime_nanoseconds();
+  do {
+    if ( recv( fd, rx_buffer, sizeof( rx_buffer ), 0 ) >= 0 ) {
+      datagrams++;
+    }
+    ns = rtems_clock_get_uptime_nanoseconds() - start;
+  } while ( ns < RXBENCH01_DURATION_S * 1000000000ULL );
+  frames = link_recv() - frames;
+  drops = link_drop() - drops;
+
+  report( "rx_frames_" BENCH_RX_TAG, ns,
+    (double) frames * 1000000000.0 / ns, "pps" );
+  report( "rx_udp_" BENCH_RX_TAG, ns,
+    (double) datagrams * 1000000000.0 / ns, "pps" );
+  report( "rx_drops_" BENCH_RX_TAG, ns,
+    (double) drops * 1000000000.0 / ns, "pps" );
+
+  /* Let the sender finish before the next run */
+  while ( recv( fd, rx_buffer, sizeof( rx_buffer ), 0 ) >= 0 ) {
+  }
+}
+
+static rtems_task Init( rtems_task_argument argument )
+{
+  struct sockaddr_in addr;
+  int fd;
+  int ret;
+  int i;
+
+  TEST_BEGIN();
+
+  ip_addr_t ipaddr, netmask, gw;
+
+  IP_ADDR4( &ipaddr, 10, 0, 2, 14 );
+  IP_ADDR4( &netmask, 255, 255, 255, 0 );
+  IP_ADDR4( &gw, 10, 0, 2, 3 );
+  unsigned char mac_ethernet_address[] = { 0x00, 0x0a, 0x35, 0x00, 0x22, 0x01 };
+
+  ret = start_networking(
+    &net_interface,
+    &ipaddr,
+    &netmask,
+    &gw,
+    mac_ethernet_address
+  );
+
+  if ( ret != 0 ) {
+    return;
+  }
+
+  dhcp_start( &net_interface );
+
+  memset( &addr, 0, sizeof( addr ) );
+  addr.sin_len = sizeof( addr );
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons( RXBENCH01_PORT );
+  addr.sin_addr.s_addr = htonl( INADDR_ANY );
+
+  fd = socket( AF_INET, SOCK_DGRAM, 0 );
+  rtems_test_assert( fd >= 0 );
+  ret = bind( fd, (struct sockaddr *) &addr, sizeof( addr ) );
+  rtems_test_assert( ret == 0 );
+
+  for ( i = 0; i < RXBENCH01_RUNS; i++ ) {
+    bench_rx( fd );
+  }
+
+  close( fd );
+
+  TEST_END();
+  rtems_test_exit( 0 );
+}
+
+#define CONFIGURE_INIT
+
+#define CONFIGURE_MICROSECONDS_PER_TICK 1000
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_FILE_DESCRIPTORS 32
+
+#define CONFIGURE_MAXIMUM_TASKS 12
+
+#define CONFIGURE_MAXIMUM_POSIX_KEYS 1
+#define CONFIGURE_MAXIMUM_SEMAPHORES 20
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 10
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#include <rtems/confdefs.h>
@@ -0,0 +1,466 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Measures how the socket layer scales with the number of open connections.
+ * N connected TCP pairs are opened over the loopback interface and a receiver
+ * task waits for data on all server sides with select() or lwip_poll() while
+ * the Init task writes single bytes according to a traffic mix:
+ *
+ *   last:    every event on the connection with the highest descriptor
+ *   uniform: round robin over all connections
+ *   hot:     round robin over the first tenth of the connections
+ *
+ * select() goes through the descriptor translation in rtems_lwip_io.c while
+ * lwip_poll() is called with the lwIP descriptors directly, so the difference
+ * between the two is the cost of the translation. The accept test times
+ * connect() to accept() and a complete connect, accept and close cycle with N
+ * idle connections open.
+ *
+ * Every event is handed from one task to the next without waiting on a timer,
+ * so ns/event is the processor time spent per ready event. The wakeup latency
+ * is the time from the start of send() to the return from select() or poll().
+ */
+
+#include <lwip/sockets.h>
+#include <lwip/tcpip.h>
+#include <arch/sys_arch.h>
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <tmacros.h>
+
+#include <netstart.h>
+
+#ifndef LWIP_BUILD_PROFILE
+#define LWIP_BUILD_PROFILE "unknown"
+#endif
+
+#ifndef SOCKSCALE01_MAX_CONNECTIONS
+#define SOCKSCALE01_MAX_CONNECTIONS 64
+#endif
+
+#ifndef SOCKSCALE01_EVENTS
+#define SOCKSCALE01_EVENTS 2000
+#endif
+
+#ifndef SOCKSCALE01_ACCEPTS
+#define SOCKSCALE01_ACCEPTS 200
+#endif
+
+/* The listener and the pair of the accept test need descriptors as well */
+#define SOCKSCALE_NETCONN_LIMIT ( ( MEMP_NUM_NETCONN - 3 ) / 2 )
+#define SOCKSCALE_FD_LIMIT ( ( FD_SETSIZE - 8 ) / 2 )
+
+#define SOCKSCALE_MIN( a, b ) ( ( a ) < ( b ) ? ( a ) : ( b ) )
+#define SOCKSCALE_MAX_CONNECTIONS \
+  SOCKSCALE_MIN( SOCKSCALE01_MAX_CONNECTIONS, \
+    SOCKSCALE_MIN( SOCKSCALE_NETCONN_LIMIT, SOCKSCALE_FD_LIMIT ) )
+
+#define SOCKSCALE_PORT 5002
+#define SOCKSCALE_QUIT 'q'
+
+/* Not in a public header, converts a descriptor to the lwIP socket index */
+int rtems_lwip_sysfd_to_lwipfd( int fd );
+
+const char rtems_test_name[] = "SOCKSCALE 1";
+
+typedef enum {
+  MODE_SELECT,
+  MODE_POLL
+} wait_mode;
+
+struct traffic_mix {
+  const char *name;
+  int ( *pick )( int n, uint32_t event );
+};
+
+static int listener;
+static int clients[ SOCKSCALE_MAX_CONNECTIONS ];
+static int servers[ SOCKSCALE_MAX_CONNECTIONS ];
+static int server_lwipfds[ SOCKSCALE_MAX_CONNECTIONS ];
+static int connections;
+
+static wait_mode receiver_mode;
+static sys_sem_t receiver_start;
+static sys_sem_t event_done;
+static volatile uint64_t send_stamp;
+static uint32_t wakeups[ SOCKSCALE01_EVENTS ];
+static uint32_t wakeup_count;
+
+static uint64_t now_ns( void )
+{
+  return rtems_clock_get_uptime_nanoseconds();
+}
+
+static int pick_last( int n, uint32_t event )
+{
+  (void) event;
+  return n - 1;
+}
+
+static int pick_uniform( int n, uint32_t event )
+{
+  return (int) ( event % (uint32_t) n );
+}
+
+static int pick_hot( int n, uint32_t event )
+{
+  int hot = n / 10;
+
+  return (int) ( event % (uint32_t) ( hot > 0 ? hot : 1 ) );
+}
+
+static const struct traffic_mix mixes[] = {
+  { "last", pick_last },
+  { "uniform", pick_uniform },
+  { "hot", pick_hot }
+};
+
+static void fill_loopback( struct sockaddr_in *addr, uint16_t port )
+{
+  memset( addr, 0, sizeof( *addr ) );
+  addr->sin_len = sizeof( *addr );
+  addr->sin_family = AF_INET;
+  addr->sin_port = htons( port );
+  addr->sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+}
+
+static void open_connection( int *client, int *server )
+{
+  struct sockaddr_in addr;
+  int one = 1;
+  int rv;
+
+  fill_loopback( &addr, SOCKSCALE_PORT );
+  *client = socket( AF_INET, SOCK_STREAM, 0 );
+  rtems_test_assert( *client >= 0 );
+  rv = connect( *client, (struct sockaddr *) &addr, sizeof( addr ) );
+  rtems_test_assert( rv == 0 );
+  *server = accept( listener, NULL, NULL );
+  rtems_test_assert( *server >= 0 );
+  setsockopt( *client, IPPROTO_TCP, TCP_NODELAY, &one, sizeof( one ) );
+}
+
+static void grow_connections( int n )
+{
+  while ( connections < n ) {
+    open_connection( &clients[ connections ], &servers[ connections ] );
+    server_lwipfds[ connections ] =
+      rtems_lwip_sysfd_to_lwipfd( servers[ connections ] );
+    rtems_test_assert( server_lwipfds[ connections ] >= 0 );
+    connections++;
+  }
+}
+
+/* Returns false when told to quit */
+static bool consume( int fd, uint64_t woken )
+{
+  char c;
+
+  rtems_test_assert( recv( fd, &c, 1, 0 ) == 1 );
+  if ( c == SOCKSCALE_QUIT ) {
+    return false;
+  }
+  if ( wakeup_count < SOCKSCALE01_EVENTS ) {
+    wakeups[ wakeup_count++ ] = (uint32_t) ( woken - send_stamp );
+  }
+  sys_sem_signal( &event_done );
+  return true;
+}
+
+static bool wait_select( void )
+{
+  fd_set set;
+  uint64_t woken;
+  int maxfd = -1;
+  int rv;
+  int i;
+
+  /* Rebuilt on every call as applications do */
+  FD_ZERO( &set );
+  for ( i = 0; i < connections; i++ ) {
+    FD_SET( servers[ i ], &set );
+    if ( servers[ i ] > maxfd ) {
+      maxfd = servers[ i ];
+    }
+  }
+
+  rv = select( maxfd + 1, &set, NULL, NULL, NULL );
+  woken = now_ns();
+  rtems_test_assert( rv > 0 );
+
+  for ( i = 0; i < connections; i++ ) {
+    if ( FD_ISSET( servers[ i ], &set ) && !consume( servers[ i ], woken ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool wait_poll( void )
+{
+  static struct pollfd fds[ SOCKSCALE_MAX_CONNECTIONS ];
+  uint64_t woken;
+  int rv;
+  int i;
+
+  for ( i = 0; i < connections; i++ ) {
+    fds[ i ].fd = server_lwipfds[ i ];
+    fds[ i ].events = POLLIN;
+    fds[ i ].revents = 0;
+  }
+
+  rv = lwip_poll( fds, (nfds_t) connections, -1 );
+  woken = now_ns();
+  rtems_test_assert( rv > 0 );
+
+  for ( i = 0; i < connections; i++ ) {
+    if ( ( fds[ i ].revents & POLLIN ) != 0 &&
+         !consume( servers[ i ], woken ) ) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static void receiver( void *arg )
+{
+  (void) arg;
+
+  while ( true ) {
+    sys_arch_sem_wait( &receiver_start, 0 );
+    if ( receiver_mode == MODE_SELECT ) {
+      while ( wait_select() ) {
+      }
+    } else {
+      while ( wait_poll() ) {
+      }
+    }
+    sys_sem_signal( &event_done );
+  }
+}
+
+static int compare_u32( const void *a, const void *b )
+{
+  uint32_t x = *(const uint32_t *) a;
+  uint32_t y = *(const uint32_t *) b;
+
+  return ( x > y ) - ( x < y );
+}
+
+static uint32_t percentile( uint32_t *samples, uint32_t count, uint32_t pct )
+{
+  if ( count == 0 ) {
+    return 0;
+  }
+  return samples[ ( count - 1 ) * pct / 100 ];
+}
+
+static void report(
+  const char *test,
+  const char *mix,
+  int         n,
+  uint64_t    ns,
+  uint32_t    events,
+  uint32_t   *samples,
+  uint32_t    count
+)
+{
+  qsort( samples, count, sizeof( samples[ 0 ] ), compare_u32 );
+  printf(
+    "BENCH profile=%s test=%s mix=%s n=%d ns=%" PRIu64
+    " value=%.0f unit=ns/event p50_ns=%" PRIu32 " p99_ns=%" PRIu32
+    " max_ns=%" PRIu32 "\n",
+    LWIP_BUILD_PROFILE,
+    test,
+    mix,
+    n,
+    ns,
+    events != 0 ? (double) ns / events : 0.0,
+    percentile( samples, count, 50 ),
+    percentile( samples, count, 99 ),
+    count != 0 ? samples[ count - 1 ] : 0
+  );
+}
+
+static void bench_wait( wait_mode mode, const struct traffic_mix *mix, int n )
+{
+  uint64_t start;
+  uint64_t ns;
+  uint32_t e;
+  char c = 'x';
+
+  receiver_mode = mode;
+  wakeup_count = 0;
+  sys_sem_signal( &receiver_start );
+
+  start = now_ns();
+  for ( e = 0; e < SOCKSCALE01_EVENTS; e++ ) {
+    send_stamp = now_ns();
+    rtems_test_assert( send( clients[ mix->pick( n, e ) ], &c, 1, 0 ) == 1 );
+    sys_arch_sem_wait( &event_done, 0 );
+  }
+  ns = now_ns() - start;
+
+  c = SOCKSCALE_QUIT;
+  rtems_test_assert( send( clients[ 0 ], &c, 1, 0 ) == 1 );
+  sys_arch_sem_wait( &event_done, 0 );
+
+  report(
+    mode == MODE_SELECT ? "select" : "poll",
+    mix->name,
+    n,
+    ns,
+    SOCKSCALE01_EVENTS,
+    wakeups,
+    wakeup_count
+  );
+}
+
+static void bench_accept( int n )
+{
+  static uint32_t samples[ SOCKSCALE01_ACCEPTS ];
+  struct sockaddr_in addr;
+  uint64_t start;
+  uint64_t ns;
+  int i;
+
+  fill_loopback( &addr, SOCKSCALE_PORT );
+
+  start = now_ns();
+  for ( i = 0; i < SOCKSCALE01_ACCEPTS; i++ ) {
+    uint64_t connected;
+    int client;
+    int server;
+    int rv;
+
+    client = socket( AF_INET, SOCK_STREAM, 0 );
+    rtems_test_assert( client >= 0 );
+    rv = connect( client, (struct sockaddr *) &addr, sizeof( addr ) );
+    rtems_test_assert( rv == 0 );
+    connected = now_ns();
+    server = accept( listener, NULL, NULL );
+    rtems_test_assert( server >= 0 );
+    samples[ i ] = (uint32_t) ( now_ns() - connected );
+    close( client );
+    close( server );
+  }
+  ns = now_ns() - start;
+
+  report( "accept", "churn", n, ns, SOCKSCALE01_ACCEPTS, samples,
+    SOCKSCALE01_ACCEPTS );
+}
+
+static void run_benchmarks( void )
+{
+  struct sockaddr_in addr;
+  int max = SOCKSCALE_MAX_CONNECTIONS;
+  int n;
+  int rv;
+  size_t m;
+
+  fill_loopback( &addr, SOCKSCALE_PORT );
+  listener = socket( AF_INET, SOCK_STREAM, 0 );
+  rtems_test_assert( listener >= 0 );
+  rv = bind( listener, (struct sockaddr *) &addr, sizeof( addr ) );
+  rtems_test_assert( rv == 0 );
+  rv = listen( listener, 4 );
+  rtems_test_assert( rv == 0 );
+
+  rv = sys_sem_new( &receiver_start, 0 );
+  rtems_test_assert( rv == ERR_OK );
+  rv = sys_sem_new( &event_done, 0 );
+  rtems_test_assert( rv == ERR_OK );
+  sys_thread_new(
+    "receiver",
+    receiver,
+    NULL,
+    RTEMS_MINIMUM_STACK_SIZE * 4,
+    DEFAULT_THREAD_PRIO
+  );
+
+  printf( "sockscale01: up to %d connections\n", max );
+
+  n = 1;
+  while ( true ) {
+    grow_connections( n );
+
+    for ( m = 0; m < RTEMS_ARRAY_SIZE( mixes ); m++ ) {
+      bench_wait( MODE_SELECT, &mixes[ m ], n );
+      bench_wait( MODE_POLL, &mixes[ m ], n );
+    }
+    bench_accept( n );
+
+    if ( n == max ) {
+      break;
+    }
+    n = n * 2 < max ? n * 2 : max;
+  }
+}
+
+static rtems_task Init( rtems_task_argument argument )
+{
+  rtems_status_code sc;
+
+  TEST_BEGIN();
+
+  sc = start_networking_shared();
+  rtems_test_assert( sc == RTEMS_SUCCESSFUL );
+
+  run_benchmarks();
+
+  TEST_END();
+  rtems_test_exit( 0 );
+}
+
+#define CONFIGURE_INIT
+
+#define CONFIGURE_MICROSECONDS_PER_TICK 1000
+
+#define CONFIGURE_APPLICATION_NEEDS_CLOCK_DRIVER
+#define CONFIGURE_APPLICATION_NEEDS_CONSOLE_DRIVER
+
+#define CONFIGURE_MAXIMUM_FILE_DESCRIPTORS FD_SETSIZE
+
+#define CONFIGURE_MAXIMUM_TASKS 12
+
+#define CONFIGURE_MAXIMUM_POSIX_KEYS 1
+#define CONFIGURE_MAXIMUM_SEMAPHORES 20
+#define CONFIGURE_MAXIMUM_MESSAGE_QUEUES 10
+
+#define CONFIGURE_INITIAL_EXTENSIONS RTEMS_TEST_INITIAL_EXTENSION
+
+#define CONFIGURE_RTEMS_INIT_TASKS_TABLE
+
+#define CONFIGURE_INIT_TASK_ATTRIBUTES RTEMS_FLOATING_POINT
+
+#define CONFIGURE_UNLIMITED_OBJECTS
+#define CONFIGURE_UNIFIED_WORK_AREAS
+
+#include <rtems/confdefs.h>
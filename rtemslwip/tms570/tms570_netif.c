@@ -60,6 +60,7 @@
 #include "ti_drv_mdio.h"
 #include "phy_dp83848h.h"
 #include "tms570_emac.h"
+#include "netif_burst.h"
 
 #define LINK_SPEED_OF_YOUR_NETIF_IN_BPS 10000000
 
@@ -750,6 +751,7 @@ tms570_eth_process_irq_rx(void *arg)
   volatile struct emac_rx_bd *curr_bd;
   struct pbuf *pbuf;
   struct pbuf *q;
+  struct netif_burst burst;
 
   nf_state = netif->state;
   rxch = &(nf_state->rxch);
@@ -760,6 +762,8 @@ tms570_eth_process_irq_rx(void *arg)
     return;
   }
 
+  netif_burst_init(&burst);
+
   /* For each valid frame */
   while ((curr_bd->flags_pktlen & EMAC_DSC_FLAG_SOP) &&
          !(curr_bd->flags_pktlen & EMAC_DSC_FLAG_OWNER)) {
@@ -829,12 +833,11 @@ tms570_eth_process_irq_rx(void *arg)
 
     LINK_STATS_INC(link.recv);
 
-    /* Process the packet */
-    /* ethernet_input((struct pbuf *)pbuf, netif) */
-    if (!corrupt_fl)
-      if (netif->input(pbuf, netif) != ERR_OK)
-        corrupt_fl = 1;
-    if (corrupt_fl) {
+    /* Process the packet, the whole burst goes to the stack at once */
+    if (!corrupt_fl) {
+      if (netif_burst_add(&burst, pbuf) >= LWIP_NETIF_BURST)
+        netif_burst_flush(&burst, netif);
+    } else {
       LINK_STATS_INC(link.memerr);
       LINK_STATS_INC(link.drop);
       pbuf_free(pbuf);
@@ -852,9 +855,11 @@ tms570_eth_process_irq_rx(void *arg)
     //tms570_eth_debug_print_rxch();
     curr_bd = rxch->active_head;
     if (curr_bd == NULL) {
-      return;
+      break;
     }
   }
+
+  netif_burst_flush(&burst, netif);
 }
 
 static void
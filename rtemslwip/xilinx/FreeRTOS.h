@@ -35,4 +35,16 @@ BaseType_t xPortInstallInterruptHandler(
   void             *pvCallBackRef
 );
 
+/*
+ * Installs the handler on the interrupt server of the processor with the given
+ * index modulo the number of processors, or on the default server if that
+ * processor has none.
+ */
+BaseType_t xPortInstallInterruptHandlerOnServer(
+  uint32_t          server_index,
+  uint8_t           ucInterruptID,
+  XInterruptHandler pxHandler,
+  void             *pvCallBackRef
+);
+
 #endif /* FREERTOS_H */
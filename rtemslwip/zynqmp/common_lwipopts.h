@@ -1,3 +1,101 @@
 #include <xparameters_ps.h>
 #include <xlwipopts.h>
 #define MEM_ALIGNMENT 64
+
+#ifndef PBUF_POOL_CACHE_LINE_SIZE
+#define PBUF_POOL_CACHE_LINE_SIZE 64
+#endif
+
+/*
+ * How the GEM DMA path sees buffer memory. CACHED leaves the receive pool in
+ * ordinary memory and maintains the cache for every frame. NONCACHED carves
+ * the receive pool from ZYNQMP_DMA_MEMORY_SIZE bytes mapped normal
+ * non-cacheable, so its buffers need no maintenance. Whether a GEM is cache
+ * coherent is taken from the hardware description, XPAR_PSU_ETHERNET_n_IS_-
+ * CACHE_COHERENT, as the port neither configures nor checks the CCI.
+ */
+#define ZYNQMP_DMA_MEMORY_CACHED 0
+#define ZYNQMP_DMA_MEMORY_NONCACHED 1
+
+#ifndef ZYNQMP_DMA_MEMORY
+#define ZYNQMP_DMA_MEMORY ZYNQMP_DMA_MEMORY_CACHED
+#endif
+
+#if ZYNQMP_DMA_MEMORY != ZYNQMP_DMA_MEMORY_CACHED && \
+  ZYNQMP_DMA_MEMORY != ZYNQMP_DMA_MEMORY_NONCACHED
+#error "ZYNQMP_DMA_MEMORY must be 0 (cached) or 1 (noncached)"
+#endif
+
+#ifndef ZYNQMP_DMA_MEMORY_SIZE
+#define ZYNQMP_DMA_MEMORY_SIZE 0x200000 /* A multiple of 2MB */
+#endif
+
+/*
+ * Number of receive descriptors the input thread takes off the ring per poll
+ * with the receive interrupt masked. 0 handles the ring in the interrupt.
+ * Frames are only taken off the ring whole, so with ZYNQMP_USE_JUMBO a poll
+ * takes at least the descriptors of one jumbo frame,
+ * MAX_FRAME_SIZE_JUMBO / XEMACPSIF_RX_BUF_SIZE rounded up, whatever the budget.
+ */
+#ifndef ZYNQMP_RX_POLL_BUDGET
+#define ZYNQMP_RX_POLL_BUDGET 0
+#endif
+
+/*
+ * Let the GEM check the IP, TCP and UDP checksums of received frames and
+ * insert them into sent frames. The stack still checks the frames the GEM
+ * could not verify and computes what the GEM cannot insert.
+ */
+#ifndef ZYNQMP_CHECKSUM_OFFLOAD
+#define ZYNQMP_CHECKSUM_OFFLOAD 1
+#endif
+
+#if ZYNQMP_CHECKSUM_OFFLOAD && !defined(LWIP_CHECKSUM_CTRL_PER_NETIF)
+#define LWIP_CHECKSUM_CTRL_PER_NETIF 1
+#endif
+
+/*
+ * Give the GEM a second receive ring for the flows that screener rules steer
+ * to queue 1, with ZYNQMP_RXQ1_N_DESC descriptors and an input thread of its
+ * own running at ZYNQMP_RXQ1_THREAD_PRIO. ZYNQMP_RX_THREAD_PRIO is the
+ * priority of the input thread serving queue 0. DEFAULT_THREAD_PRIO, 1 unless
+ * configured otherwise, is the highest RTEMS priority, so with the second ring
+ * queue 0 steps one down by default to let queue 1 preempt it.
+ */
+#ifndef ZYNQMP_RX_PRIORITY_QUEUE
+#define ZYNQMP_RX_PRIORITY_QUEUE 0
+#endif
+
+#ifndef ZYNQMP_RXQ1_N_DESC
+#define ZYNQMP_RXQ1_N_DESC 32
+#endif
+
+#ifndef ZYNQMP_RX_THREAD_PRIO
+#if ZYNQMP_RX_PRIORITY_QUEUE
+#define ZYNQMP_RX_THREAD_PRIO (DEFAULT_THREAD_PRIO + 1)
+#else
+#define ZYNQMP_RX_THREAD_PRIO DEFAULT_THREAD_PRIO
+#endif
+#endif
+
+#ifndef ZYNQMP_RXQ1_THREAD_PRIO
+#define ZYNQMP_RXQ1_THREAD_PRIO DEFAULT_THREAD_PRIO
+#endif
+
+/*
+ * Frames the GEM driver holds per interface while the transmit ring is full.
+ * Senders get ERR_WOULDBLOCK once the queue is full as well and refused TCP
+ * segments are sent again when it has drained to half. 0 refuses frames as
+ * soon as the ring is full.
+ */
+#ifndef ZYNQMP_TX_QUEUE_LEN
+#define ZYNQMP_TX_QUEUE_LEN 64
+#endif
+
+/*
+ * Frequency of the clock driving the time stamp unit of the GEMs, from which
+ * the nanosecond increment per cycle is derived with LWIP_HWTSTAMP.
+ */
+#ifndef ZYNQMP_TSU_CLOCK_HZ
+#define ZYNQMP_TSU_CLOCK_HZ 250000000
+#endif
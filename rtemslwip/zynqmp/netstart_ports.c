@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 agent <agent@local>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+ * LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+ * CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+ * SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+ * INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+ * CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Brings up several GEMs of the ZynqMP as interfaces of their own. It is
+ * shared by all ZynqMP BSPs, whose netstart.c each bring up one GEM.
+ */
+
+#include <netstart.h>
+#include "netif/xadapter.h"
+#include "xparameters.h"
+#include <lwip/tcpip.h>
+
+static const UINTPTR netstart_gem_baseaddr[] = {
+  XPAR_PSU_ETHERNET_0_BASEADDR,
+  XPAR_PSU_ETHERNET_1_BASEADDR,
+  XPAR_PSU_ETHERNET_2_BASEADDR,
+  XPAR_PSU_ETHERNET_3_BASEADDR
+};
+
+int start_networking_ports(
+  struct netstart_port *ports,
+  size_t                count
+)
+{
+  size_t i;
+  size_t j;
+
+  if ( count == 0 ) {
+    return 1;
+  }
+
+  /* Each GEM can only be brought up once */
+  for ( i = 0; i < count; i++ ) {
+    if ( ports[ i ].port >= LWIP_ARRAYSIZE( netstart_gem_baseaddr ) ) {
+      return 1;
+    }
+    for ( j = 0; j < i; j++ ) {
+      if ( ports[ j ].port == ports[ i ].port ) {
+        return 1;
+      }
+    }
+  }
+
+  start_networking_shared();
+
+  for ( i = 0; i < count; i++ ) {
+    struct netstart_port *port = &ports[ i ];
+
+    if ( !xemac_add_port(
+      &port->net_interface,
+      &port->ipaddr,
+      &port->netmask,
+      &port->gateway,
+      port->mac_ethernet_address,
+      netstart_gem_baseaddr[ port->port ]
+         ) ) {
+      return 1;
+    }
+  }
+
+  netif_set_default( &ports[ 0 ].net_interface );
+
+  return 0;
+}
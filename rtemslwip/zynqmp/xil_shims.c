@@ -27,6 +27,7 @@
 #include "xil_mmu.h"
 #include <rtems/rtems/cache.h>
 #include <rtems/rtems/intr.h>
+#include <rtems/rtems/tasks.h>
 #include <rtems/score/threadimpl.h>
 #include <libcpu/mmu-vmsav8-64.h>
 #include <stdio.h>
@@ -68,8 +69,24 @@ BaseType_t xPortInstallInterruptHandler(
   XInterruptHandler pxHandler,
   void             *pvCallBackRef
 )
+{
+  return xPortInstallInterruptHandlerOnServer(
+    RTEMS_INTERRUPT_SERVER_DEFAULT,
+    ucInterruptID,
+    pxHandler,
+    pvCallBackRef
+  );
+}
+
+BaseType_t xPortInstallInterruptHandlerOnServer(
+  uint32_t          server_index,
+  uint8_t           ucInterruptID,
+  XInterruptHandler pxHandler,
+  void             *pvCallBackRef
+)
 {
   char name[10];
+  rtems_status_code sc;
 
   /* Is this running in the context of any interrupt server tasks? */
   _Thread_Get_name( _Thread_Get_executing(), name, sizeof( name ) );
@@ -78,14 +95,30 @@ BaseType_t xPortInstallInterruptHandler(
     return RTEMS_ILLEGAL_ON_SELF;
   }
 
-  rtems_status_code sc = rtems_interrupt_server_handler_install(
-    RTEMS_INTERRUPT_SERVER_DEFAULT,
+  if ( server_index != RTEMS_INTERRUPT_SERVER_DEFAULT ) {
+    /* start_networking_shared() creates one server per processor */
+    server_index %= rtems_scheduler_get_processor_maximum();
+  }
+
+  sc = rtems_interrupt_server_handler_install(
+    server_index,
     ucInterruptID,
     "CGEM Handler",
     RTEMS_INTERRUPT_UNIQUE,
     pxHandler,
     pvCallBackRef
   );
+  if ( sc != RTEMS_SUCCESSFUL && server_index != RTEMS_INTERRUPT_SERVER_DEFAULT ) {
+    /* No server runs on a processor left out of the schedulers */
+    sc = rtems_interrupt_server_handler_install(
+      RTEMS_INTERRUPT_SERVER_DEFAULT,
+      ucInterruptID,
+      "CGEM Handler",
+      RTEMS_INTERRUPT_UNIQUE,
+      pxHandler,
+      pvCallBackRef
+    );
+  }
 
   return sc;
 }
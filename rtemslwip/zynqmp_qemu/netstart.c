@@ -39,7 +39,7 @@ int start_networking(
 {
   start_networking_shared();
 
-  if ( !xemac_add(
+  if ( !xemac_add_port(
     net_interface,
     ipaddr,
     netmask,
@@ -52,15 +52,5 @@ int start_networking(
 
   netif_set_default( net_interface );
 
-  netif_set_up( net_interface );
-
-  sys_thread_new(
-    "xemacif_input_thread",
-    ( void ( * )( void * ) )xemacif_input_thread,
-    net_interface,
-    1024,
-    DEFAULT_THREAD_PRIO
-  );
-
   return 0;
 }